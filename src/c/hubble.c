@@ -1,11 +1,20 @@
 #include <pebble.h>
 #include "windows/home.h"
 #include "utils/settings.h"
+#include "utils/favorites_store.h"
+#include "utils/bodymsg.h"
+#include "utils/compass_worker.h"
+#include "utils/heap_stats.h"
 #include "utils/logging.h"
 
 static void prv_init(void) {
+  heap_stats_init();
   settings_load();
-  HUBBLE_LOG(APP_LOG_LEVEL_INFO, "Settings: %d", settings.favorites);
+  favorites_store_load();
+
+  // Open AppMessage at launch so the phone's per-session declination push can land
+  bodymsg_init();
+  compass_worker_init();
   home_init();
   home_show();
 }
@@ -13,6 +22,11 @@ static void prv_init(void) {
 static void prv_deinit(void) {
   home_hide();
   home_deinit();
+  compass_worker_deinit();
+  // Pending settings changes are written once, on the way out
+  settings_deinit();
+  bodymsg_deinit();
+  heap_stats_deinit();
 }
 
 int main(void) {
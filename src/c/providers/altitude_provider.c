@@ -1,19 +1,38 @@
 #include "altitude_provider.h"
+#include "sensor_trace.h"
+
+// Sample faster than we emit; the filter runs over each whole batch
+#define ALTITUDE_SAMPLING_RATE ACCEL_SAMPLING_25HZ
+#define ALTITUDE_SAMPLING_HZ 25
+#define ALTITUDE_MAX_BATCH 25
+
+// Filter state is Q8 fixed point; each sample moves the state 1/(2^SHIFT) of the way.
+// Overridable so tools/trace_replay can compare filter variants.
+#define ALTITUDE_FILTER_FRAC_BITS 8
+#ifndef ALTITUDE_FILTER_SHIFT
+#define ALTITUDE_FILTER_SHIFT 2
+#endif
+
 static int16_t s_altitude_deg = 0;
 static AltitudeUpdateHandler s_handler = NULL;
+static uint16_t s_interval_ms = ALTITUDE_PROVIDER_DEFAULT_INTERVAL_MS;
+static bool s_subscribed = false;
+
+// Low-pass filtered gravity components (milli-G, Q8)
+static int32_t s_filtered_x = 0;
+static int32_t s_filtered_y = 0;
+static int32_t s_filtered_z = 0;
+static bool s_filter_primed = false;
 
 static int32_t prv_trig_to_signed_deg(int32_t trig_angle) {
   int32_t deg = TRIGANGLE_TO_DEG(trig_angle);
   return (deg > 180) ? deg - 360 : deg;
 }
 
-static int16_t prv_calc_altitude_deg(const AccelRawData *sample) {
+static int16_t prv_calc_altitude_deg(int32_t y, int32_t z) {
   // Ignore X; assume watch is held parallel to line of sight.
   // Altitude is measured from looking straight ahead (0°) up to +90° (up) and
-  // down to -90° (down) using Z (up) and Y (forward/back).
-  const int32_t y = sample->y;  // milli-G, forward is negative
-  const int32_t z = sample->z;  // milli-G, up is positive
-
+  // down to -90° (down) using Z (up, positive) and Y (forward is negative), in milli-G.
   const int32_t trig_angle = atan2_lookup(z, -y);  // (-y) makes forward = 0°
   int32_t deg = prv_trig_to_signed_deg(trig_angle);
 
@@ -26,13 +45,55 @@ static int16_t prv_calc_altitude_deg(const AccelRawData *sample) {
   return (int16_t)deg;
 }
 
+static uint32_t prv_batch_size(void) {
+  uint32_t samples = ((uint32_t)s_interval_ms * ALTITUDE_SAMPLING_HZ) / 1000;
+  if (samples < 1) {
+    samples = 1;
+  } else if (samples > ALTITUDE_MAX_BATCH) {
+    samples = ALTITUDE_MAX_BATCH;
+  }
+  return samples;
+}
+
+static void prv_filter_sample(const AccelRawData *sample) {
+  const int32_t x = (int32_t)sample->x << ALTITUDE_FILTER_FRAC_BITS;
+  const int32_t y = (int32_t)sample->y << ALTITUDE_FILTER_FRAC_BITS;
+  const int32_t z = (int32_t)sample->z << ALTITUDE_FILTER_FRAC_BITS;
+
+  if (!s_filter_primed) {
+    // Start from the first reading instead of ramping up from zero
+    s_filtered_x = x;
+    s_filtered_y = y;
+    s_filtered_z = z;
+    s_filter_primed = true;
+    return;
+  }
+
+  s_filtered_x += (x - s_filtered_x) >> ALTITUDE_FILTER_SHIFT;
+  s_filtered_y += (y - s_filtered_y) >> ALTITUDE_FILTER_SHIFT;
+  s_filtered_z += (z - s_filtered_z) >> ALTITUDE_FILTER_SHIFT;
+}
+
 static void prv_accel_handler(AccelRawData *data, uint32_t num_samples,
                               uint64_t timestamp) {
+  // Only read when sensor tracing is compiled in
+  (void)timestamp;
   if (num_samples == 0) {
     return;
   }
 
-  const int16_t altitude = prv_calc_altitude_deg(&data[0]);
+  sensor_trace_accel(data, num_samples, timestamp, 1000 / ALTITUDE_SAMPLING_HZ);
+
+  for (uint32_t i = 0; i < num_samples; i++) {
+    prv_filter_sample(&data[i]);
+  }
+
+  const int16_t altitude = prv_calc_altitude_deg(s_filtered_y >> ALTITUDE_FILTER_FRAC_BITS,
+                                                 s_filtered_z >> ALTITUDE_FILTER_FRAC_BITS);
+  if (altitude == s_altitude_deg) {
+    // Nothing visible changed; skip the UI update
+    return;
+  }
   s_altitude_deg = altitude;
 
   if (s_handler) {
@@ -41,13 +102,17 @@ static void prv_accel_handler(AccelRawData *data, uint32_t num_samples,
 }
 
 void altitude_provider_init(void) {
-  accel_raw_data_service_subscribe(1, prv_accel_handler);
-  accel_service_set_sampling_rate(ACCEL_SAMPLING_10HZ);
   s_altitude_deg = 0;
+  s_filter_primed = false;
+  accel_raw_data_service_subscribe(prv_batch_size(), prv_accel_handler);
+  accel_service_set_sampling_rate(ALTITUDE_SAMPLING_RATE);
+  s_subscribed = true;
 }
 
 void altitude_provider_deinit(void) {
+  // The SDK has a single unsubscribe for both raw and processed accel subscriptions
   accel_data_service_unsubscribe();
+  s_subscribed = false;
   s_handler = NULL;
 }
 
@@ -62,3 +127,19 @@ int16_t altitude_provider_get_altitude_deg(void) {
   return s_altitude_deg;
 }
 
+bool altitude_provider_get_gravity(int32_t *x, int32_t *y, int32_t *z) {
+  if (!s_subscribed || !s_filter_primed) {
+    return false;
+  }
+  *x = s_filtered_x >> ALTITUDE_FILTER_FRAC_BITS;
+  *y = s_filtered_y >> ALTITUDE_FILTER_FRAC_BITS;
+  *z = s_filtered_z >> ALTITUDE_FILTER_FRAC_BITS;
+  return true;
+}
+
+void altitude_provider_set_update_interval_ms(uint16_t interval_ms) {
+  s_interval_ms = interval_ms;
+  if (s_subscribed) {
+    accel_service_set_samples_per_update(prv_batch_size());
+  }
+}
@@ -2,11 +2,21 @@
 
 #include <pebble.h>
 
+// Default interval between smoothed altitude updates
+#define ALTITUDE_PROVIDER_DEFAULT_INTERVAL_MS 200
+
 typedef void (*AltitudeUpdateHandler)(int16_t altitude_deg);
 
+// Started and stopped by the sensor hub; windows subscribe through sensor_hub.h
 void altitude_provider_init(void);
 void altitude_provider_deinit(void);
 
 void altitude_provider_set_handler(AltitudeUpdateHandler handler);
 int16_t altitude_provider_get_altitude_deg(void);
 
+// Filtered gravity vector in milli-G, body frame. False until the provider has samples.
+bool altitude_provider_get_gravity(int32_t *x, int32_t *y, int32_t *z);
+
+// Sets how often a smoothed altitude is emitted (one accel batch per interval).
+// May be called before or after init.
+void altitude_provider_set_update_interval_ms(uint16_t interval_ms);
@@ -1,17 +1,25 @@
 #include "azimuth_provider.h"
+#include "orientation.h"
+#include "sensor_trace.h"
 
 static int16_t s_azimuth_deg = 0;
 static AzimuthUpdateHandler s_handler = NULL;
 static CalibrationUpdateHandler s_calibration_handler = NULL;
 static bool s_is_calibrated = false;
+static bool s_has_status = false;
+static bool s_has_azimuth = false;
 
 static void prv_handle_heading(CompassHeadingData data) {
+  sensor_trace_compass(&data);
+
   bool was_calibrated = s_is_calibrated;
   s_is_calibrated = (data.compass_status != CompassStatusDataInvalid &&
                      data.compass_status != CompassStatusUnavailable);
 
-  // Notify if calibration status changed
-  if (s_calibration_handler && was_calibrated != s_is_calibrated) {
+  // Notify on the first status since init (the app may be showing a seeded state) and on changes
+  const bool first_status = !s_has_status;
+  s_has_status = true;
+  if (s_calibration_handler && (first_status || was_calibrated != s_is_calibrated)) {
     s_calibration_handler(s_is_calibrated);
   }
 
@@ -19,8 +27,15 @@ static void prv_handle_heading(CompassHeadingData data) {
     return;
   }
 
-  // Pebble heading is counter-clockwise from 12 o'clock; convert to CW degrees.
-  const int32_t cw_trig_angle = TRIG_MAX_ANGLE - data.magnetic_heading;
+  int32_t cw_trig_angle;
+  if (!orientation_update(data.magnetic_heading, &cw_trig_angle)) {
+    if (s_has_azimuth) {
+      // Degenerate pose; hold the last good heading rather than jump
+      return;
+    }
+    // No tilt data yet. Pebble heading is counter-clockwise from 12 o'clock; convert to CW.
+    cw_trig_angle = TRIG_MAX_ANGLE - data.magnetic_heading;
+  }
   int32_t deg = TRIGANGLE_TO_DEG(cw_trig_angle);
 
   // Normalize to 0-359.
@@ -31,6 +46,7 @@ static void prv_handle_heading(CompassHeadingData data) {
   }
 
   s_azimuth_deg = (int16_t)deg;
+  s_has_azimuth = true;
 
   if (s_handler) {
     s_handler(s_azimuth_deg);
@@ -38,8 +54,11 @@ static void prv_handle_heading(CompassHeadingData data) {
 }
 
 void azimuth_provider_init(void) {
+  s_has_status = false;
+  s_has_azimuth = false;
+  orientation_reset();
   compass_service_subscribe(prv_handle_heading);
-  // Default 1-degree filter is fine; can be adjusted by callers later if needed.
+  // Default 1-degree filter until the governor picks one
 }
 
 void azimuth_provider_deinit(void) {
@@ -50,14 +69,14 @@ void azimuth_provider_deinit(void) {
 
 void azimuth_provider_set_handler(AzimuthUpdateHandler handler) {
   s_handler = handler;
-  if (handler && s_is_calibrated) {
+  if (handler && s_has_azimuth && s_is_calibrated) {
     handler(s_azimuth_deg);
   }
 }
 
 void azimuth_provider_set_calibration_handler(CalibrationUpdateHandler handler) {
   s_calibration_handler = handler;
-  if (handler) {
+  if (handler && s_has_status) {
     handler(s_is_calibrated);
   }
 }
@@ -69,3 +88,7 @@ int16_t azimuth_provider_get_azimuth_deg(void) {
 bool azimuth_provider_is_calibrated(void) {
   return s_is_calibrated;
 }
+
+void azimuth_provider_set_heading_filter_deg(uint8_t filter_deg) {
+  compass_service_set_heading_filter(DEG_TO_TRIGANGLE((int32_t)filter_deg));
+}
@@ -5,6 +5,7 @@
 typedef void (*AzimuthUpdateHandler)(int16_t azimuth_deg);
 typedef void (*CalibrationUpdateHandler)(bool is_calibrated);
 
+// Started and stopped by the sensor hub; windows subscribe through sensor_hub.h
 void azimuth_provider_init(void);
 void azimuth_provider_deinit(void);
 
@@ -13,3 +14,6 @@ void azimuth_provider_set_calibration_handler(CalibrationUpdateHandler handler);
 int16_t azimuth_provider_get_azimuth_deg(void);
 bool azimuth_provider_is_calibrated(void);
 
+// Minimum heading change, in degrees, before the compass reports a new reading
+void azimuth_provider_set_heading_filter_deg(uint8_t filter_deg);
+
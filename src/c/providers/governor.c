@@ -0,0 +1,164 @@
+#include "governor.h"
+#include "altitude_provider.h"
+#include "azimuth_provider.h"
+#include "../utils/logging.h"
+
+// Motion is sampled from the already-filtered gravity vector, no extra subscription
+#define GOVERNOR_MOTION_CHECK_MS 2000
+// Summed per-axis gravity change (milli-G) between checks that counts as movement
+#define GOVERNOR_MOTION_THRESHOLD_MG 60
+// Consecutive quiet checks before the watch is considered still
+#define GOVERNOR_STILL_CHECKS 3
+
+#define GOVERNOR_LOW_BATTERY_PERCENT 20
+#define GOVERNOR_MEDIUM_BATTERY_PERCENT 50
+
+typedef struct {
+  uint16_t accel_interval_ms;
+  uint8_t heading_filter_deg;
+} GovernorProfile;
+
+static const GovernorProfile GOVERNOR_PROFILES[] = {
+  [GovernorQualityLow] = { .accel_interval_ms = 1000, .heading_filter_deg = 5 },
+  [GovernorQualityNormal] = { .accel_interval_ms = 400, .heading_filter_deg = 2 },
+  [GovernorQualityHigh] = { .accel_interval_ms = 200, .heading_filter_deg = 1 },
+};
+
+static bool s_active = false;
+static GovernorQuality s_requested = GovernorQualityNormal;
+static GovernorQuality s_effective = GovernorQualityNormal;
+static bool s_effective_applied = false;
+static BatteryChargeState s_battery;
+
+static AppTimer *s_motion_timer = NULL;
+static int32_t s_last_gravity[3];
+static bool s_has_gravity = false;
+static uint8_t s_quiet_checks = 0;
+
+static bool prv_is_still(void) {
+  return s_quiet_checks >= GOVERNOR_STILL_CHECKS;
+}
+
+static GovernorQuality prv_battery_cap(void) {
+  if (s_battery.is_charging || s_battery.is_plugged) {
+    return GovernorQualityHigh;
+  }
+  if (s_battery.charge_percent <= GOVERNOR_LOW_BATTERY_PERCENT) {
+    return GovernorQualityLow;
+  }
+  if (s_battery.charge_percent <= GOVERNOR_MEDIUM_BATTERY_PERCENT) {
+    return GovernorQualityNormal;
+  }
+  return GovernorQualityHigh;
+}
+
+static void prv_apply(void) {
+  if (!s_active) {
+    return;
+  }
+
+  GovernorQuality quality = s_requested;
+
+  // Nothing to track while the watch is still; step down until it moves again
+  if (prv_is_still() && quality > GovernorQualityLow) {
+    quality--;
+  }
+
+  const GovernorQuality cap = prv_battery_cap();
+  if (quality > cap) {
+    quality = cap;
+  }
+
+  if (s_effective_applied && quality == s_effective) {
+    return;
+  }
+  s_effective = quality;
+  s_effective_applied = true;
+
+  const GovernorProfile *profile = &GOVERNOR_PROFILES[quality];
+  altitude_provider_set_update_interval_ms(profile->accel_interval_ms);
+#if defined(PBL_COMPASS)
+  azimuth_provider_set_heading_filter_deg(profile->heading_filter_deg);
+#endif
+
+  HUBBLE_LOG(APP_LOG_LEVEL_DEBUG, "Governor quality %d (requested %d, battery %d%%, %s)",
+             (int)quality, (int)s_requested, (int)s_battery.charge_percent,
+             prv_is_still() ? "still" : "moving");
+}
+
+static void prv_motion_timer_callback(void *context) {
+  (void)context;
+  s_motion_timer = app_timer_register(GOVERNOR_MOTION_CHECK_MS, prv_motion_timer_callback, NULL);
+
+  int32_t gravity[3];
+  if (!altitude_provider_get_gravity(&gravity[0], &gravity[1], &gravity[2])) {
+    return;
+  }
+
+  if (s_has_gravity) {
+    int32_t change = 0;
+    for (int i = 0; i < 3; i++) {
+      const int32_t delta = gravity[i] - s_last_gravity[i];
+      change += (delta < 0) ? -delta : delta;
+    }
+
+    if (change > GOVERNOR_MOTION_THRESHOLD_MG) {
+      s_quiet_checks = 0;
+    } else if (s_quiet_checks < GOVERNOR_STILL_CHECKS) {
+      s_quiet_checks++;
+    }
+  }
+
+  memcpy(s_last_gravity, gravity, sizeof(s_last_gravity));
+  s_has_gravity = true;
+  prv_apply();
+}
+
+static void prv_battery_handler(BatteryChargeState state) {
+  s_battery = state;
+  prv_apply();
+}
+
+void governor_init(void) {
+  if (s_active) {
+    return;
+  }
+
+  s_active = true;
+  s_effective_applied = false;
+  s_has_gravity = false;
+  s_quiet_checks = 0;
+  s_battery = battery_state_service_peek();
+  battery_state_service_subscribe(prv_battery_handler);
+  s_motion_timer = app_timer_register(GOVERNOR_MOTION_CHECK_MS, prv_motion_timer_callback, NULL);
+  prv_apply();
+}
+
+void governor_deinit(void) {
+  if (!s_active) {
+    return;
+  }
+
+  if (s_motion_timer) {
+    app_timer_cancel(s_motion_timer);
+    s_motion_timer = NULL;
+  }
+  battery_state_service_unsubscribe();
+  s_active = false;
+}
+
+void governor_request_quality(GovernorQuality quality) {
+  s_requested = quality;
+  prv_apply();
+}
+
+GovernorQuality governor_get_effective_quality(void) {
+  return s_effective;
+}
+
+uint32_t governor_get_light_timeout_ms(void) {
+  if (s_battery.is_charging || s_battery.is_plugged) {
+    return 60000;
+  }
+  return (s_battery.charge_percent <= GOVERNOR_LOW_BATTERY_PERCENT) ? 10000 : 30000;
+}
@@ -0,0 +1,21 @@
+#pragma once
+
+#include <pebble.h>
+
+// Windows ask for a quality level; the governor picks the actual sensor rates from
+// that request, whether the watch is moving, and the battery state.
+typedef enum {
+  GovernorQualityLow = 0,
+  GovernorQualityNormal,
+  GovernorQualityHigh,
+} GovernorQuality;
+
+// Start watching battery and motion. Call after subscribing to the sensor hub streams.
+void governor_init(void);
+void governor_deinit(void);
+
+void governor_request_quality(GovernorQuality quality);
+GovernorQuality governor_get_effective_quality(void);
+
+// How long a user-enabled backlight may stay on before it is turned off again
+uint32_t governor_get_light_timeout_ms(void);
@@ -0,0 +1,237 @@
+#include "orientation.h"
+#include "altitude_provider.h"
+#include "../utils/settings.h"
+
+// Vectors are Q12 fixed point
+#define ORIENTATION_Q 12
+#define ORIENTATION_ONE (1 << ORIENTATION_Q)
+
+// Beyond ~85° from the horizon the line of sight has no usable azimuth
+#define ORIENTATION_MAX_VERTICAL ((ORIENTATION_ONE * 996) / 1000)
+// Below this the heading barely constrains the solution
+#define ORIENTATION_MIN_CONDITION (ORIENTATION_ONE / 8)
+// Rounding slack when checking a candidate against the measured field direction
+#define ORIENTATION_SIGN_SLACK (ORIENTATION_ONE / 64)
+
+// Circular mean state moves 1/(2^SHIFT) of the way toward each new heading.
+// Overridable so tools/trace_replay can compare filter variants.
+#ifndef ORIENTATION_SMOOTH_SHIFT
+#define ORIENTATION_SMOOTH_SHIFT 2
+#endif
+
+typedef struct {
+  int32_t x;
+  int32_t y;
+  int32_t z;
+} Vec3;
+
+// Dip from the last declination push; 255 (unknown) falls back to 0
+static int16_t s_inclination_deg = 0;
+static int32_t s_sin_incl = 0;
+static int32_t s_cos_incl = ORIENTATION_ONE;
+
+// Smoothed heading as a Q12 unit vector (cos, sin)
+static int32_t s_mean_cos = 0;
+static int32_t s_mean_sin = 0;
+static bool s_has_heading = false;
+
+static int32_t prv_isqrt(uint32_t value) {
+  uint32_t result = 0;
+  uint32_t bit = 1UL << 30;
+  while (bit > value) {
+    bit >>= 2;
+  }
+  while (bit != 0) {
+    if (value >= result + bit) {
+      value -= result + bit;
+      result = (result >> 1) + bit;
+    } else {
+      result >>= 1;
+    }
+    bit >>= 2;
+  }
+  return (int32_t)result;
+}
+
+static int32_t prv_sin_q(int32_t angle) {
+  return (sin_lookup(angle) * ORIENTATION_ONE) / TRIG_MAX_RATIO;
+}
+
+static int32_t prv_cos_q(int32_t angle) {
+  return (cos_lookup(angle) * ORIENTATION_ONE) / TRIG_MAX_RATIO;
+}
+
+static int32_t prv_wrap(int32_t angle) {
+  return angle & (TRIG_MAX_ANGLE - 1);
+}
+
+static int32_t prv_dot(Vec3 a, Vec3 b) {
+  return (a.x * b.x + a.y * b.y + a.z * b.z) >> ORIENTATION_Q;
+}
+
+static Vec3 prv_cross(Vec3 a, Vec3 b) {
+  return (Vec3) {
+    .x = (a.y * b.z - a.z * b.y) >> ORIENTATION_Q,
+    .y = (a.z * b.x - a.x * b.z) >> ORIENTATION_Q,
+    .z = (a.x * b.y - a.y * b.x) >> ORIENTATION_Q,
+  };
+}
+
+// Scales v to unit length; v must be no longer than ~2 * ORIENTATION_ONE per axis or in milli-G
+static bool prv_normalize(Vec3 *v) {
+  const int32_t length = prv_isqrt((uint32_t)(v->x * v->x + v->y * v->y + v->z * v->z));
+  if (length == 0) {
+    return false;
+  }
+  v->x = (v->x * ORIENTATION_ONE) / length;
+  v->y = (v->y * ORIENTATION_ONE) / length;
+  v->z = (v->z * ORIENTATION_ONE) / length;
+  return true;
+}
+
+// Component of horizontal north along e for a candidate azimuth
+static int32_t prv_north_along(int32_t azimuth, Vec3 a, Vec3 b, Vec3 e) {
+  return (prv_cos_q(azimuth) * prv_dot(a, e) - prv_sin_q(azimuth) * prv_dot(b, e)) >> ORIENTATION_Q;
+}
+
+// Component of the field along e for a candidate azimuth; must be positive for the
+// candidate to reproduce the measured heading rather than its opposite
+static int32_t prv_field_along(int32_t azimuth, Vec3 a, Vec3 b, Vec3 down, Vec3 e) {
+  return ((s_cos_incl * prv_north_along(azimuth, a, b, e)) >> ORIENTATION_Q) +
+         ((s_sin_incl * prv_dot(down, e)) >> ORIENTATION_Q);
+}
+
+static int32_t prv_angle_distance(int32_t a, int32_t b) {
+  int32_t delta = prv_wrap(a - b);
+  if (delta > TRIG_MAX_ANGLE / 2) {
+    delta = TRIG_MAX_ANGLE - delta;
+  }
+  return delta;
+}
+
+static bool prv_compensate(int32_t magnetic_heading, int32_t *out_azimuth) {
+  int32_t gx, gy, gz;
+  if (!altitude_provider_get_gravity(&gx, &gy, &gz)) {
+    return false;
+  }
+
+  // Accelerometer reads toward the ground when still, so gravity is "down"
+  Vec3 down = { gx, gy, gz };
+  if (!prv_normalize(&down)) {
+    return false;
+  }
+
+  // Line of sight out of the back of the watch; a is its horizontal direction and b is
+  // 90° clockwise from it seen from above (down x a, right-handed body frame)
+  const Vec3 sight = { 0, 0, -ORIENTATION_ONE };
+  const int32_t sight_down = prv_dot(sight, down);
+  if (sight_down > ORIENTATION_MAX_VERTICAL || sight_down < -ORIENTATION_MAX_VERTICAL) {
+    return false;
+  }
+  Vec3 a = {
+    sight.x - ((sight_down * down.x) >> ORIENTATION_Q),
+    sight.y - ((sight_down * down.y) >> ORIENTATION_Q),
+    sight.z - ((sight_down * down.z) >> ORIENTATION_Q),
+  };
+  if (!prv_normalize(&a)) {
+    return false;
+  }
+  const Vec3 b = prv_cross(down, a);
+
+  // The firmware heading gives the direction e of the field projected on the face plane
+  const Vec3 e = { prv_sin_q(magnetic_heading), prv_cos_q(magnetic_heading), 0 };
+  const Vec3 e_perp = { -e.y, e.x, 0 };
+
+  // Field = cos(I) * north + sin(I) * down, with north = cos(az) a - sin(az) b.
+  // Requiring no component along e_perp gives R cos(az + beta) = c.
+  const int32_t pa = prv_dot(a, e_perp);
+  const int32_t pb = prv_dot(b, e_perp);
+  const int32_t r = prv_isqrt((uint32_t)(pa * pa + pb * pb));
+  const int32_t scaled_r = (s_cos_incl * r) >> ORIENTATION_Q;
+  if (scaled_r < ORIENTATION_MIN_CONDITION) {
+    return false;
+  }
+
+  int32_t c = -(s_sin_incl * prv_dot(down, e_perp)) / scaled_r;
+  if (c > ORIENTATION_ONE) {
+    c = ORIENTATION_ONE;
+  } else if (c < -ORIENTATION_ONE) {
+    c = -ORIENTATION_ONE;
+  }
+
+  const int32_t beta = atan2_lookup(pb, pa);
+  const int32_t spread = atan2_lookup(prv_isqrt((uint32_t)(ORIENTATION_ONE * ORIENTATION_ONE - c * c)), c);
+  const int32_t first = prv_wrap(spread - beta);
+  const int32_t second = prv_wrap(-spread - beta);
+
+  const bool first_ok = prv_field_along(first, a, b, down, e) > -ORIENTATION_SIGN_SLACK;
+  const bool second_ok = prv_field_along(second, a, b, down, e) > -ORIENTATION_SIGN_SLACK;
+  if (!first_ok && !second_ok) {
+    return false;
+  }
+
+  if (first_ok && second_ok) {
+    // Both fit the projection. Stay continuous with what the user already sees, or on
+    // the first reading prefer the solution that ignores dip (c = 0, spread = 90°).
+    int32_t reference;
+    if (s_has_heading) {
+      reference = prv_wrap(atan2_lookup(s_mean_sin, s_mean_cos));
+    } else {
+      reference = prv_wrap(TRIG_MAX_ANGLE / 4 - beta);
+      if (prv_north_along(reference, a, b, e) <= 0) {
+        reference = prv_wrap(-TRIG_MAX_ANGLE / 4 - beta);
+      }
+    }
+    *out_azimuth = prv_angle_distance(first, reference) <= prv_angle_distance(second, reference)
+                   ? first : second;
+  } else {
+    *out_azimuth = first_ok ? first : second;
+  }
+  return true;
+}
+
+void orientation_reset(void) {
+  s_has_heading = false;
+  s_mean_cos = 0;
+  s_mean_sin = 0;
+}
+
+static void prv_refresh_inclination(void) {
+  int16_t inclination_deg = settings_get()->magnetic_inclination;
+  if (inclination_deg == 255) {
+    inclination_deg = 0;
+  }
+  if (inclination_deg == s_inclination_deg) {
+    return;
+  }
+
+  // The phone may push a new dip while the locator is open
+  const int32_t angle = DEG_TO_TRIGANGLE((int32_t)inclination_deg);
+  s_inclination_deg = inclination_deg;
+  s_sin_incl = prv_sin_q(angle);
+  s_cos_incl = prv_cos_q(angle);
+}
+
+bool orientation_update(int32_t magnetic_heading, int32_t *out_heading) {
+  prv_refresh_inclination();
+
+  int32_t azimuth;
+  if (!prv_compensate(magnetic_heading, &azimuth)) {
+    return false;
+  }
+
+  // Circular mean: average unit vectors rather than angles so 359° and 1° blend to 0°
+  const int32_t cos_az = prv_cos_q(azimuth);
+  const int32_t sin_az = prv_sin_q(azimuth);
+  if (!s_has_heading) {
+    s_mean_cos = cos_az;
+    s_mean_sin = sin_az;
+    s_has_heading = true;
+  } else {
+    s_mean_cos += (cos_az - s_mean_cos) >> ORIENTATION_SMOOTH_SHIFT;
+    s_mean_sin += (sin_az - s_mean_sin) >> ORIENTATION_SMOOTH_SHIFT;
+  }
+
+  *out_heading = prv_wrap(atan2_lookup(s_mean_sin, s_mean_cos));
+  return true;
+}
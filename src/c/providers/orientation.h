@@ -0,0 +1,19 @@
+#pragma once
+
+#include <pebble.h>
+
+// Fuses the compass heading with the filtered gravity vector from the altitude provider.
+//
+// The SDK only exposes a heading computed as if the watch were flat, i.e. the direction
+// of the magnetic field projected onto the watch face plane. Given the gravity vector and
+// the local magnetic dip, that projection is inverted to find the azimuth of the line of
+// sight (out of the back of the watch, as used for altitude). The dip comes from the
+// persisted settings and is treated as 0 until the phone has sent one.
+
+void orientation_reset(void);
+
+// Feed a raw CompassHeadingData.magnetic_heading. On success writes the smoothed,
+// tilt-compensated magnetic azimuth of the line of sight (clockwise trig angle) and
+// returns true. Returns false if gravity is unavailable or the pose is degenerate
+// (looking nearly straight up or down); callers should keep the previous heading.
+bool orientation_update(int32_t magnetic_heading, int32_t *out_heading);
@@ -0,0 +1,234 @@
+#include "sensor_hub.h"
+#include "altitude_provider.h"
+#include "azimuth_provider.h"
+#include "sensor_trace.h"
+#include "../utils/logging.h"
+
+struct SensorHubSubscription {
+  SensorStream stream;
+  SensorHubHandler handler;
+  void *context;
+  uint16_t min_interval_ms;
+  uint32_t last_delivery_ms;
+  bool in_use;
+  bool pending;
+};
+
+static SensorHubSubscription s_subscriptions[SENSOR_HUB_MAX_SUBSCRIBERS];
+
+// Heading tilt compensation reads the accelerometer, so compass users hold an accel reference too
+static uint8_t s_accel_refs = 0;
+static uint8_t s_compass_refs = 0;
+
+static int16_t s_values[SensorStreamCount];
+static bool s_has_value[SensorStreamCount];
+static AppTimer *s_flush_timer = NULL;
+
+static uint32_t prv_now_ms(void) {
+  time_t seconds;
+  uint16_t milliseconds;
+  time_ms(&seconds, &milliseconds);
+  return (uint32_t)seconds * 1000 + milliseconds;
+}
+
+static void prv_deliver(SensorHubSubscription *subscription, uint32_t now_ms) {
+  subscription->pending = false;
+  subscription->last_delivery_ms = now_ms;
+  subscription->handler(s_values[subscription->stream], subscription->context);
+}
+
+static void prv_flush_timer_callback(void *context);
+
+// Arm the flush timer for the earliest held-back update, or drop it if none are left
+static void prv_schedule_flush(uint32_t now_ms) {
+  uint32_t wait_ms = UINT32_MAX;
+  for (uint8_t i = 0; i < SENSOR_HUB_MAX_SUBSCRIBERS; i++) {
+    const SensorHubSubscription *subscription = &s_subscriptions[i];
+    if (!subscription->in_use || !subscription->pending) {
+      continue;
+    }
+    const uint32_t elapsed_ms = now_ms - subscription->last_delivery_ms;
+    const uint32_t due_ms = elapsed_ms >= subscription->min_interval_ms
+                                ? 0 : subscription->min_interval_ms - elapsed_ms;
+    if (due_ms < wait_ms) {
+      wait_ms = due_ms;
+    }
+  }
+
+  if (wait_ms == UINT32_MAX) {
+    if (s_flush_timer) {
+      app_timer_cancel(s_flush_timer);
+      s_flush_timer = NULL;
+    }
+    return;
+  }
+
+  if (!s_flush_timer || !app_timer_reschedule(s_flush_timer, wait_ms)) {
+    s_flush_timer = app_timer_register(wait_ms, prv_flush_timer_callback, NULL);
+  }
+}
+
+static void prv_flush_timer_callback(void *context) {
+  (void)context;
+  s_flush_timer = NULL;
+
+  const uint32_t now_ms = prv_now_ms();
+  for (uint8_t i = 0; i < SENSOR_HUB_MAX_SUBSCRIBERS; i++) {
+    SensorHubSubscription *subscription = &s_subscriptions[i];
+    if (subscription->in_use && subscription->pending &&
+        now_ms - subscription->last_delivery_ms >= subscription->min_interval_ms) {
+      prv_deliver(subscription, now_ms);
+    }
+  }
+  prv_schedule_flush(now_ms);
+}
+
+static void prv_publish(SensorStream stream, int16_t value) {
+  s_values[stream] = value;
+  s_has_value[stream] = true;
+
+  const uint32_t now_ms = prv_now_ms();
+  bool held_back = false;
+  // Slots are checked one at a time, so a handler may unsubscribe itself or others
+  for (uint8_t i = 0; i < SENSOR_HUB_MAX_SUBSCRIBERS; i++) {
+    SensorHubSubscription *subscription = &s_subscriptions[i];
+    if (!subscription->in_use || subscription->stream != stream) {
+      continue;
+    }
+    if (now_ms - subscription->last_delivery_ms >= subscription->min_interval_ms) {
+      prv_deliver(subscription, now_ms);
+    } else {
+      subscription->pending = true;
+      held_back = true;
+    }
+  }
+
+  if (held_back) {
+    prv_schedule_flush(now_ms);
+  }
+}
+
+static void prv_on_altitude(int16_t altitude_deg) {
+  prv_publish(SensorStreamAltitude, altitude_deg);
+}
+
+static void prv_retain_accel(void) {
+  if (s_accel_refs++ == 0) {
+    // Every stream holds the accelerometer, so one trace covers the whole sensor session
+    sensor_trace_start();
+    altitude_provider_init();
+    altitude_provider_set_handler(prv_on_altitude);
+  }
+}
+
+static void prv_release_accel(void) {
+  if (s_accel_refs == 0) {
+    return;
+  }
+  if (--s_accel_refs == 0) {
+    altitude_provider_deinit();
+    s_has_value[SensorStreamAltitude] = false;
+    sensor_trace_stop();
+  }
+}
+
+#if defined(PBL_COMPASS)
+static void prv_on_azimuth(int16_t azimuth_deg) {
+  prv_publish(SensorStreamAzimuth, azimuth_deg);
+}
+
+static void prv_on_calibration(bool is_calibrated) {
+  prv_publish(SensorStreamCalibration, is_calibrated ? 1 : 0);
+}
+
+static void prv_retain_compass(void) {
+  // Gravity first, so the first headings can already be tilt-compensated
+  prv_retain_accel();
+  if (s_compass_refs++ == 0) {
+    azimuth_provider_init();
+    azimuth_provider_set_handler(prv_on_azimuth);
+    azimuth_provider_set_calibration_handler(prv_on_calibration);
+  }
+}
+
+static void prv_release_compass(void) {
+  if (s_compass_refs == 0) {
+    return;
+  }
+  if (--s_compass_refs == 0) {
+    azimuth_provider_deinit();
+    s_has_value[SensorStreamAzimuth] = false;
+    s_has_value[SensorStreamCalibration] = false;
+  }
+  prv_release_accel();
+}
+#endif
+
+SensorHubSubscription *sensor_hub_subscribe(SensorStream stream, uint16_t min_interval_ms,
+                                            SensorHubHandler handler, void *context) {
+  if (!handler || stream >= SensorStreamCount) {
+    return NULL;
+  }
+#if !defined(PBL_COMPASS)
+  if (stream != SensorStreamAltitude) {
+    return NULL;
+  }
+#endif
+
+  SensorHubSubscription *subscription = NULL;
+  for (uint8_t i = 0; i < SENSOR_HUB_MAX_SUBSCRIBERS; i++) {
+    if (!s_subscriptions[i].in_use) {
+      subscription = &s_subscriptions[i];
+      break;
+    }
+  }
+  if (!subscription) {
+    HUBBLE_LOG(APP_LOG_LEVEL_ERROR, "No free sensor hub slot for stream %d", (int)stream);
+    return NULL;
+  }
+
+  // Start the provider before taking the slot so its first reading isn't delivered twice
+  if (stream == SensorStreamAltitude) {
+    prv_retain_accel();
+  }
+#if defined(PBL_COMPASS)
+  else {
+    prv_retain_compass();
+  }
+#endif
+
+  const uint32_t now_ms = prv_now_ms();
+  *subscription = (SensorHubSubscription){
+    .stream = stream,
+    .handler = handler,
+    .context = context,
+    .min_interval_ms = min_interval_ms,
+    .last_delivery_ms = now_ms - min_interval_ms,
+    .in_use = true,
+    .pending = false,
+  };
+
+  if (s_has_value[stream]) {
+    prv_deliver(subscription, now_ms);
+  }
+  return subscription;
+}
+
+void sensor_hub_unsubscribe(SensorHubSubscription *subscription) {
+  if (!subscription || !subscription->in_use) {
+    return;
+  }
+
+  const SensorStream stream = subscription->stream;
+  subscription->in_use = false;
+  subscription->pending = false;
+
+  if (stream == SensorStreamAltitude) {
+    prv_release_accel();
+  }
+#if defined(PBL_COMPASS)
+  else {
+    prv_release_compass();
+  }
+#endif
+}
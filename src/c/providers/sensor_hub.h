@@ -0,0 +1,27 @@
+#pragma once
+
+#include <pebble.h>
+
+// Shared sensor streams. The hub starts a provider when its stream gets the first
+// subscriber and stops it when the last one leaves, so several windows can listen
+// at once without stealing each other's service subscriptions.
+typedef enum {
+  SensorStreamAltitude = 0,  // Degrees above the horizon, -90 to 90
+  SensorStreamAzimuth,       // Degrees clockwise from magnetic north, 0-359 (compass only)
+  SensorStreamCalibration,   // 1 while the compass is calibrated, otherwise 0 (compass only)
+  SensorStreamCount,
+} SensorStream;
+
+#define SENSOR_HUB_MAX_SUBSCRIBERS 8
+
+typedef void (*SensorHubHandler)(int16_t value, void *context);
+
+typedef struct SensorHubSubscription SensorHubSubscription;
+
+// The handler gets the current value right away if the stream has one, then at most
+// one update per min_interval_ms (0 for every update). An update held back by the
+// interval is delivered when it ends, so a listener never keeps a stale value.
+// Returns NULL if the stream doesn't exist on this watch or all slots are taken.
+SensorHubSubscription *sensor_hub_subscribe(SensorStream stream, uint16_t min_interval_ms,
+                                            SensorHubHandler handler, void *context);
+void sensor_hub_unsubscribe(SensorHubSubscription *subscription);
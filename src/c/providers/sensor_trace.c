@@ -0,0 +1,92 @@
+#include "sensor_trace.h"
+#include "../utils/logging.h"
+
+#if SENSOR_TRACE_ENABLED
+
+// One accel batch is logged with a single call; larger batches are split
+#define SENSOR_TRACE_MAX_BATCH 25
+
+static DataLoggingSessionRef s_session = NULL;
+static uint64_t s_start_ms = 0;
+
+static uint64_t prv_now_ms(void) {
+  time_t seconds;
+  uint16_t milliseconds;
+  time_ms(&seconds, &milliseconds);
+  return (uint64_t)seconds * 1000 + milliseconds;
+}
+
+static uint32_t prv_trace_time_ms(uint64_t time_ms) {
+  return time_ms > s_start_ms ? (uint32_t)(time_ms - s_start_ms) : 0;
+}
+
+static void prv_log(const SensorTraceRecord *records, uint32_t count) {
+  const DataLoggingResult result = data_logging_log(s_session, records, count);
+  if (result != DATA_LOGGING_SUCCESS) {
+    HUBBLE_LOG(APP_LOG_LEVEL_ERROR, "Sensor trace log failed: %d", (int)result);
+  }
+}
+
+void sensor_trace_start(void) {
+  if (s_session) {
+    return;
+  }
+  s_session = data_logging_create(SENSOR_TRACE_TAG, DATA_LOGGING_BYTE_ARRAY,
+                                  sizeof(SensorTraceRecord), false);
+  s_start_ms = prv_now_ms();
+  HUBBLE_LOG(APP_LOG_LEVEL_INFO, "Sensor trace started");
+}
+
+void sensor_trace_stop(void) {
+  if (!s_session) {
+    return;
+  }
+  data_logging_finish(s_session);
+  s_session = NULL;
+  HUBBLE_LOG(APP_LOG_LEVEL_INFO, "Sensor trace finished");
+}
+
+void sensor_trace_accel(const AccelRawData *data, uint32_t num_samples, uint64_t timestamp,
+                        uint32_t sample_interval_ms) {
+  if (!s_session) {
+    return;
+  }
+
+  SensorTraceRecord records[SENSOR_TRACE_MAX_BATCH];
+  uint32_t count = 0;
+  for (uint32_t i = 0; i < num_samples; i++) {
+    records[count++] = (SensorTraceRecord){
+      .type = SensorTraceRecordAccel,
+      .flags = i == 0 ? SENSOR_TRACE_FLAG_BATCH_START : 0,
+      .time_ms = prv_trace_time_ms(timestamp + (uint64_t)i * sample_interval_ms),
+      .values = { data[i].x, data[i].y, data[i].z },
+    };
+    if (count == SENSOR_TRACE_MAX_BATCH) {
+      prv_log(records, count);
+      count = 0;
+    }
+  }
+  if (count > 0) {
+    prv_log(records, count);
+  }
+}
+
+void sensor_trace_compass(const CompassHeadingData *data) {
+  if (!s_session) {
+    return;
+  }
+
+  const SensorTraceRecord record = {
+    .type = SensorTraceRecordCompass,
+    .flags = (uint8_t)data->compass_status,
+    .time_ms = prv_trace_time_ms(prv_now_ms()),
+    .values = {
+      (int16_t)(uint16_t)data->magnetic_heading,
+      (int16_t)(uint16_t)data->true_heading,
+      data->is_declination_valid ? 1 : 0,
+    },
+  };
+  prv_log(&record, 1);
+}
+
+#endif
@@ -0,0 +1,42 @@
+#pragma once
+
+#include <pebble.h>
+
+// Set to 1 to record raw accel and compass samples through DataLogging while any
+// sensor stream is running. Traces replay offline with tools/trace_replay.
+#ifndef SENSOR_TRACE_ENABLED
+#define SENSOR_TRACE_ENABLED 0
+#endif
+
+// DataLogging tag ('TRCE'); each item is one SensorTraceRecord
+#define SENSOR_TRACE_TAG 0x54524345
+
+typedef enum {
+  SensorTraceRecordAccel = 0,
+  SensorTraceRecordCompass = 1,
+} SensorTraceRecordType;
+
+// Set on the first accel sample of each batch the service delivered
+#define SENSOR_TRACE_FLAG_BATCH_START 0x01
+
+// 12 bytes, little-endian as stored by the watch
+typedef struct __attribute__((__packed__)) {
+  uint8_t type;       // SensorTraceRecordType
+  uint8_t flags;      // Accel: SENSOR_TRACE_FLAG_*; compass: CompassStatus
+  uint32_t time_ms;   // Since the trace started
+  int16_t values[3];  // Accel: x, y, z in milli-G. Compass: magnetic heading, true heading
+                      // (trig angles stored as uint16), declination valid flag
+} SensorTraceRecord;
+
+#if SENSOR_TRACE_ENABLED
+void sensor_trace_start(void);
+void sensor_trace_stop(void);
+void sensor_trace_accel(const AccelRawData *data, uint32_t num_samples, uint64_t timestamp,
+                        uint32_t sample_interval_ms);
+void sensor_trace_compass(const CompassHeadingData *data);
+#else
+#define sensor_trace_start() ((void)0)
+#define sensor_trace_stop() ((void)0)
+#define sensor_trace_accel(data, num_samples, timestamp, sample_interval_ms) ((void)0)
+#define sensor_trace_compass(data) ((void)0)
+#endif
@@ -0,0 +1,34 @@
+#pragma once
+
+#include <pebble.h>
+
+// Fixed-size bit arrays stored as bytes, so they persist with a plain persist_write_data
+
+#define BITSET_BYTES(bits) (((bits) + 7) / 8)
+
+static inline bool bitset_test(const uint8_t *bits, uint16_t index) {
+  return (bits[index / 8] >> (index % 8)) & 1;
+}
+
+static inline void bitset_assign(uint8_t *bits, uint16_t index, bool value) {
+  if (value) {
+    bits[index / 8] |= (uint8_t)(1 << (index % 8));
+  } else {
+    bits[index / 8] &= (uint8_t)~(1 << (index % 8));
+  }
+}
+
+// Index of the first set bit at or after `from`, or `size` if there is none
+static inline uint16_t bitset_next(const uint8_t *bits, uint16_t size, uint16_t from) {
+  for (uint16_t i = from; i < size; i++) {
+    if (bits[i / 8] == 0) {
+      // Skip to the next byte boundary
+      i |= 7;
+      continue;
+    }
+    if (bitset_test(bits, i)) {
+      return i;
+    }
+  }
+  return size;
+}
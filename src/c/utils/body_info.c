@@ -1,4 +1,5 @@
 #include "body_info.h"
+#include "star_catalog.h"
 
 // Body names corresponding to BODY_NAMES in JavaScript msgproc.js
 // Must stay in sync with the JavaScript array
@@ -34,10 +35,9 @@ const char* BODY_NAMES[] = {
   "Lyra"
 };
 
-// Resource IDs for body images (using RESOURCE_ID_FULL_MOON as placeholder)
-// TODO: Replace with actual resource IDs when images are available
+// Resource IDs for body images; 0 where the image is drawn instead of loaded
 const uint32_t BODY_RESOURCE_IDS[] = {
-  RESOURCE_ID_FULL_MOON,
+  0,  // The Moon is rendered for its phase by moon_render
   RESOURCE_ID_PLANET_MERCURY,
   RESOURCE_ID_PLANET_VENUS,
   RESOURCE_ID_PLANET_MARS,
@@ -47,25 +47,8 @@ const uint32_t BODY_RESOURCE_IDS[] = {
   RESOURCE_ID_PLANET_NEPTUNE,
   RESOURCE_ID_PLANET_PLUTO,
   RESOURCE_ID_SUN,
-  RESOURCE_ID_CONSTELLATION_ARIES,
-  RESOURCE_ID_CONSTELLATION_TAURUS,
-  RESOURCE_ID_CONSTELLATION_GEMINI,
-  RESOURCE_ID_CONSTELLATION_CANCER,
-  RESOURCE_ID_CONSTELLATION_LEO,
-  RESOURCE_ID_CONSTELLATION_VIRGO,
-  RESOURCE_ID_CONSTELLATION_LIBRA,
-  RESOURCE_ID_CONSTELLATION_SCORPIUS,
-  RESOURCE_ID_CONSTELLATION_SAGITTARIUS,
-  RESOURCE_ID_CONSTELLATION_CAPRICORNUS,
-  RESOURCE_ID_CONSTELLATION_AQUARIUS,
-  RESOURCE_ID_CONSTELLATION_PISCES,
-  RESOURCE_ID_CONSTELLATION_ORION,
-  RESOURCE_ID_CONSTELLATION_URSA_MAJOR,
-  RESOURCE_ID_CONSTELLATION_URSA_MINOR,
-  RESOURCE_ID_CONSTELLATION_CASSIOPEIA,
-  RESOURCE_ID_CONSTELLATION_CYGNUS,
-  RESOURCE_ID_CONSTELLATION_CRUX,
-  RESOURCE_ID_CONSTELLATION_LYRA
+  // Constellations have no image resource; their figures come from constellation_figure
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0
 };
 
 const int NUM_BODIES = sizeof(BODY_NAMES) / sizeof(BODY_NAMES[0]);
@@ -77,9 +60,21 @@ const char* body_info_get_name(int body_id) {
   return NULL;
 }
 
+bool body_info_copy_name(int body_id, char *buffer, size_t size) {
+  const char *name = body_info_get_name(body_id);
+  if (name) {
+    snprintf(buffer, size, "%s", name);
+    return true;
+  }
+  if (star_catalog_is_body(body_id)) {
+    return star_catalog_get_name(star_catalog_index_of(body_id), buffer, size);
+  }
+  return false;
+}
+
 uint32_t body_info_get_resource_id(int body_id) {
   if (body_id >= 0 && body_id < NUM_BODIES) {
     return BODY_RESOURCE_IDS[body_id];
   }
-  return RESOURCE_ID_FULL_MOON;  // Default fallback
+  return 0;  // No image
 }
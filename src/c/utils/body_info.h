@@ -6,11 +6,14 @@
 extern const char* BODY_NAMES[];
 extern const int NUM_BODIES;
 
-// Resource IDs for body images (using RESOURCE_ID_FULL_MOON as placeholder)
+// Resource IDs for body images; 0 where the image is drawn instead of loaded
 extern const uint32_t BODY_RESOURCE_IDS[];
 
 // Get body name by ID, returns NULL if invalid ID
 const char* body_info_get_name(int body_id);
 
-// Get body resource ID by ID, returns RESOURCE_ID_FULL_MOON if invalid ID
+// Copy the name of a built-in body or star catalog entry; false if the id is unknown
+bool body_info_copy_name(int body_id, char *buffer, size_t size);
+
+// Get body resource ID by ID, returns 0 if the body has no image resource
 uint32_t body_info_get_resource_id(int body_id);
@@ -1,16 +1,29 @@
 #include "bodymsg.h"
 #include "msgproc.h"
+#include "declination.h"
+#include "compass_worker.h"
+#include "heap_stats.h"
+#include "star_catalog.h"
+#include "moon_render.h"
+#include "tuple_int.h"
 #include "../windows/body/details.h"
 #include "logging.h"
 #include <pebble.h>
 
-// Message buffer sizes
-#define INBOX_SIZE 64
-#define OUTBOX_SIZE 64
+// Message buffer sizes; the inbox must hold a full sky snapshot (4 + 29 * 5 bytes)
+#define INBOX_SIZE 256
+// The outbox must hold a HEAP_STATS report (118 bytes plus dictionary overhead)
+#define OUTBOX_SIZE 128
+
+// REQUEST_FIXED payload: RA cdeg (u16 LE), Dec cdeg (s16 LE), magnitude * 10 (s8)
+#define FIXED_REQUEST_LENGTH 5
 
 // Static variables
 static bool s_app_message_ready = false;
 static int s_pending_body_id = -1;  // Body ID we're waiting for
+// Window handlers, oldest first
+static const BodymsgHandlers *s_handlers[BODYMSG_MAX_HANDLERS];
+static uint8_t s_num_handlers = 0;
 
 // Forward declarations for callbacks
 static void prv_inbox_received_callback(DictionaryIterator *iter, void *context);
@@ -19,48 +32,55 @@ static void prv_outbox_sent_callback(DictionaryIterator *iter, void *context);
 static void prv_outbox_failed_callback(DictionaryIterator *iter, AppMessageResult reason, void *context);
 
 void bodymsg_init(void) {
+    if (s_app_message_ready) {
+        return;  // Already open (opened at launch so phone pushes can land)
+    }
+
     // Open AppMessage with appropriate buffer sizes
     app_message_open(INBOX_SIZE, OUTBOX_SIZE);
 
-    // Note: Callbacks are registered separately via bodymsg_register_callbacks()
-    // to allow dynamic switching between body messages and events
+    // Registered once: windows hook in through bodymsg_add_handlers(), so pushes
+    // like the declination are never lost to a window that cleared the inbox
+    app_message_register_inbox_received(prv_inbox_received_callback);
+    app_message_register_inbox_dropped(prv_inbox_dropped_callback);
+    app_message_register_outbox_sent(prv_outbox_sent_callback);
+    app_message_register_outbox_failed(prv_outbox_failed_callback);
 
     s_app_message_ready = true;
     s_pending_body_id = -1;
 }
 
 void bodymsg_deinit(void) {
+    app_message_deregister_callbacks();
     s_app_message_ready = false;
     s_pending_body_id = -1;
+    s_num_handlers = 0;
 }
 
 bool bodymsg_is_ready(void) {
     return s_app_message_ready;
 }
 
-void bodymsg_register_callbacks(void) {
-    if (!s_app_message_ready) {
-        HUBBLE_LOG(APP_LOG_LEVEL_ERROR, "Cannot register callbacks: AppMessage not ready");
-        return;
+bool bodymsg_add_handlers(const BodymsgHandlers *handlers) {
+    if (s_num_handlers >= BODYMSG_MAX_HANDLERS) {
+        HUBBLE_LOG(APP_LOG_LEVEL_ERROR, "Too many message handlers");
+        return false;
     }
-
-    // Register callbacks for body message handling
-    app_message_register_inbox_received(prv_inbox_received_callback);
-    app_message_register_inbox_dropped(prv_inbox_dropped_callback);
-    app_message_register_outbox_sent(prv_outbox_sent_callback);
-    app_message_register_outbox_failed(prv_outbox_failed_callback);
-
-    HUBBLE_LOG(APP_LOG_LEVEL_INFO, "Body message callbacks registered");
+    s_handlers[s_num_handlers++] = handlers;
+    return true;
 }
 
-void bodymsg_deregister_callbacks(void) {
-    // Deregister callbacks to allow other handlers (like events) to take over
-    app_message_register_inbox_received(NULL);
-    app_message_register_inbox_dropped(NULL);
-    app_message_register_outbox_sent(NULL);
-    app_message_register_outbox_failed(NULL);
-
-    HUBBLE_LOG(APP_LOG_LEVEL_INFO, "Body message callbacks deregistered");
+void bodymsg_remove_handlers(const BodymsgHandlers *handlers) {
+    for (int i = 0; i < s_num_handlers; i++) {
+        if (s_handlers[i] == handlers) {
+            // Keep the rest in order
+            for (int j = i + 1; j < s_num_handlers; j++) {
+                s_handlers[j - 1] = s_handlers[j];
+            }
+            s_num_handlers--;
+            return;
+        }
+    }
 }
 
 bool bodymsg_request_body(int body_id) {
@@ -83,8 +103,23 @@ bool bodymsg_request_body(int body_id) {
         return false;
     }
 
-    // Add the body ID to request
-    dict_write_int(out_iter, MESSAGE_KEY_REQUEST_BODY, &body_id, sizeof(int), true);
+    if (star_catalog_is_body(body_id)) {
+        // The phone has no copy of the catalog, so send the coordinates instead of the id
+        StarCatalogEntry entry;
+        if (!star_catalog_get(star_catalog_index_of(body_id), &entry)) {
+            HUBBLE_LOG(APP_LOG_LEVEL_ERROR, "No catalog entry for body %d", body_id);
+            return false;
+        }
+        const uint8_t fixed[FIXED_REQUEST_LENGTH] = {
+            entry.ra_cdeg & 0xFF, entry.ra_cdeg >> 8,
+            (uint16_t)entry.dec_cdeg & 0xFF, (uint16_t)entry.dec_cdeg >> 8,
+            (uint8_t)entry.magnitude_x10,
+        };
+        dict_write_data(out_iter, MESSAGE_KEY_REQUEST_FIXED, fixed, sizeof(fixed));
+    } else {
+        // Add the body ID to request
+        dict_write_int(out_iter, MESSAGE_KEY_REQUEST_BODY, &body_id, sizeof(int), true);
+    }
 
     // Send the message
     result = app_message_outbox_send();
@@ -98,10 +133,38 @@ bool bodymsg_request_body(int body_id) {
     return true;
 }
 
+static void prv_handle_inbox(DictionaryIterator *iter);
+
 // Callback when a message is received
 static void prv_inbox_received_callback(DictionaryIterator *iter, void *context) {
     HUBBLE_LOG(APP_LOG_LEVEL_INFO, "Message received");
 
+    prv_handle_inbox(iter);
+    // Body data opens or updates the details window from here, so sample after it
+    heap_stats_record(HeapSiteMessage, HeapEventSample);
+}
+
+static void prv_handle_inbox(DictionaryIterator *iter) {
+    for (int i = s_num_handlers - 1; i >= 0; i--) {
+        if (s_handlers[i]->received && s_handlers[i]->received(iter)) {
+            return;
+        }
+    }
+
+    // Declination is pushed by the phone once per session, independent of body requests
+    if (declination_handle_message(iter)) {
+        return;
+    }
+
+    // Settings saved on the phone
+    if (compass_worker_handle_message(iter)) {
+        return;
+    }
+
+    if (heap_stats_handle_message(iter)) {
+        return;
+    }
+
     // Check if this is a BODY_PACKAGE message
     Tuple *body_package_tuple = dict_find(iter, MESSAGE_KEY_BODY_PACKAGE);
     if (body_package_tuple) {
@@ -113,7 +176,7 @@ static void prv_inbox_received_callback(DictionaryIterator *iter, void *context)
             if (length == 7) {
                 // Unpack the body package
                 DetailsContent content;
-                if (msgproc_unpack_body_package(data, length, &content)) {
+                if (msgproc_unpack_body_package(data, length, s_pending_body_id, &content)) {
                     // Only process if this response matches our current pending request
                     // We need to check if there's even a pending request
                     if (s_pending_body_id == -1) {
@@ -121,6 +184,20 @@ static void prv_inbox_received_callback(DictionaryIterator *iter, void *context)
                         return;
                     }
 
+                    // Optional equatorial snapshot so the locator can track the body
+                    Tuple *equatorial_tuple = dict_find(iter, MESSAGE_KEY_BODY_EQUATORIAL);
+                    content.has_track = equatorial_tuple && equatorial_tuple->type == TUPLE_BYTE_ARRAY &&
+                                        msgproc_unpack_body_equatorial(equatorial_tuple->value->data,
+                                                                       equatorial_tuple->length,
+                                                                       &content.track);
+
+                    // Exact phase angle for the Moon; the package only carries its eighth
+                    Tuple *phase_tuple = dict_find(iter, MESSAGE_KEY_MOON_PHASE);
+                    if (phase_tuple && content.body_id == 0) {
+                        content.moon_phase_cdeg =
+                            (uint16_t)(tuple_int(phase_tuple) % MOON_PHASE_CDEG_MAX);
+                    }
+
                     // Show the details window
                     details_show(&content);
                     s_pending_body_id = -1;  // Clear pending request
@@ -143,6 +220,11 @@ static void prv_inbox_received_callback(DictionaryIterator *iter, void *context)
 static void prv_inbox_dropped_callback(AppMessageResult reason, void *context) {
     HUBBLE_LOG(APP_LOG_LEVEL_ERROR, "Message dropped. Reason: %d", (int)reason);
     s_pending_body_id = -1;  // Clear any pending request
+    for (int i = s_num_handlers - 1; i >= 0; i--) {
+        if (s_handlers[i]->dropped) {
+            s_handlers[i]->dropped(reason);
+        }
+    }
 }
 
 // Callback when a message was sent successfully
@@ -155,4 +237,9 @@ static void prv_outbox_sent_callback(DictionaryIterator *iter, void *context) {
 static void prv_outbox_failed_callback(DictionaryIterator *iter, AppMessageResult reason, void *context) {
     HUBBLE_LOG(APP_LOG_LEVEL_ERROR, "Message send failed. Reason: %d", (int)reason);
     s_pending_body_id = -1;  // Clear pending request on failure
+    for (int i = s_num_handlers - 1; i >= 0; i--) {
+        if (s_handlers[i]->send_failed) {
+            s_handlers[i]->send_failed(reason);
+        }
+    }
 }
@@ -3,21 +3,31 @@
 #include <pebble.h>
 
 // Initialize the body message system
-// Sets up AppMessage buffers and registers callbacks
+// Opens AppMessage and registers the one set of callbacks the app keeps until exit
 void bodymsg_init(void);
 
 // Deinitialize the body message system
 void bodymsg_deinit(void);
 
+// Most windows that can be stacked with their own handlers
+#define BODYMSG_MAX_HANDLERS 4
+
+// A window's share of the inbox, added while it is loaded. The newest handlers see
+// a message first; one that returns true consumes it. Anything left goes to the
+// app-wide handlers: declination, worker settings, heap stats and body data.
+typedef struct {
+  bool (*received)(DictionaryIterator *iter);
+  void (*dropped)(AppMessageResult reason);       // Optional
+  void (*send_failed)(AppMessageResult reason);   // Optional
+} BodymsgHandlers;
+
+// `handlers` must outlive the registration; false if the stack is full
+bool bodymsg_add_handlers(const BodymsgHandlers *handlers);
+void bodymsg_remove_handlers(const BodymsgHandlers *handlers);
+
 // Request data for a specific body ID
 // This sends a REQUEST_BODY message to the JavaScript side
 bool bodymsg_request_body(int body_id);
 
 // Check if the message system is ready to send messages
 bool bodymsg_is_ready(void);
-
-// Register body message callbacks (for when handling body requests)
-void bodymsg_register_callbacks(void);
-
-// Deregister body message callbacks (to allow other handlers like events)
-void bodymsg_deregister_callbacks(void);
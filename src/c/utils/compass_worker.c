@@ -0,0 +1,110 @@
+#include "compass_worker.h"
+#include "worker_protocol.h"
+#include "settings.h"
+#include "tuple_int.h"
+#include "logging.h"
+
+#if defined(PBL_COMPASS)
+static bool s_has_heading = false;
+static bool s_is_calibrated = false;
+static CompassHeading s_heading = 0;
+static time_t s_heading_time = 0;
+
+static void prv_send(uint8_t type, uint16_t data0) {
+  if (!app_worker_is_running()) {
+    return;
+  }
+  AppWorkerMessage message = { .data0 = data0 };
+  app_worker_send_message(type, &message);
+}
+
+static void prv_worker_message_handler(uint16_t type, AppWorkerMessage *data) {
+  if (type != WORKER_MSG_HEADING || data->data0 == 0) {
+    return;
+  }
+
+  const CompassStatus status = (CompassStatus)((int16_t)data->data0 - 1);
+  s_is_calibrated = (status != CompassStatusDataInvalid && status != CompassStatusUnavailable);
+  s_heading = data->data1;
+  // Worker and app share the clock, so the age turns into an absolute time
+  s_heading_time = time(NULL) - data->data2;
+  s_has_heading = true;
+}
+
+static void prv_apply_setting(void) {
+  const bool enabled = settings_get()->background_compass != 0;
+  const bool running = app_worker_is_running();
+
+  if (enabled && !running) {
+    // The system asks the user first if another app's worker is running
+    const AppWorkerResult result = app_worker_launch();
+    if (result != APP_WORKER_RESULT_SUCCESS) {
+      HUBBLE_LOG(APP_LOG_LEVEL_WARNING, "Compass worker not launched: %d", (int)result);
+    }
+  } else if (!enabled && running) {
+    app_worker_kill();
+    s_has_heading = false;
+    HUBBLE_LOG(APP_LOG_LEVEL_INFO, "Stopped compass worker");
+  }
+}
+#endif
+
+void compass_worker_init(void) {
+#if defined(PBL_COMPASS)
+  app_worker_message_subscribe(prv_worker_message_handler);
+  prv_apply_setting();
+  // A freshly launched worker sends its first reading by itself
+  prv_send(WORKER_MSG_REQUEST_HEADING, 0);
+#endif
+}
+
+void compass_worker_deinit(void) {
+#if defined(PBL_COMPASS)
+  app_worker_message_unsubscribe();
+#endif
+}
+
+bool compass_worker_handle_message(DictionaryIterator *iter) {
+  Tuple *tuple = dict_find(iter, MESSAGE_KEY_CFG_BACKGROUND_COMPASS);
+  if (!tuple) {
+    return false;
+  }
+
+  const uint8_t enabled = tuple_int(tuple) != 0 ? 1 : 0;
+  LocalSettings *settings = settings_get();
+  if (settings->background_compass != enabled) {
+    settings->background_compass = enabled;
+    settings_save();
+  }
+
+#if defined(PBL_COMPASS)
+  prv_apply_setting();
+#endif
+  return true;
+}
+
+void compass_worker_set_paused(bool paused) {
+#if defined(PBL_COMPASS)
+  prv_send(WORKER_MSG_SET_PAUSED, paused ? 1 : 0);
+#else
+  (void)paused;
+#endif
+}
+
+bool compass_worker_get_azimuth(int16_t *azimuth_deg) {
+#if defined(PBL_COMPASS)
+  if (!s_has_heading || !s_is_calibrated || time(NULL) - s_heading_time > COMPASS_WORKER_MAX_AGE_S) {
+    return false;
+  }
+  // Pebble heading is counter-clockwise from 12 o'clock; convert to clockwise
+  int32_t deg = TRIGANGLE_TO_DEG(TRIG_MAX_ANGLE - s_heading);
+  if (deg >= 360) {
+    deg -= 360;
+  }
+  *azimuth_deg = (int16_t)deg;
+  return true;
+#else
+  (void)azimuth_deg;
+  return false;
+#endif
+}
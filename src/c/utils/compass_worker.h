@@ -0,0 +1,22 @@
+#pragma once
+
+#include <pebble.h>
+
+// A cached worker heading older than this is not used to seed the locator
+#define COMPASS_WORKER_MAX_AGE_S (10 * SECONDS_PER_MINUTE)
+
+// Launch or stop the background compass worker to match the setting, and listen
+// for the headings it sends while the app is open
+void compass_worker_init(void);
+void compass_worker_deinit(void);
+
+// Apply a CFG_BACKGROUND_COMPASS change from the phone if the message carries one.
+// Returns true if it did.
+bool compass_worker_handle_message(DictionaryIterator *iter);
+
+// Pause the worker's sampling while the app uses the compass itself
+void compass_worker_set_paused(bool paused);
+
+// Last calibrated heading from the worker, clockwise degrees from magnetic north.
+// False if the worker isn't running or has nothing recent.
+bool compass_worker_get_azimuth(int16_t *azimuth_deg);
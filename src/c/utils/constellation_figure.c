@@ -0,0 +1,123 @@
+#include "constellation_figure.h"
+#include "logging.h"
+
+// Resource layout; see build_figures.py
+#define CONSTELLATION_FIGURE_MAGIC "HCFG"
+#define CONSTELLATION_FIGURE_VERSION 1
+#define CONSTELLATION_FIGURE_HEADER_SIZE 8
+#define CONSTELLATION_FIGURE_DIRECTORY_ENTRY_SIZE 5
+
+// The artwork's star markers are 4px in an 80px box
+#define CONSTELLATION_FIGURE_STAR_DIVISOR 20
+#define CONSTELLATION_FIGURE_MIN_STAR_SIZE 3
+
+static ResHandle s_handle;
+static uint8_t s_count;
+static uint8_t s_first_body_id;
+static uint8_t s_grid;
+static bool s_opened;
+
+// Read the header once; a figure is then one directory read and one data read
+static bool prv_open(void) {
+  if (s_opened) {
+    return s_count > 0;
+  }
+  s_opened = true;
+
+  s_handle = resource_get_handle(RESOURCE_ID_CONSTELLATION_FIGURES);
+  const size_t size = resource_size(s_handle);
+  uint8_t header[CONSTELLATION_FIGURE_HEADER_SIZE];
+  if (size < sizeof(header) ||
+      resource_load_byte_range(s_handle, 0, header, sizeof(header)) != sizeof(header) ||
+      memcmp(header, CONSTELLATION_FIGURE_MAGIC, 4) != 0 ||
+      header[4] != CONSTELLATION_FIGURE_VERSION || header[7] == 0 ||
+      size < CONSTELLATION_FIGURE_HEADER_SIZE +
+                 (size_t)header[5] * CONSTELLATION_FIGURE_DIRECTORY_ENTRY_SIZE) {
+    HUBBLE_LOG(APP_LOG_LEVEL_ERROR, "Constellation figures resource is missing or malformed");
+    return false;
+  }
+
+  s_count = header[5];
+  s_first_body_id = header[6];
+  s_grid = header[7];
+  return true;
+}
+
+bool constellation_figure_exists(int body_id) {
+  return prv_open() && body_id >= s_first_body_id && body_id < s_first_body_id + s_count;
+}
+
+bool constellation_figure_load(int body_id, ConstellationFigure *figure) {
+  if (!figure || !constellation_figure_exists(body_id)) {
+    return false;
+  }
+
+  uint8_t entry[CONSTELLATION_FIGURE_DIRECTORY_ENTRY_SIZE];
+  const uint32_t entry_offset = CONSTELLATION_FIGURE_HEADER_SIZE +
+      (uint32_t)(body_id - s_first_body_id) * CONSTELLATION_FIGURE_DIRECTORY_ENTRY_SIZE;
+  if (resource_load_byte_range(s_handle, entry_offset, entry, sizeof(entry)) != sizeof(entry)) {
+    return false;
+  }
+
+  const uint32_t offset = (uint32_t)(entry[0] | (entry[1] << 8));
+  figure->grid = s_grid;
+  figure->point_count = entry[2];
+  figure->star_count = entry[3];
+  figure->segment_count = entry[4];
+  if (figure->point_count > CONSTELLATION_FIGURE_MAX_POINTS ||
+      figure->star_count > figure->point_count ||
+      figure->segment_count > CONSTELLATION_FIGURE_MAX_SEGMENTS) {
+    HUBBLE_LOG(APP_LOG_LEVEL_ERROR, "Constellation figure %d is too large", body_id);
+    return false;
+  }
+
+  // Points and segments are adjacent in the resource but separate arrays here
+  const size_t points_size = figure->point_count * sizeof(ConstellationFigurePoint);
+  const size_t segments_size = figure->segment_count * sizeof(figure->segments[0]);
+  if (resource_load_byte_range(s_handle, offset, (uint8_t *)figure->points, points_size) !=
+          points_size ||
+      resource_load_byte_range(s_handle, offset + points_size, (uint8_t *)figure->segments,
+                               segments_size) != segments_size) {
+    return false;
+  }
+
+  for (uint8_t i = 0; i < figure->segment_count; i++) {
+    if (figure->segments[i][0] >= figure->point_count ||
+        figure->segments[i][1] >= figure->point_count) {
+      HUBBLE_LOG(APP_LOG_LEVEL_ERROR, "Constellation figure %d has a bad segment", body_id);
+      return false;
+    }
+  }
+  return true;
+}
+
+static GPoint prv_scale(const ConstellationFigure *figure, GRect box, ConstellationFigurePoint point) {
+  return GPoint(box.origin.x + (point.x * (box.size.w - 1)) / figure->grid,
+                box.origin.y + (point.y * (box.size.h - 1)) / figure->grid);
+}
+
+void constellation_figure_draw(GContext *ctx, const ConstellationFigure *figure, GRect box) {
+  if (!ctx || !figure || figure->grid == 0) {
+    return;
+  }
+
+  graphics_context_set_stroke_color(ctx, PBL_IF_COLOR_ELSE(GColorLightGray, GColorWhite));
+  for (uint8_t i = 0; i < figure->segment_count; i++) {
+    graphics_draw_line(ctx, prv_scale(figure, box, figure->points[figure->segments[i][0]]),
+                       prv_scale(figure, box, figure->points[figure->segments[i][1]]));
+  }
+
+  // Black outlines keep markers readable where lines cross them
+  int16_t star_size = box.size.w / CONSTELLATION_FIGURE_STAR_DIVISOR;
+  if (star_size < CONSTELLATION_FIGURE_MIN_STAR_SIZE) {
+    star_size = CONSTELLATION_FIGURE_MIN_STAR_SIZE;
+  }
+  graphics_context_set_fill_color(ctx, GColorWhite);
+  graphics_context_set_stroke_color(ctx, GColorBlack);
+  for (uint8_t i = 0; i < figure->star_count; i++) {
+    const GPoint center = prv_scale(figure, box, figure->points[i]);
+    const GRect marker = GRect(center.x - star_size / 2, center.y - star_size / 2, star_size, star_size);
+    graphics_draw_rect(ctx, GRect(marker.origin.x - 1, marker.origin.y - 1, star_size + 2, star_size + 2));
+    graphics_fill_rect(ctx, marker, 0, GCornerNone);
+  }
+}
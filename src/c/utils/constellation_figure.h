@@ -0,0 +1,34 @@
+#pragma once
+
+#include <pebble.h>
+
+// Constellation stick figures from the CONSTELLATION_FIGURES resource, built from the
+// artwork by tools/constellations/build_figures.py. A figure is a few dozen bytes of
+// points and line segments, drawn as vectors at whatever size the screen allows.
+
+// Limits checked by the builder
+#define CONSTELLATION_FIGURE_MAX_POINTS 32
+#define CONSTELLATION_FIGURE_MAX_SEGMENTS 40
+
+typedef struct {
+  uint8_t x;
+  uint8_t y;
+} ConstellationFigurePoint;
+
+typedef struct {
+  uint8_t grid;  // Coordinates run 0..grid across the figure's square box
+  uint8_t point_count;
+  uint8_t star_count;  // The first star_count points are stars; the rest are line bends
+  uint8_t segment_count;
+  ConstellationFigurePoint points[CONSTELLATION_FIGURE_MAX_POINTS];
+  uint8_t segments[CONSTELLATION_FIGURE_MAX_SEGMENTS][2];  // Point index pairs
+} ConstellationFigure;
+
+// True if body_id has a figure
+bool constellation_figure_exists(int body_id);
+
+// Read one figure from flash; false if there is none for body_id
+bool constellation_figure_load(int body_id, ConstellationFigure *figure);
+
+// Scale the figure into box: grey lines under white star markers, like the artwork
+void constellation_figure_draw(GContext *ctx, const ConstellationFigure *figure, GRect box);
@@ -0,0 +1,117 @@
+#include "declination.h"
+#include "settings.h"
+#include "sky.h"
+#include "tuple_int.h"
+#include "logging.h"
+
+// Stored stamps closer together than this are treated as the same reading
+#define DECLINATION_REWRITE_INTERVAL_S SECONDS_PER_DAY
+
+static bool s_requested = false;
+
+bool declination_handle_message(DictionaryIterator *iter) {
+  Tuple *declination_tuple = dict_find(iter, MESSAGE_KEY_DECLINATION);
+  if (!declination_tuple) {
+    return false;
+  }
+
+#if defined(PBL_COMPASS)
+  // Declination is sent as rounded integer degrees
+  const int16_t declination = (int16_t)tuple_int(declination_tuple);
+
+  Tuple *lat_tuple = dict_find(iter, MESSAGE_KEY_DECLINATION_LAT);
+  Tuple *lon_tuple = dict_find(iter, MESSAGE_KEY_DECLINATION_LON);
+  Tuple *time_tuple = dict_find(iter, MESSAGE_KEY_DECLINATION_TIME);
+  Tuple *inclination_tuple = dict_find(iter, MESSAGE_KEY_INCLINATION);
+
+  const int16_t lat_x10 = lat_tuple ? (int16_t)tuple_int(lat_tuple) : 0;
+  const int16_t lon_x10 = lon_tuple ? (int16_t)tuple_int(lon_tuple) : 0;
+  const uint32_t timestamp = time_tuple ? (uint32_t)tuple_int(time_tuple) : (uint32_t)time(NULL);
+
+  LocalSettings *settings = settings_get();
+  const int16_t inclination = inclination_tuple ? (int16_t)tuple_int(inclination_tuple)
+                                                : settings->magnetic_inclination;
+
+  // Skip the flash write when the phone re-sends the same reading
+  const bool unchanged = settings->magnetic_declination == declination &&
+                         settings->declination_lat_x10 == lat_x10 &&
+                         settings->declination_lon_x10 == lon_x10 &&
+                         settings->magnetic_inclination == inclination &&
+                         timestamp >= settings->declination_timestamp &&
+                         timestamp - settings->declination_timestamp < DECLINATION_REWRITE_INTERVAL_S;
+
+  if (!unchanged) {
+    settings->magnetic_declination = declination;
+    settings->declination_lat_x10 = lat_x10;
+    settings->declination_lon_x10 = lon_x10;
+    settings->declination_timestamp = timestamp;
+    settings->magnetic_inclination = inclination;
+    settings_save();
+  }
+
+  s_requested = false;
+  HUBBLE_LOG(APP_LOG_LEVEL_INFO, "Stored magnetic declination: %d degrees (%s)", declination,
+             unchanged ? "unchanged" : "updated");
+#endif
+
+  return true;
+}
+
+// True if the last known observer is further than DECLINATION_MAX_MOVE_X10 from where
+// the stored declination was computed. Unknown without a sky snapshot.
+static bool prv_has_moved(const LocalSettings *settings) {
+  int16_t latitude_cdeg;
+  int16_t longitude_cdeg;
+  if (!sky_get_observer(&latitude_cdeg, &longitude_cdeg)) {
+    return false;
+  }
+
+  const int32_t dlat = latitude_cdeg / 10 - settings->declination_lat_x10;
+  int32_t dlon = longitude_cdeg / 10 - settings->declination_lon_x10;
+  if (dlon > 1800) {
+    dlon -= 3600;
+  } else if (dlon < -1800) {
+    dlon += 3600;
+  }
+  return dlat > DECLINATION_MAX_MOVE_X10 || dlat < -DECLINATION_MAX_MOVE_X10 ||
+         dlon > DECLINATION_MAX_MOVE_X10 || dlon < -DECLINATION_MAX_MOVE_X10;
+}
+
+bool declination_is_fresh(void) {
+  const LocalSettings *settings = settings_get();
+  if (settings->magnetic_declination == 255 || settings->declination_timestamp == 0) {
+    return false;
+  }
+
+  const time_t now = time(NULL);
+  return now - (time_t)settings->declination_timestamp < DECLINATION_MAX_AGE_S &&
+         !prv_has_moved(settings);
+}
+
+void declination_request_if_stale(void) {
+#if defined(PBL_COMPASS)
+  if (s_requested || declination_is_fresh()) {
+    return;
+  }
+
+  DictionaryIterator *out_iter;
+  AppMessageResult result = app_message_outbox_begin(&out_iter);
+
+  if (result != APP_MSG_OK) {
+    HUBBLE_LOG(APP_LOG_LEVEL_ERROR, "Failed to begin outbox for declination request: %d", (int)result);
+    return;
+  }
+
+  // Send REQUEST_DECLINATION message (value doesn't matter, just the key)
+  int dummy_value = 1;
+  dict_write_int(out_iter, MESSAGE_KEY_REQUEST_DECLINATION, &dummy_value, sizeof(int), true);
+
+  result = app_message_outbox_send();
+  if (result == APP_MSG_OK) {
+    s_requested = true;
+    HUBBLE_LOG(APP_LOG_LEVEL_INFO, "Requested magnetic declination");
+  } else {
+    HUBBLE_LOG(APP_LOG_LEVEL_ERROR, "Failed to send declination request: %d", (int)result);
+  }
+#endif
+}
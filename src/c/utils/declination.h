@@ -0,0 +1,24 @@
+#pragma once
+
+#include <pebble.h>
+
+// Persisted declination is trusted for this long before the watch asks the phone again.
+// The phone also pushes a fresh value once per session, so this only matters offline.
+#define DECLINATION_MAX_AGE_S (30 * SECONDS_PER_DAY)
+
+// It is also stale once the observer (from the last sky snapshot) is more than this
+// many tenths of a degree of latitude or longitude from where it was computed.
+// Declination changes by well under a degree over that distance outside the polar regions.
+#define DECLINATION_MAX_MOVE_X10 20
+
+// Store a DECLINATION push from the phone if the message carries one.
+// Returns true if the message contained a declination.
+bool declination_handle_message(DictionaryIterator *iter);
+
+// True if a persisted declination exists, is younger than DECLINATION_MAX_AGE_S
+// and was computed near the current observer
+bool declination_is_fresh(void);
+
+// Ask the phone for a declination only if the persisted value is missing or stale.
+// Never blocks; the persisted value stays in use until a reply arrives.
+void declination_request_if_stale(void);
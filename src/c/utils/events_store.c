@@ -0,0 +1,216 @@
+#include "events_store.h"
+#include "logging.h"
+
+// Bump when the header or record layout changes; older tables are dropped
+#define EVENTS_STORE_VERSION 1
+
+// EVENTS_CHUNK payload: chunk index, chunk count (uint8), base minutes (uint32),
+// then per event type, body id (uint8) and minutes after the previous (uint16),
+// all little-endian. See src/pkjs/eventsync.js.
+#define EVENTS_CHUNK_HEADER_BYTES 6
+#define EVENTS_CHUNK_RECORD_BYTES 4
+
+typedef struct __attribute__((__packed__)) {
+  uint8_t version;
+  uint8_t head;             // Slot of the oldest record
+  uint8_t count;
+  uint32_t synced_minutes;  // 0 until the first commit
+} EventsHeader;
+
+// The ring is EVENTS_STORE_CAPACITY slots; slot / EVENTS_STORE_BLOCK_RECORDS is its block
+static EventRecord *s_records;
+static EventsHeader s_header;
+// Blocks changed since the last load or commit
+static uint8_t s_dirty_blocks;
+
+static bool s_sync_active;
+static uint8_t s_sync_next;
+static uint8_t s_sync_total;
+
+static uint16_t prv_slot(uint16_t index) {
+  return (s_header.head + index) % EVENTS_STORE_CAPACITY;
+}
+
+static void prv_load(void) {
+  memset(s_records, 0, sizeof(EventRecord) * EVENTS_STORE_CAPACITY);
+  memset(&s_header, 0, sizeof(s_header));
+  s_dirty_blocks = 0;
+  s_sync_active = false;
+
+  if (!persist_exists(EVENTS_STORE_HEADER_KEY) ||
+      persist_get_size(EVENTS_STORE_HEADER_KEY) != (int)sizeof(s_header)) {
+    return;
+  }
+  persist_read_data(EVENTS_STORE_HEADER_KEY, &s_header, sizeof(s_header));
+  if (s_header.version != EVENTS_STORE_VERSION || s_header.head >= EVENTS_STORE_CAPACITY ||
+      s_header.count > EVENTS_STORE_CAPACITY) {
+    HUBBLE_LOG(APP_LOG_LEVEL_WARNING, "Dropping events table version %d", s_header.version);
+    memset(&s_header, 0, sizeof(s_header));
+    return;
+  }
+
+  for (int block = 0; block < EVENTS_STORE_BLOCKS; block++) {
+    if (persist_exists(EVENTS_STORE_BLOCK_KEY + block)) {
+      persist_read_data(EVENTS_STORE_BLOCK_KEY + block,
+                        &s_records[block * EVENTS_STORE_BLOCK_RECORDS],
+                        sizeof(EventRecord) * EVENTS_STORE_BLOCK_RECORDS);
+    }
+  }
+}
+
+bool events_store_open(void) {
+  if (s_records) {
+    return true;
+  }
+  s_records = malloc(sizeof(EventRecord) * EVENTS_STORE_CAPACITY);
+  if (!s_records) {
+    HUBBLE_LOG(APP_LOG_LEVEL_ERROR, "Not enough memory for the events table");
+    return false;
+  }
+  prv_load();
+  HUBBLE_LOG(APP_LOG_LEVEL_INFO, "Loaded %d events", s_header.count);
+  return true;
+}
+
+void events_store_close(void) {
+  if (s_records) {
+    free(s_records);
+    s_records = NULL;
+  }
+  memset(&s_header, 0, sizeof(s_header));
+  s_dirty_blocks = 0;
+  s_sync_active = false;
+}
+
+uint16_t events_store_count(void) {
+  return s_records ? s_header.count : 0;
+}
+
+const EventRecord *events_store_get(uint16_t index) {
+  if (!s_records || index >= s_header.count) {
+    return NULL;
+  }
+  return &s_records[prv_slot(index)];
+}
+
+uint16_t events_store_first_upcoming(time_t now) {
+  const uint32_t now_minutes = (uint32_t)(now / 60);
+  uint16_t index = 0;
+  while (index < events_store_count() && s_records[prv_slot(index)].minutes < now_minutes) {
+    index++;
+  }
+  return index;
+}
+
+time_t events_store_synced_at(void) {
+  return (time_t)s_header.synced_minutes * 60;
+}
+
+// Forget every record at or after `minutes`; the sync is about to resend them
+static void prv_truncate_from(uint32_t minutes) {
+  uint16_t keep = 0;
+  while (keep < s_header.count && s_records[prv_slot(keep)].minutes < minutes) {
+    keep++;
+  }
+  s_header.count = keep;
+}
+
+// When full, the oldest record (long past by then) makes room
+static void prv_append(const EventRecord *record) {
+  uint16_t slot;
+  if (s_header.count < EVENTS_STORE_CAPACITY) {
+    slot = prv_slot(s_header.count);
+    s_header.count++;
+  } else {
+    slot = s_header.head;
+    s_header.head = (s_header.head + 1) % EVENTS_STORE_CAPACITY;
+  }
+  s_records[slot] = *record;
+  s_dirty_blocks |= (uint8_t)(1 << (slot / EVENTS_STORE_BLOCK_RECORDS));
+}
+
+bool events_store_handle_chunk(const uint8_t *data, uint16_t length) {
+  if (!s_records || length < EVENTS_CHUNK_HEADER_BYTES ||
+      (length - EVENTS_CHUNK_HEADER_BYTES) % EVENTS_CHUNK_RECORD_BYTES != 0) {
+    return false;
+  }
+
+  const uint8_t index = data[0];
+  const uint8_t total = data[1];
+  if (index == 0) {
+    // A fresh sync supersedes one that never finished
+    if (s_sync_active) {
+      prv_load();
+    }
+    s_sync_active = true;
+    s_sync_next = 0;
+    s_sync_total = total;
+  } else if (!s_sync_active || index != s_sync_next || total != s_sync_total) {
+    HUBBLE_LOG(APP_LOG_LEVEL_WARNING, "Events chunk %d out of order", index);
+    return false;
+  }
+
+  uint32_t minutes = (uint32_t)data[2] | ((uint32_t)data[3] << 8) |
+                     ((uint32_t)data[4] << 16) | ((uint32_t)data[5] << 24);
+  if (index == 0) {
+    prv_truncate_from(minutes);
+  }
+
+  for (uint16_t offset = EVENTS_CHUNK_HEADER_BYTES; offset < length;
+       offset += EVENTS_CHUNK_RECORD_BYTES) {
+    minutes += (uint32_t)data[offset + 2] | ((uint32_t)data[offset + 3] << 8);
+    // Types from a newer phone app are skipped; their deltas still count
+    if (data[offset] >= EventTypeCount) {
+      continue;
+    }
+    const EventRecord record = {
+      .minutes = minutes,
+      .type = data[offset],
+      .body_id = data[offset + 1],
+    };
+    prv_append(&record);
+  }
+
+  s_sync_next++;
+  return true;
+}
+
+bool events_store_commit(int32_t count) {
+  if (!s_records) {
+    return false;
+  }
+
+  if (!s_sync_active && count == 0) {
+    // Nothing enabled on the phone: nothing to list
+    s_header.count = 0;
+    s_header.head = 0;
+  } else if (!s_sync_active || s_sync_next != s_sync_total) {
+    HUBBLE_LOG(APP_LOG_LEVEL_WARNING, "Events sync incomplete: %d of %d chunks",
+               s_sync_next, s_sync_total);
+    events_store_revert();
+    return false;
+  }
+
+  for (int block = 0; block < EVENTS_STORE_BLOCKS; block++) {
+    if (s_dirty_blocks & (1 << block)) {
+      persist_write_data(EVENTS_STORE_BLOCK_KEY + block,
+                         &s_records[block * EVENTS_STORE_BLOCK_RECORDS],
+                         sizeof(EventRecord) * EVENTS_STORE_BLOCK_RECORDS);
+    }
+  }
+  s_header.version = EVENTS_STORE_VERSION;
+  s_header.synced_minutes = (uint32_t)(time(NULL) / 60);
+  persist_write_data(EVENTS_STORE_HEADER_KEY, &s_header, sizeof(s_header));
+
+  HUBBLE_LOG(APP_LOG_LEVEL_INFO, "Committed %d events, block mask 0x%x",
+             s_header.count, s_dirty_blocks);
+  s_dirty_blocks = 0;
+  s_sync_active = false;
+  return true;
+}
+
+void events_store_revert(void) {
+  if (s_records) {
+    prv_load();
+  }
+}
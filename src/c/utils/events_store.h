@@ -0,0 +1,70 @@
+#pragma once
+
+#include <pebble.h>
+
+// Persist keys: the ring header, then one key per block of records.
+// Settings use 1 and 5, heap stats 2 and 3, favorites 4; blocks take 7-10.
+#define EVENTS_STORE_HEADER_KEY 6
+#define EVENTS_STORE_BLOCK_KEY 7
+
+// Each block fits one persist value (40 records of 6 bytes, under the 256-byte limit)
+#define EVENTS_STORE_BLOCK_RECORDS 40
+#define EVENTS_STORE_BLOCKS 4
+#define EVENTS_STORE_CAPACITY (EVENTS_STORE_BLOCK_RECORDS * EVENTS_STORE_BLOCKS)
+
+// Order matches TYPES in src/pkjs/eventsync.js
+typedef enum {
+  EventTypeRise,
+  EventTypeSet,
+  EventTypeCivilDawn,
+  EventTypeCivilDusk,
+  EventTypeNauticalDawn,
+  EventTypeNauticalDusk,
+  EventTypeAstronomicalDawn,
+  EventTypeAstronomicalDusk,
+  EventTypeNoon,
+  EventTypeMidnight,
+  EventTypeMarchEquinox,
+  EventTypeJuneSolstice,
+  EventTypeSeptemberEquinox,
+  EventTypeDecemberSolstice,
+  EventTypeTransit,
+  EventTypeLunarEclipse,
+  EventTypeSolarEclipse,
+  EventTypePerigee,
+  EventTypeApogee,
+  EventTypeCount,
+} EventType;
+
+// Same layout in RAM and on flash
+typedef struct __attribute__((__packed__)) {
+  uint32_t minutes;  // Minutes since the Unix epoch
+  uint8_t type;      // EventType
+  uint8_t body_id;
+} EventRecord;
+
+// Load the table from flash; false if there isn't memory for it. Pair with close.
+bool events_store_open(void);
+// Free the table. A sync that wasn't committed is dropped; flash keeps the last one.
+void events_store_close(void);
+
+// Records in time order, oldest first
+uint16_t events_store_count(void);
+const EventRecord *events_store_get(uint16_t index);
+
+// Index of the first record at or after `now`, or events_store_count() if none
+uint16_t events_store_first_upcoming(time_t now);
+
+// When the last sync was committed, 0 if never
+time_t events_store_synced_at(void);
+
+// Apply one EVENTS_CHUNK payload. Chunk 0 replaces everything from its first event
+// onward; false if the chunk is malformed or out of order.
+bool events_store_handle_chunk(const uint8_t *data, uint16_t length);
+
+// Finish a sync that reported `count` events: write the changed blocks and the header.
+// False, and the sync is reverted, if chunks are missing.
+bool events_store_commit(int32_t count);
+
+// Drop an unfinished sync and return to what's on flash
+void events_store_revert(void);
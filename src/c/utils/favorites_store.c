@@ -0,0 +1,76 @@
+#include "favorites_store.h"
+#include "bitset.h"
+#include "settings.h"
+#include "logging.h"
+
+static uint8_t s_bits[BITSET_BYTES(FAVORITES_MAX_IDS)];
+static bool s_dirty;
+
+static void prv_save(void) {
+  persist_write_data(FAVORITES_KEY, s_bits, sizeof(s_bits));
+}
+
+void favorites_store_load(void) {
+  memset(s_bits, 0, sizeof(s_bits));
+  s_dirty = false;
+
+  if (persist_exists(FAVORITES_KEY)) {
+    // A shorter value from a smaller build still reads into the low ids
+    persist_read_data(FAVORITES_KEY, s_bits, sizeof(s_bits));
+    return;
+  }
+
+  // Favorites used to live in LocalSettings as one bit per built-in body
+  const uint32_t legacy = settings_get()->favorites;
+  for (int body_id = 0; body_id < 32; body_id++) {
+    bitset_assign(s_bits, body_id, (legacy >> body_id) & 1);
+  }
+  prv_save();
+  HUBBLE_LOG(APP_LOG_LEVEL_INFO, "Migrated favorites mask 0x%08lx", (unsigned long)legacy);
+}
+
+bool favorites_store_contains(int body_id) {
+  if (body_id < 0 || body_id >= FAVORITES_MAX_IDS) {
+    return false;
+  }
+  return bitset_test(s_bits, body_id);
+}
+
+void favorites_store_set(int body_id, bool favorite) {
+  if (body_id < 0 || body_id >= FAVORITES_MAX_IDS || favorites_store_contains(body_id) == favorite) {
+    return;
+  }
+  bitset_assign(s_bits, body_id, favorite);
+  // Toggling a few bodies in a row costs one write
+  s_dirty = true;
+  settings_schedule_flush();
+}
+
+void favorites_store_flush(void) {
+  if (!s_dirty) {
+    return;
+  }
+  s_dirty = false;
+  prv_save();
+}
+
+uint16_t favorites_store_count(void) {
+  uint16_t count = 0;
+  for (size_t i = 0; i < sizeof(s_bits); i++) {
+    for (uint8_t byte = s_bits[i]; byte; byte &= byte - 1) {
+      count++;
+    }
+  }
+  return count;
+}
+
+int favorites_store_next(int from) {
+  if (from < 0) {
+    from = 0;
+  }
+  if (from >= FAVORITES_MAX_IDS) {
+    return -1;
+  }
+  const uint16_t next = bitset_next(s_bits, FAVORITES_MAX_IDS, from);
+  return next < FAVORITES_MAX_IDS ? next : -1;
+}
@@ -0,0 +1,26 @@
+#pragma once
+
+#include <pebble.h>
+
+// Persist key; settings use 1 and 5, heap stats use 2 and 3, the events table 6-10
+#define FAVORITES_KEY 4
+
+// Room for the built-in bodies and the star catalog (64 bytes persisted)
+#define FAVORITES_MAX_IDS 512
+
+// Load favorites, moving the old 32-bit settings mask over on first run.
+// Call after settings_load().
+void favorites_store_load(void);
+
+bool favorites_store_contains(int body_id);
+
+// Mark or unmark a body. The write to flash is coalesced with settings_save()'s.
+void favorites_store_set(int body_id, bool favorite);
+
+// Write a pending change now; settings_flush() calls this
+void favorites_store_flush(void);
+
+uint16_t favorites_store_count(void);
+
+// First favorite body id at or after `from`, or -1 if there are no more
+int favorites_store_next(int from);
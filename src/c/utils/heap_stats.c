@@ -0,0 +1,192 @@
+#include "heap_stats.h"
+#include "bodymsg.h"
+#include "logging.h"
+
+// HEAP_STATS payload: version, site count, live used and free, then per site
+// peak_used, min_free (uint32), peak_stack, samples (uint16), all little-endian
+#define HEAP_STATS_FORMAT_VERSION 1
+#define HEAP_STATS_SITE_BYTES 12
+#define HEAP_STATS_PAYLOAD_SIZE (2 + 8 + HeapSiteCount * HEAP_STATS_SITE_BYTES)
+
+typedef struct {
+  uint8_t head;   // Next slot to write
+  uint8_t count;
+  HeapSample samples[HEAP_STATS_RING_SIZE];
+} HeapRing;
+
+static HeapMark s_marks[HeapSiteCount];
+static HeapRing s_ring;
+static uintptr_t s_stack_base;
+static bool s_dirty;
+
+static const char *const s_site_names[HeapSiteCount] = {
+  [HeapSiteHome] = "Home",
+  [HeapSiteFavorites] = "Favorites",
+  [HeapSiteEvents] = "Events",
+  [HeapSiteCatalog] = "Catalog",
+  [HeapSiteDetails] = "Details",
+  [HeapSiteLocator] = "Locator",
+  [HeapSiteImage] = "Image",
+  [HeapSiteMessage] = "Message",
+  [HeapSiteSkyMap] = "Sky Map",
+};
+
+static void prv_clear(void) {
+  memset(s_marks, 0, sizeof(s_marks));
+  for (int i = 0; i < HeapSiteCount; i++) {
+    s_marks[i].min_free = UINT32_MAX;
+  }
+  memset(&s_ring, 0, sizeof(s_ring));
+}
+
+// Values from an older layout (different site count) are dropped rather than misread
+static bool prv_read(uint32_t key, void *data, size_t size) {
+  if (!persist_exists(key) || persist_get_size(key) != (int)size) {
+    return false;
+  }
+  return persist_read_data(key, data, size) == (int)size;
+}
+
+void heap_stats_init(void) {
+  // Everything the app does runs in frames below this one
+  uint8_t marker;
+  s_stack_base = (uintptr_t)&marker;
+
+  prv_clear();
+  if (!prv_read(HEAP_STATS_MARKS_KEY, s_marks, sizeof(s_marks)) ||
+      !prv_read(HEAP_STATS_RING_KEY, &s_ring, sizeof(s_ring)) ||
+      s_ring.head >= HEAP_STATS_RING_SIZE || s_ring.count > HEAP_STATS_RING_SIZE) {
+    prv_clear();
+  }
+  s_dirty = false;
+}
+
+void heap_stats_deinit(void) {
+  // Flash is only written once per launch, and only if something was sampled
+  if (!s_dirty) {
+    return;
+  }
+  persist_write_data(HEAP_STATS_MARKS_KEY, s_marks, sizeof(s_marks));
+  persist_write_data(HEAP_STATS_RING_KEY, &s_ring, sizeof(s_ring));
+  s_dirty = false;
+}
+
+void heap_stats_record(HeapSite site, HeapEvent event) {
+  if (site >= HeapSiteCount) {
+    return;
+  }
+
+  uint8_t marker;
+  const uintptr_t here = (uintptr_t)&marker;
+  const uintptr_t depth = s_stack_base > here ? s_stack_base - here : 0;
+  const uint16_t stack = depth > UINT16_MAX ? UINT16_MAX : (uint16_t)depth;
+  const uint32_t used = (uint32_t)heap_bytes_used();
+  const uint32_t free_bytes = (uint32_t)heap_bytes_free();
+
+  HeapMark *mark = &s_marks[site];
+  if (used > mark->peak_used) {
+    mark->peak_used = used;
+  }
+  if (free_bytes < mark->min_free) {
+    mark->min_free = free_bytes;
+  }
+  if (stack > mark->peak_stack) {
+    mark->peak_stack = stack;
+  }
+  if (mark->samples < UINT16_MAX) {
+    mark->samples++;
+  }
+
+  s_ring.samples[s_ring.head] = (HeapSample){
+    .site = site,
+    .event = event,
+    .stack = stack,
+    .used = used,
+    .free = free_bytes,
+  };
+  s_ring.head = (s_ring.head + 1) % HEAP_STATS_RING_SIZE;
+  if (s_ring.count < HEAP_STATS_RING_SIZE) {
+    s_ring.count++;
+  }
+  s_dirty = true;
+}
+
+const HeapMark *heap_stats_get_mark(HeapSite site) {
+  return site < HeapSiteCount ? &s_marks[site] : NULL;
+}
+
+const char *heap_stats_site_name(HeapSite site) {
+  return site < HeapSiteCount ? s_site_names[site] : "?";
+}
+
+uint8_t heap_stats_get_sample_count(void) {
+  return s_ring.count;
+}
+
+const HeapSample *heap_stats_get_sample(uint8_t index) {
+  if (index >= s_ring.count) {
+    return NULL;
+  }
+  const uint8_t slot = (s_ring.head + HEAP_STATS_RING_SIZE - 1 - index) % HEAP_STATS_RING_SIZE;
+  return &s_ring.samples[slot];
+}
+
+void heap_stats_reset(void) {
+  prv_clear();
+  persist_delete(HEAP_STATS_MARKS_KEY);
+  persist_delete(HEAP_STATS_RING_KEY);
+  s_dirty = false;
+}
+
+static uint8_t *prv_put_u16(uint8_t *out, uint16_t value) {
+  out[0] = value & 0xFF;
+  out[1] = value >> 8;
+  return out + 2;
+}
+
+static uint8_t *prv_put_u32(uint8_t *out, uint32_t value) {
+  out = prv_put_u16(out, value & 0xFFFF);
+  return prv_put_u16(out, value >> 16);
+}
+
+bool heap_stats_send(void) {
+  if (!bodymsg_is_ready()) {
+    return false;
+  }
+
+  uint8_t payload[HEAP_STATS_PAYLOAD_SIZE];
+  uint8_t *out = payload;
+  *out++ = HEAP_STATS_FORMAT_VERSION;
+  *out++ = HeapSiteCount;
+  out = prv_put_u32(out, (uint32_t)heap_bytes_used());
+  out = prv_put_u32(out, (uint32_t)heap_bytes_free());
+  for (int i = 0; i < HeapSiteCount; i++) {
+    const HeapMark *mark = &s_marks[i];
+    out = prv_put_u32(out, mark->peak_used);
+    out = prv_put_u32(out, mark->samples ? mark->min_free : 0);
+    out = prv_put_u16(out, mark->peak_stack);
+    out = prv_put_u16(out, mark->samples);
+  }
+
+  DictionaryIterator *out_iter;
+  AppMessageResult result = app_message_outbox_begin(&out_iter);
+  if (result != APP_MSG_OK) {
+    HUBBLE_LOG(APP_LOG_LEVEL_ERROR, "Error preparing heap stats outbox: %d", (int)result);
+    return false;
+  }
+  dict_write_data(out_iter, MESSAGE_KEY_HEAP_STATS, payload, sizeof(payload));
+  result = app_message_outbox_send();
+  if (result != APP_MSG_OK) {
+    HUBBLE_LOG(APP_LOG_LEVEL_ERROR, "Error sending heap stats: %d", (int)result);
+    return false;
+  }
+  return true;
+}
+
+bool heap_stats_handle_message(DictionaryIterator *iter) {
+  if (!dict_find(iter, MESSAGE_KEY_REQUEST_HEAP_STATS)) {
+    return false;
+  }
+  heap_stats_send();
+  return true;
+}
@@ -0,0 +1,71 @@
+#pragma once
+
+#include <pebble.h>
+
+// Persist keys; see settings.h, favorites_store.h and events_store.h for the others
+#define HEAP_STATS_MARKS_KEY 2
+#define HEAP_STATS_RING_KEY 3
+
+// Recent samples kept across launches (12 bytes each, within one persist value)
+#define HEAP_STATS_RING_SIZE 16
+
+// Where a sample was taken; windows record on load and unload
+typedef enum {
+  HeapSiteHome = 0,
+  HeapSiteFavorites,
+  HeapSiteEvents,
+  HeapSiteCatalog,
+  HeapSiteDetails,
+  HeapSiteLocator,
+  HeapSiteImage,    // After an image cache load
+  HeapSiteMessage,  // After an inbox message was handled
+  HeapSiteSkyMap,
+  HeapSiteCount,
+} HeapSite;
+
+typedef enum {
+  HeapEventLoad = 0,
+  HeapEventUnload,
+  HeapEventSample,
+} HeapEvent;
+
+// High-water marks for one site, over every launch since the last reset
+typedef struct {
+  uint32_t peak_used;    // Highest heap_bytes_used()
+  uint32_t min_free;     // Lowest heap_bytes_free()
+  uint16_t peak_stack;   // Deepest stack seen at a sample point, in bytes
+  uint16_t samples;      // Saturates at UINT16_MAX
+} HeapMark;
+
+typedef struct {
+  uint8_t site;          // HeapSite
+  uint8_t event;         // HeapEvent
+  uint16_t stack;        // Stack depth below main's frame when sampled
+  uint32_t used;
+  uint32_t free;
+} HeapSample;
+
+// Load persisted marks and note the stack base; call first thing from main
+void heap_stats_init(void);
+// Write marks and the sample ring back to flash
+void heap_stats_deinit(void);
+
+// Sample the heap now and fold it into the site's high-water mark
+void heap_stats_record(HeapSite site, HeapEvent event);
+
+const HeapMark *heap_stats_get_mark(HeapSite site);
+const char *heap_stats_site_name(HeapSite site);
+
+// Samples in the ring, newest first (index 0)
+uint8_t heap_stats_get_sample_count(void);
+const HeapSample *heap_stats_get_sample(uint8_t index);
+
+// Forget all marks and samples, here and in flash
+void heap_stats_reset(void);
+
+// Send the marks to the phone as a HEAP_STATS byte array
+bool heap_stats_send(void);
+
+// Answer a REQUEST_HEAP_STATS from the phone if the message carries one.
+// Returns true if it did.
+bool heap_stats_handle_message(DictionaryIterator *iter);
@@ -0,0 +1,158 @@
+#include "image_cache.h"
+#include "heap_stats.h"
+#include "logging.h"
+
+// Aplite has ~24 KB of app heap in total, so keep only a few 1-bit heroes there and
+// leave a wide reserve for whatever window opens next
+#if defined(PBL_PLATFORM_APLITE)
+#define IMAGE_CACHE_MAX_ENTRIES 4
+#define IMAGE_CACHE_MAX_BYTES (3 * 1024)
+#define IMAGE_CACHE_IDLE_BYTES (1 * 1024)
+#define IMAGE_CACHE_HEAP_RESERVE (8 * 1024)
+#else
+#define IMAGE_CACHE_MAX_ENTRIES 8
+#define IMAGE_CACHE_MAX_BYTES (32 * 1024)
+#define IMAGE_CACHE_IDLE_BYTES IMAGE_CACHE_MAX_BYTES
+#define IMAGE_CACHE_HEAP_RESERVE (12 * 1024)
+#endif
+
+typedef struct {
+  uint32_t resource_id;
+  void *image;  // GBitmap or GDrawCommandImage, depending on is_pdc
+  bool is_pdc;
+  uint8_t refs;
+  uint16_t bytes;
+  uint32_t last_used;
+} ImageCacheEntry;
+
+static ImageCacheEntry s_entries[IMAGE_CACHE_MAX_ENTRIES];
+static uint8_t s_count = 0;
+static size_t s_total_bytes = 0;
+static uint32_t s_clock = 0;
+
+static void prv_destroy(uint8_t index) {
+  ImageCacheEntry *entry = &s_entries[index];
+  if (entry->is_pdc) {
+    gdraw_command_image_destroy(entry->image);
+  } else {
+    gbitmap_destroy(entry->image);
+  }
+  s_total_bytes -= entry->bytes;
+
+  // Order doesn't matter; fill the hole with the last entry
+  s_entries[index] = s_entries[--s_count];
+}
+
+// Drop the least recently used unreferenced image; false if every image is in use
+static bool prv_evict_lru(void) {
+  int16_t oldest = -1;
+  for (uint8_t i = 0; i < s_count; i++) {
+    if (s_entries[i].refs == 0 &&
+        (oldest < 0 || s_entries[i].last_used < s_entries[oldest].last_used)) {
+      oldest = i;
+    }
+  }
+  if (oldest < 0) {
+    return false;
+  }
+  HUBBLE_LOG(APP_LOG_LEVEL_DEBUG, "Image cache evicting resource %d", (int)s_entries[oldest].resource_id);
+  prv_destroy((uint8_t)oldest);
+  return true;
+}
+
+// The cache may grow while the heap keeps IMAGE_CACHE_HEAP_RESERVE free, up to the cap
+static size_t prv_budget(void) {
+  const int32_t budget = (int32_t)s_total_bytes + (int32_t)heap_bytes_free() - IMAGE_CACHE_HEAP_RESERVE;
+  if (budget <= 0) {
+    return 0;
+  }
+  return budget < IMAGE_CACHE_MAX_BYTES ? (size_t)budget : IMAGE_CACHE_MAX_BYTES;
+}
+
+static size_t prv_image_bytes(uint32_t resource_id, const void *image, bool is_pdc) {
+  if (is_pdc) {
+    // Draw commands are loaded verbatim from the resource
+    return resource_size(resource_get_handle(resource_id));
+  }
+  const GBitmap *bitmap = image;
+  return (size_t)gbitmap_get_bytes_per_row(bitmap) * gbitmap_get_bounds(bitmap).size.h;
+}
+
+static void *prv_load(uint32_t resource_id, bool is_pdc) {
+  if (is_pdc) {
+    return gdraw_command_image_create_with_resource(resource_id);
+  }
+  return gbitmap_create_with_resource(resource_id);
+}
+
+static void *prv_acquire(uint32_t resource_id, bool is_pdc) {
+  for (uint8_t i = 0; i < s_count; i++) {
+    ImageCacheEntry *entry = &s_entries[i];
+    if (entry->resource_id == resource_id && entry->is_pdc == is_pdc) {
+      entry->refs++;
+      entry->last_used = ++s_clock;
+      return entry->image;
+    }
+  }
+
+  if (s_count == IMAGE_CACHE_MAX_ENTRIES && !prv_evict_lru()) {
+    HUBBLE_LOG(APP_LOG_LEVEL_ERROR, "Image cache full of images in use");
+    return NULL;
+  }
+
+  void *image = prv_load(resource_id, is_pdc);
+  if (!image && s_count > 0) {
+    // Out of heap; give back everything that isn't on screen and try once more
+    image_cache_trim(0);
+    image = prv_load(resource_id, is_pdc);
+  }
+  heap_stats_record(HeapSiteImage, HeapEventSample);
+  if (!image) {
+    HUBBLE_LOG(APP_LOG_LEVEL_ERROR, "Failed to load image resource %d", (int)resource_id);
+    return NULL;
+  }
+
+  const size_t bytes = prv_image_bytes(resource_id, image, is_pdc);
+  s_entries[s_count++] = (ImageCacheEntry){
+    .resource_id = resource_id,
+    .image = image,
+    .is_pdc = is_pdc,
+    .refs = 1,
+    .bytes = bytes > UINT16_MAX ? UINT16_MAX : (uint16_t)bytes,
+    .last_used = ++s_clock,
+  };
+  s_total_bytes += s_entries[s_count - 1].bytes;
+
+  // The new image is referenced, so this only ever evicts older ones
+  while (s_total_bytes > prv_budget() && prv_evict_lru()) {
+  }
+  return image;
+}
+
+GBitmap *image_cache_acquire_bitmap(uint32_t resource_id) {
+  return prv_acquire(resource_id, false);
+}
+
+GDrawCommandImage *image_cache_acquire_pdc(uint32_t resource_id) {
+  return prv_acquire(resource_id, true);
+}
+
+void image_cache_release(uint32_t resource_id) {
+  for (uint8_t i = 0; i < s_count; i++) {
+    ImageCacheEntry *entry = &s_entries[i];
+    if (entry->resource_id == resource_id && entry->refs > 0) {
+      entry->refs--;
+      entry->last_used = ++s_clock;
+      return;
+    }
+  }
+}
+
+void image_cache_trim(size_t max_bytes) {
+  while (s_total_bytes > max_bytes && prv_evict_lru()) {
+  }
+}
+
+void image_cache_trim_idle(void) {
+  image_cache_trim(IMAGE_CACHE_IDLE_BYTES);
+}
@@ -0,0 +1,18 @@
+#pragma once
+
+#include <pebble.h>
+
+// Shared images keyed by resource id. An image stays cached after its last release,
+// and the least recently used ones go first when the heap gets tight, so repeat views
+// skip both the flash read and the allocation.
+
+// Callers borrow the returned image until they release the id; NULL if it can't load
+GBitmap *image_cache_acquire_bitmap(uint32_t resource_id);
+GDrawCommandImage *image_cache_acquire_pdc(uint32_t resource_id);
+void image_cache_release(uint32_t resource_id);
+
+// Free released images, oldest first, until the cache holds at most max_bytes
+void image_cache_trim(size_t max_bytes);
+
+// Trim to what this platform can afford to keep while no image window is open
+void image_cache_trim_idle(void);
@@ -0,0 +1,105 @@
+#include "moon_render.h"
+#include "sky.h"
+#include "logging.h"
+
+// 5° buckets move the terminator about two pixels across a 50px disc
+#define MOON_RENDER_BUCKETS 72
+#define MOON_RENDER_BUCKET_CDEG (MOON_PHASE_CDEG_MAX / MOON_RENDER_BUCKETS)
+
+static GBitmap *s_bitmap;
+static int16_t s_bucket = -1;
+static uint16_t s_diameter;
+static bool s_borrowed;
+
+#if defined(PBL_COLOR)
+static void prv_set_pixel(uint8_t *row, int16_t x, int16_t y, bool lit) {
+  // The unlit side is faintly visible, as it is by earthshine
+  row[x] = lit ? GColorWhite.argb : GColorDarkGray.argb;
+}
+#else
+static void prv_set_pixel(uint8_t *row, int16_t x, int16_t y, bool lit) {
+  // One bit per pixel: a sparse dither keeps the unlit side's outline readable
+  if (lit || ((x + 2 * y) & 3) == 0) {
+    row[x >> 3] |= (uint8_t)(1 << (x & 7));
+  }
+}
+#endif
+
+// Coordinates are doubled so pixel centres fall on integers: pixel i is at
+// 2i + 1 - diameter, and the disc's radius is diameter. Each row is lit from the
+// terminator, an ellipse with semi-axis w cos(phase), to the limb on the sunward side:
+// the right while waxing, the left while waning.
+static void prv_render(GBitmap *bitmap, uint16_t phase_cdeg, uint16_t diameter) {
+  uint8_t *data = gbitmap_get_data(bitmap);
+  const uint16_t stride = gbitmap_get_bytes_per_row(bitmap);
+  memset(data, 0, (size_t)stride * diameter);  // Transparent outside the disc
+
+  const int32_t cos_phase =
+      cos_lookup(((int32_t)phase_cdeg * (TRIG_MAX_ANGLE / 4)) / 9000);
+  const bool waxing = phase_cdeg < MOON_PHASE_CDEG_MAX / 2;
+  const int32_t radius = diameter;
+
+  for (int16_t y = 0; y < diameter; y++) {
+    uint8_t *row = data + (size_t)y * stride;
+    const int32_t dy = 2 * y + 1 - radius;
+    const int32_t half_width = sky_isqrt((uint32_t)(radius * radius - dy * dy));
+    const int32_t terminator = (half_width * cos_phase) / TRIG_MAX_RATIO;
+
+    for (int16_t x = 0; x < diameter; x++) {
+      const int32_t dx = 2 * x + 1 - radius;
+      if (dx < -half_width || dx > half_width) {
+        continue;
+      }
+      prv_set_pixel(row, x, y, waxing ? dx > terminator : dx < -terminator);
+    }
+  }
+}
+
+GBitmap *moon_render_acquire(uint16_t phase_cdeg, uint16_t diameter) {
+  if (s_borrowed || diameter == 0) {
+    return NULL;
+  }
+
+  const int16_t bucket =
+      ((phase_cdeg % MOON_PHASE_CDEG_MAX) + MOON_RENDER_BUCKET_CDEG / 2) / MOON_RENDER_BUCKET_CDEG %
+      MOON_RENDER_BUCKETS;
+  if (s_bitmap && s_bucket == bucket && s_diameter == diameter) {
+    s_borrowed = true;
+    return s_bitmap;
+  }
+
+  // A new size needs a new bitmap; a new phase redraws the one we have
+  if (s_bitmap && s_diameter != diameter) {
+    gbitmap_destroy(s_bitmap);
+    s_bitmap = NULL;
+  }
+  if (!s_bitmap) {
+    s_bitmap = gbitmap_create_blank(GSize(diameter, diameter),
+                                    PBL_IF_COLOR_ELSE(GBitmapFormat8Bit, GBitmapFormat1Bit));
+    if (!s_bitmap) {
+      HUBBLE_LOG(APP_LOG_LEVEL_ERROR, "Not enough memory for the moon bitmap");
+      s_bucket = -1;
+      return NULL;
+    }
+    s_diameter = diameter;
+  }
+
+  prv_render(s_bitmap, (uint16_t)(bucket * MOON_RENDER_BUCKET_CDEG), diameter);
+  s_bucket = bucket;
+  s_borrowed = true;
+  return s_bitmap;
+}
+
+void moon_render_release(void) {
+  s_borrowed = false;
+}
+
+void moon_render_trim_idle(void) {
+#if defined(PBL_PLATFORM_APLITE)
+  if (s_bitmap && !s_borrowed) {
+    gbitmap_destroy(s_bitmap);
+    s_bitmap = NULL;
+    s_bucket = -1;
+  }
+#endif
+}
@@ -0,0 +1,18 @@
+#pragma once
+
+#include <pebble.h>
+
+// The Moon's disc drawn for a phase angle instead of loaded from artwork. The
+// terminator is rendered with integer math into a bitmap, and the last bitmap is
+// kept so views of the same phase bucket skip the render.
+
+// Phase angle in hundredths of a degree: 0 new, 9000 first quarter, 18000 full
+#define MOON_PHASE_CDEG_MAX 36000
+
+// Borrow a bitmap of the Moon at phase_cdeg, diameter pixels across. NULL if it
+// couldn't be allocated. Only one may be borrowed at a time.
+GBitmap *moon_render_acquire(uint16_t phase_cdeg, uint16_t diameter);
+void moon_render_release(void);
+
+// Free the kept bitmap where the platform can't spare it between views
+void moon_render_trim_idle(void);
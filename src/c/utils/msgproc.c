@@ -1,5 +1,8 @@
 #include "msgproc.h"
 #include "body_info.h"
+#include "star_catalog.h"
+#include "constellation_figure.h"
+#include "moon_render.h"
 #include <string.h>
 
 // BodyPackage bit field layout constants
@@ -12,6 +15,15 @@
 #define SET_MINUTE_BITS 6
 #define LUMINANCE_BITS 9
 #define PHASE_BITS 3
+#define PHASE_BIN_CDEG (MOON_PHASE_CDEG_MAX / 8)
+
+// BodyEquatorial is three little-endian 16-bit fields
+#define BODY_EQUATORIAL_LENGTH 6
+#define HOUR_ANGLE_CDEG_MAX 36000
+
+// Catalog bodies don't fit the 5-bit body id; the phone answers a REQUEST_FIXED
+// with this id and the watch fills in the id it asked for
+#define BODY_ID_CATALOG_OBJECT 31
 
 // Sentinel values for invalid times
 #define SENTINEL_HOUR 31
@@ -29,18 +41,6 @@ static const char* MOON_PHASES[] = {
     "Waning Crescent"
 };
 
-// Resource IDs for Moon phases
-static const uint32_t MOON_PHASE_RESOURCE_IDS[] = {
-    RESOURCE_ID_NEW_MOON,
-    RESOURCE_ID_WAXING_CRESCENT,
-    RESOURCE_ID_FIRST_QUARTER,
-    RESOURCE_ID_WAXING_GIBBOUS,
-    RESOURCE_ID_FULL_MOON,
-    RESOURCE_ID_WANING_GIBBOUS,
-    RESOURCE_ID_THIRD_QUARTER,
-    RESOURCE_ID_WANING_CRESCENT
-};
-
 // Static buffers for formatted strings
 static char s_rise_time_buffer[16];
 static char s_set_time_buffer[16];
@@ -79,7 +79,8 @@ static int32_t decode_signed(uint32_t value, int bits) {
     return (int32_t)value;
 }
 
-bool msgproc_unpack_body_package(const uint8_t *data, size_t length, DetailsContent *content) {
+bool msgproc_unpack_body_package(const uint8_t *data, size_t length, int requested_id,
+                                 DetailsContent *content) {
     if (!data || length != 7 || !content) {
         return false;
     }
@@ -88,7 +89,13 @@ bool msgproc_unpack_body_package(const uint8_t *data, size_t length, DetailsCont
 
     // Read body ID (5 bits)
     uint32_t body_id = read_bits(data, length, &bit_pos, BODY_ID_BITS);
-    if ((int)body_id >= NUM_BODIES) {
+    bool is_catalog = (body_id == BODY_ID_CATALOG_OBJECT);
+    if (is_catalog) {
+        if (!star_catalog_is_body(requested_id)) {
+            return false;
+        }
+        body_id = requested_id;
+    } else if ((int)body_id >= NUM_BODIES) {
         return false;
     }
 
@@ -115,19 +122,23 @@ bool msgproc_unpack_body_package(const uint8_t *data, size_t length, DetailsCont
     int32_t luminance_x10 = decode_signed(lum_raw, LUMINANCE_BITS);
 
     // Get body name and resource ID
-    const char *body_name = body_info_get_name(body_id);
-    if (!body_name) {
+    char body_name[STAR_CATALOG_NAME_SIZE];
+    if (!body_info_copy_name(body_id, body_name, sizeof(body_name))) {
         return false;
     }
     
     // Determine body characteristics
     bool is_moon = (body_id == 0);
-    bool can_have_rise_set = (body_id <= 9);  // Moon (0), planets (1-8), and Sun (9)
+    // Moon (0), planets (1-8), the Sun (9) and catalog stars and deep-sky objects
+    bool can_have_rise_set = (body_id <= 9) || is_catalog;
 
     uint32_t resource_id;
-    if (is_moon && phase < sizeof(MOON_PHASE_RESOURCE_IDS)/sizeof(MOON_PHASE_RESOURCE_IDS[0])) {
-        // For Moon, use phase-specific resource ID
-        resource_id = MOON_PHASE_RESOURCE_IDS[phase];
+    if (is_catalog) {
+        // No artwork for individual stars
+        resource_id = 0;
+    } else if (is_moon) {
+        // The Moon is rendered for its phase angle
+        resource_id = 0;
     } else {
         // For planets and other bodies, use the default resource ID
         resource_id = body_info_get_resource_id(body_id);
@@ -177,14 +188,47 @@ bool msgproc_unpack_body_package(const uint8_t *data, size_t length, DetailsCont
     
     content->image_resource_id = resource_id;
 
-    // Determine image type (planets use bitmap, others use PDC)
-    content->image_type = (body_id > 8) ? DETAILS_IMAGE_TYPE_PDC : DETAILS_IMAGE_TYPE_BITMAP;
+    // Determine image type (planets use bitmap, the Moon and constellations are drawn, others use PDC)
+    if (is_moon) {
+        content->image_type = DETAILS_IMAGE_TYPE_MOON;
+    } else if (constellation_figure_exists(body_id)) {
+        content->image_type = DETAILS_IMAGE_TYPE_FIGURE;
+    } else {
+        content->image_type = (body_id > 8) ? DETAILS_IMAGE_TYPE_PDC : DETAILS_IMAGE_TYPE_BITMAP;
+    }
 
     // Store raw azimuth and altitude for locator functionality
     content->azimuth_deg = (int16_t)azimuth;
     content->altitude_deg = (int16_t)altitude;
     content->illumination_x10 = (int16_t)luminance_x10;
+    // Middle of the phase bin until the exact angle arrives alongside
+    content->moon_phase_cdeg = is_moon ? (uint16_t)(phase * PHASE_BIN_CDEG) : 0;
+
+    return true;
+}
+
+static uint16_t read_u16_le(const uint8_t *data) {
+    return (uint16_t)(data[0] | (data[1] << 8));
+}
+
+bool msgproc_unpack_body_equatorial(const uint8_t *data, size_t length, TargetTrack *track) {
+    if (!data || length != BODY_EQUATORIAL_LENGTH || !track) {
+        return false;
+    }
+
+    const uint16_t hour_angle = read_u16_le(&data[0]);
+    const int16_t declination = (int16_t)read_u16_le(&data[2]);
+    const int16_t latitude = (int16_t)read_u16_le(&data[4]);
+
+    if (hour_angle >= HOUR_ANGLE_CDEG_MAX || declination < -9000 || declination > 9000 ||
+        latitude < -9000 || latitude > 9000) {
+        return false;
+    }
 
+    track->hour_angle_cdeg = hour_angle;
+    track->declination_cdeg = declination;
+    track->latitude_cdeg = latitude;
+    track->epoch = time(NULL);
     return true;
 }
 
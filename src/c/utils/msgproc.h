@@ -5,7 +5,13 @@
 
 // Unpack a BodyPackage (8-byte array) into a DetailsContent structure
 // Returns true on success, false on failure
-bool msgproc_unpack_body_package(const uint8_t *data, size_t length, DetailsContent *content);
+// requested_id resolves catalog objects, which the package can't identify itself
+bool msgproc_unpack_body_package(const uint8_t *data, size_t length, int requested_id,
+                                 DetailsContent *content);
+
+// Unpack a BodyEquatorial (6-byte array) into a TargetTrack stamped with the current time
+// Returns true on success, false on failure
+bool msgproc_unpack_body_equatorial(const uint8_t *data, size_t length, TargetTrack *track);
 
 // Helper function to format time strings for rise/set display
 // Formats into the provided buffer and returns a pointer to it
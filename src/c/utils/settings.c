@@ -1,23 +1,165 @@
 #include "settings.h"
+#include "favorites_store.h"
+#include "logging.h"
 
+// Bump when the record changes, and teach prv_read_record to upgrade the old one
+#define SETTINGS_VERSION 1
+
+// Toggles and phone pushes tend to arrive in bursts; one write covers the burst
+#define SETTINGS_FLUSH_DELAY_MS 5000
+
+// On-flash layout, packed so it doesn't depend on the compiler's padding
+typedef struct __attribute__((__packed__)) {
+    uint8_t version;
+    int16_t magnetic_declination;
+    int16_t declination_lat_x10;
+    int16_t declination_lon_x10;
+    uint32_t declination_timestamp;
+    int16_t magnetic_inclination;
+    uint8_t background_compass;
+} SettingsRecord;
+
+// What released builds before the versioned record wrote to SETTINGS_LEGACY_KEY.
+// The fields added since were never shipped under that key, so they keep their defaults.
+typedef struct {
+    uint32_t favorites;
+    int16_t magnetic_declination;
+} LegacySettings;
+
+static LocalSettings settings;
+// Last record written to or read from flash, so a flush can tell if anything changed
+static SettingsRecord s_stored;
+static bool s_dirty;
+static bool s_legacy_pending;
+static AppTimer *s_flush_timer;
 
 LocalSettings* settings_get() {
     return &settings;
 }
 
+static void prv_to_record(SettingsRecord *record) {
+    *record = (SettingsRecord){
+        .version = SETTINGS_VERSION,
+        .magnetic_declination = settings.magnetic_declination,
+        .declination_lat_x10 = settings.declination_lat_x10,
+        .declination_lon_x10 = settings.declination_lon_x10,
+        .declination_timestamp = settings.declination_timestamp,
+        .magnetic_inclination = settings.magnetic_inclination,
+        .background_compass = settings.background_compass,
+    };
+}
+
+static void prv_from_record(const SettingsRecord *record) {
+    settings.magnetic_declination = record->magnetic_declination;
+    settings.declination_lat_x10 = record->declination_lat_x10;
+    settings.declination_lon_x10 = record->declination_lon_x10;
+    settings.declination_timestamp = record->declination_timestamp;
+    settings.magnetic_inclination = record->magnetic_inclination;
+    settings.background_compass = record->background_compass;
+}
+
+// False if the record is missing or from a newer build, leaving the defaults in place
+static bool prv_read_record(void) {
+    if (!persist_exists(SETTINGS_KEY)) {
+        return false;
+    }
+
+    SettingsRecord record;
+    memset(&record, 0, sizeof(record));
+    persist_read_data(SETTINGS_KEY, &record, sizeof(record));
+    switch (record.version) {
+        case SETTINGS_VERSION:
+            prv_from_record(&record);
+            return true;
+        default:
+            HUBBLE_LOG(APP_LOG_LEVEL_WARNING, "Unknown settings version %d", record.version);
+            return false;
+    }
+}
+
+static void prv_read_legacy(void) {
+    LegacySettings legacy = {
+        .favorites = settings.favorites,
+        .magnetic_declination = settings.magnetic_declination,
+    };
+    // A shorter value leaves the rest at the defaults rather than stack garbage
+    persist_read_data(SETTINGS_LEGACY_KEY, &legacy, sizeof(legacy));
+
+    // With no timestamp or location the declination reads as stale until the phone resends it
+    settings.favorites = legacy.favorites;
+    settings.magnetic_declination = legacy.magnetic_declination;
+    HUBBLE_LOG(APP_LOG_LEVEL_INFO, "Migrating unversioned settings");
+}
+
+static void prv_flush_timer_callback(void *context) {
+    s_flush_timer = NULL;
+    settings_flush();
+}
+
+void settings_schedule_flush(void) {
+    // The first change of a burst sets the deadline; later ones ride along
+    if (!s_flush_timer) {
+        s_flush_timer = app_timer_register(SETTINGS_FLUSH_DELAY_MS, prv_flush_timer_callback, NULL);
+    }
+}
+
 void settings_save() {
-    persist_write_data(SETTINGS_KEY, &settings, sizeof(settings));
+    s_dirty = true;
+    settings_schedule_flush();
+}
+
+void settings_flush(void) {
+    if (s_flush_timer) {
+        app_timer_cancel(s_flush_timer);
+        s_flush_timer = NULL;
+    }
+    favorites_store_flush();
+    if (!s_dirty) {
+        return;
+    }
+    s_dirty = false;
+
+    SettingsRecord record;
+    prv_to_record(&record);
+    if (memcmp(&record, &s_stored, sizeof(record)) != 0 || s_legacy_pending) {
+        persist_write_data(SETTINGS_KEY, &record, sizeof(record));
+        s_stored = record;
+        HUBBLE_LOG(APP_LOG_LEVEL_DEBUG, "Settings written");
+    }
+    // Only drop the old record once the new one is on flash
+    if (s_legacy_pending) {
+        persist_delete(SETTINGS_LEGACY_KEY);
+        s_legacy_pending = false;
+    }
 }
 
 void settings_load_default() {
     settings.favorites = 0; // all off
     settings.magnetic_declination = 255; // probably impossible declination value
+    settings.declination_lat_x10 = 0;
+    settings.declination_lon_x10 = 0;
+    settings.declination_timestamp = 0; // never received, always stale
+    settings.magnetic_inclination = 255; // unknown until the phone sends it
+    settings.background_compass = 0; // worker is opt-in
 }
 
 void settings_load() {
     settings_load_default();
 
-    if(!persist_exists(SETTINGS_KEY)) return;
+    if (prv_read_record()) {
+        prv_to_record(&s_stored);
+        return;
+    }
 
-    persist_read_data(SETTINGS_KEY, &settings, sizeof(settings));
-}
\ No newline at end of file
+    // Anything that isn't on flash yet counts as changed
+    memset(&s_stored, 0, sizeof(s_stored));
+    if (persist_exists(SETTINGS_LEGACY_KEY)) {
+        prv_read_legacy();
+        s_legacy_pending = true;
+        settings_save();
+    }
+}
+
+void settings_deinit(void) {
+    settings_flush();
+}
@@ -2,16 +2,34 @@
 
 #include <pebble.h>
 
-#define SETTINGS_KEY 1
+// Persist keys: the versioned settings record, and the unversioned struct older
+// builds wrote, which is migrated on first load and then deleted
+#define SETTINGS_KEY 5
+#define SETTINGS_LEGACY_KEY 1
 
 typedef struct LocalSettings{
-    uint32_t favorites;  // on/off for each of up to 32 favorites
+    uint32_t favorites;  // legacy favorites mask, only set on the launch that migrates key 1
     int16_t magnetic_declination; // magnetic declination in degrees
+    int16_t declination_lat_x10; // latitude the declination was computed for, in tenths of a degree
+    int16_t declination_lon_x10; // longitude the declination was computed for, in tenths of a degree
+    uint32_t declination_timestamp; // unix time the declination was computed, 0 if never
+    int16_t magnetic_inclination; // magnetic dip in degrees, positive downward
+    uint8_t background_compass; // 1 to run the background compass worker
 } LocalSettings;
 
-static LocalSettings settings;
-
+// The one copy every module reads and writes; call settings_save() after changing it
 LocalSettings* settings_get();
 void settings_load_default();
+void settings_load();
+
+// Mark the settings changed. Writes within SETTINGS_FLUSH_DELAY_MS of the first are
+// coalesced into one flush, which is skipped if nothing differs from flash.
 void settings_save();
-void settings_load();
\ No newline at end of file
+
+// Arm the same coalesced flush without marking the settings themselves changed;
+// for stores that write on this path, like favorites
+void settings_schedule_flush(void);
+
+// Write pending changes, favorites included, now; also called from settings_deinit()
+void settings_flush(void);
+void settings_deinit(void);
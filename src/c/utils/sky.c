@@ -0,0 +1,340 @@
+#include "sky.h"
+#include "logging.h"
+#include <string.h>
+
+// Sidereal rate: 15.0411 degrees per hour, in hundredths of a degree per 100000 s
+#define SKY_SIDEREAL_CDEG_PER_100KS 41781
+// Hour angle drift stays well inside int32 math for this long
+#define SKY_MAX_AGE_S (12 * SECONDS_PER_HOUR)
+// Trig lookups are Q16; propagation runs in Q14
+#define SKY_Q_BITS 14
+#define SKY_Q_SHIFT 2
+
+// SKY_SNAPSHOT: latitude (int16 LE, hundredths of a degree), local sidereal
+// time (uint16 LE, hundredths of a degree) and longitude (int16 LE, hundredths of
+// a degree, east positive), then per body id (uint8), hour angle (uint16 LE) and
+// declination (int16 LE)
+#define SKY_HEADER_BYTES 6
+#define SKY_RECORD_BYTES 5
+
+// Nearest-object grid: 30° declination bands by 30° hour angle sectors, keyed on the
+// hour angle at the snapshot epoch. A body outside the pointing cell's neighbours is
+// always more than ~14.6° away (the worst case is just below a polar band), which
+// keeps SKY_NEAREST_MAX_DEG safe. The polar bands are scanned whole.
+#define SKY_GRID_BANDS 6
+#define SKY_GRID_SECTORS 12
+#define SKY_GRID_CELLS (SKY_GRID_BANDS * SKY_GRID_SECTORS)
+#define SKY_GRID_CELL_CDEG 3000
+
+typedef struct {
+  uint8_t body_id;
+  uint16_t hour_angle_cdeg;
+  int16_t declination_cdeg;
+  // Q14 unit vector in the epoch equatorial frame (x toward the meridian, y west, z north)
+  int16_t x;
+  int16_t y;
+  int16_t z;
+} SkyObject;
+
+static SkyObject s_objects[SKY_MAX_OBJECTS];
+static uint8_t s_count = 0;
+static int16_t s_latitude_cdeg = 0;
+static int16_t s_longitude_cdeg = 0;
+static uint16_t s_sidereal_cdeg = 0;
+static int32_t s_sin_lat = 0;
+static int32_t s_cos_lat = 0;
+static time_t s_epoch = 0;
+
+// Counting-sorted object indices; cell c holds s_grid_order[s_grid_start[c]..s_grid_start[c + 1])
+static uint8_t s_grid_start[SKY_GRID_CELLS + 1];
+static uint8_t s_grid_order[SKY_MAX_OBJECTS];
+
+int32_t sky_isqrt(uint32_t value) {
+  uint32_t result = 0;
+  uint32_t bit = 1UL << 30;
+  while (bit > value) {
+    bit >>= 2;
+  }
+  while (bit != 0) {
+    if (value >= result + bit) {
+      value -= result + bit;
+      result = (result >> 1) + bit;
+    } else {
+      result >>= 1;
+    }
+    bit >>= 2;
+  }
+  return (int32_t)result;
+}
+
+static int32_t prv_cdeg_to_trig(int32_t cdeg) {
+  return (cdeg * (TRIG_MAX_ANGLE / 4)) / 9000;
+}
+
+static uint16_t prv_read_u16_le(const uint8_t *data) {
+  return (uint16_t)(data[0] | (data[1] << 8));
+}
+
+// How far hour angles have advanced since epoch, in hundredths of a degree
+static int32_t prv_sidereal_drift_cdeg(time_t epoch, time_t now) {
+  int32_t age_s = (int32_t)(now - epoch);
+  if (age_s < 0) {
+    age_s = 0;
+  } else if (age_s > SKY_MAX_AGE_S) {
+    age_s = SKY_MAX_AGE_S;
+  }
+  return (age_s * SKY_SIDEREAL_CDEG_PER_100KS) / 100000;
+}
+
+void sky_track_to_horizontal(const TargetTrack *track, time_t now,
+                             int16_t *altitude_deg, int16_t *azimuth_deg) {
+  const int32_t hour_angle_cdeg =
+      (track->hour_angle_cdeg + prv_sidereal_drift_cdeg(track->epoch, now)) % 36000;
+
+  const int32_t hour_angle = prv_cdeg_to_trig(hour_angle_cdeg);
+  const int32_t declination = prv_cdeg_to_trig(track->declination_cdeg);
+  const int32_t latitude = prv_cdeg_to_trig(track->latitude_cdeg);
+
+  // Q14 ratios so products fit in int32 and results fit atan2_lookup's int16 arguments
+  const int32_t sin_ha = sin_lookup(hour_angle) >> SKY_Q_SHIFT;
+  const int32_t cos_ha = cos_lookup(hour_angle) >> SKY_Q_SHIFT;
+  const int32_t sin_dec = sin_lookup(declination) >> SKY_Q_SHIFT;
+  const int32_t cos_dec = cos_lookup(declination) >> SKY_Q_SHIFT;
+  const int32_t sin_lat = sin_lookup(latitude) >> SKY_Q_SHIFT;
+  const int32_t cos_lat = cos_lookup(latitude) >> SKY_Q_SHIFT;
+
+  const int32_t cos_dec_cos_ha = (cos_dec * cos_ha) >> SKY_Q_BITS;
+  const int32_t up = ((sin_lat * sin_dec) >> SKY_Q_BITS) + ((cos_lat * cos_dec_cos_ha) >> SKY_Q_BITS);
+  const int32_t north = ((sin_dec * cos_lat) >> SKY_Q_BITS) - ((cos_dec_cos_ha * sin_lat) >> SKY_Q_BITS);
+  const int32_t east = -((cos_dec * sin_ha) >> SKY_Q_BITS);
+  const int32_t horizontal = sky_isqrt((uint32_t)(north * north + east * east));
+
+  int32_t altitude = TRIGANGLE_TO_DEG(atan2_lookup(up, horizontal));
+  if (altitude > 180) {
+    altitude -= 360;
+  }
+  int32_t azimuth = TRIGANGLE_TO_DEG(atan2_lookup(east, north));
+  if (azimuth < 0) {
+    azimuth += 360;
+  } else if (azimuth >= 360) {
+    azimuth -= 360;
+  }
+
+  *altitude_deg = (int16_t)altitude;
+  *azimuth_deg = (int16_t)azimuth;
+}
+
+bool sky_request_snapshot(void) {
+  DictionaryIterator *out_iter;
+  AppMessageResult result = app_message_outbox_begin(&out_iter);
+  if (result != APP_MSG_OK) {
+    HUBBLE_LOG(APP_LOG_LEVEL_ERROR, "Failed to begin outbox for sky request: %d", (int)result);
+    return false;
+  }
+
+  // Value doesn't matter, just the key
+  int dummy_value = 1;
+  dict_write_int(out_iter, MESSAGE_KEY_REQUEST_SKY, &dummy_value, sizeof(int), true);
+
+  result = app_message_outbox_send();
+  if (result != APP_MSG_OK) {
+    HUBBLE_LOG(APP_LOG_LEVEL_ERROR, "Failed to send sky request: %d", (int)result);
+    return false;
+  }
+
+  HUBBLE_LOG(APP_LOG_LEVEL_INFO, "Requested sky snapshot");
+  return true;
+}
+
+static uint8_t prv_grid_cell(int16_t declination_cdeg, uint16_t hour_angle_cdeg) {
+  int32_t band = (declination_cdeg + 9000) / SKY_GRID_CELL_CDEG;
+  if (band < 0) {
+    band = 0;
+  } else if (band >= SKY_GRID_BANDS) {
+    band = SKY_GRID_BANDS - 1;
+  }
+  return (uint8_t)(band * SKY_GRID_SECTORS + hour_angle_cdeg / SKY_GRID_CELL_CDEG);
+}
+
+// Unit vectors and the cell index are rebuilt once per snapshot, never per lookup
+static void prv_build_grid(void) {
+  const int32_t latitude = prv_cdeg_to_trig(s_latitude_cdeg);
+  s_sin_lat = sin_lookup(latitude) >> SKY_Q_SHIFT;
+  s_cos_lat = cos_lookup(latitude) >> SKY_Q_SHIFT;
+
+  uint8_t cells[SKY_MAX_OBJECTS];
+  memset(s_grid_start, 0, sizeof(s_grid_start));
+
+  for (uint8_t i = 0; i < s_count; i++) {
+    SkyObject *object = &s_objects[i];
+    const int32_t hour_angle = prv_cdeg_to_trig(object->hour_angle_cdeg);
+    const int32_t declination = prv_cdeg_to_trig(object->declination_cdeg);
+    const int32_t cos_dec = cos_lookup(declination) >> SKY_Q_SHIFT;
+    object->x = (int16_t)((cos_dec * (cos_lookup(hour_angle) >> SKY_Q_SHIFT)) >> SKY_Q_BITS);
+    object->y = (int16_t)((cos_dec * (sin_lookup(hour_angle) >> SKY_Q_SHIFT)) >> SKY_Q_BITS);
+    object->z = (int16_t)(sin_lookup(declination) >> SKY_Q_SHIFT);
+
+    cells[i] = prv_grid_cell(object->declination_cdeg, object->hour_angle_cdeg);
+    s_grid_start[cells[i] + 1]++;
+  }
+
+  for (uint8_t cell = 0; cell < SKY_GRID_CELLS; cell++) {
+    s_grid_start[cell + 1] += s_grid_start[cell];
+  }
+
+  uint8_t fill[SKY_GRID_CELLS];
+  memcpy(fill, s_grid_start, sizeof(fill));
+  for (uint8_t i = 0; i < s_count; i++) {
+    s_grid_order[fill[cells[i]]++] = i;
+  }
+}
+
+bool sky_handle_message(DictionaryIterator *iter) {
+  Tuple *tuple = dict_find(iter, MESSAGE_KEY_SKY_SNAPSHOT);
+  if (!tuple) {
+    return false;
+  }
+
+  if (tuple->type != TUPLE_BYTE_ARRAY || tuple->length < SKY_HEADER_BYTES ||
+      (tuple->length - SKY_HEADER_BYTES) % SKY_RECORD_BYTES != 0) {
+    HUBBLE_LOG(APP_LOG_LEVEL_ERROR, "Invalid sky snapshot length: %d", (int)tuple->length);
+    return true;
+  }
+
+  const uint8_t *data = tuple->value->data;
+  const uint16_t records = (tuple->length - SKY_HEADER_BYTES) / SKY_RECORD_BYTES;
+
+  s_latitude_cdeg = (int16_t)prv_read_u16_le(data);
+  s_sidereal_cdeg = prv_read_u16_le(data + 2) % 36000;
+  s_longitude_cdeg = (int16_t)prv_read_u16_le(data + 4);
+  s_epoch = time(NULL);
+  s_count = 0;
+
+  for (uint16_t i = 0; i < records && s_count < SKY_MAX_OBJECTS; i++) {
+    const uint8_t *record = data + SKY_HEADER_BYTES + i * SKY_RECORD_BYTES;
+    const uint16_t hour_angle = prv_read_u16_le(record + 1);
+    if (record[0] >= SKY_MAX_OBJECTS || hour_angle >= 36000) {
+      continue;
+    }
+
+    s_objects[s_count].body_id = record[0];
+    s_objects[s_count].hour_angle_cdeg = hour_angle;
+    s_objects[s_count].declination_cdeg = (int16_t)prv_read_u16_le(record + 3);
+    s_count++;
+  }
+
+  prv_build_grid();
+
+  HUBBLE_LOG(APP_LOG_LEVEL_INFO, "Stored sky snapshot with %d bodies", (int)s_count);
+  return true;
+}
+
+bool sky_snapshot_is_fresh(void) {
+  return s_epoch != 0 && time(NULL) - s_epoch < SKY_SNAPSHOT_MAX_AGE_S;
+}
+
+bool sky_get_sidereal(time_t now, uint16_t *sidereal_cdeg, int16_t *latitude_cdeg) {
+  if (s_epoch == 0) {
+    return false;
+  }
+  *sidereal_cdeg = (uint16_t)((s_sidereal_cdeg + prv_sidereal_drift_cdeg(s_epoch, now)) % 36000);
+  *latitude_cdeg = s_latitude_cdeg;
+  return true;
+}
+
+bool sky_get_observer(int16_t *latitude_cdeg, int16_t *longitude_cdeg) {
+  if (s_epoch == 0) {
+    return false;
+  }
+  *latitude_cdeg = s_latitude_cdeg;
+  *longitude_cdeg = s_longitude_cdeg;
+  return true;
+}
+
+uint8_t sky_get_count(void) {
+  return s_count;
+}
+
+bool sky_get_object(uint8_t index, time_t now, uint8_t *body_id,
+                    int16_t *altitude_deg, int16_t *azimuth_deg) {
+  if (index >= s_count) {
+    return false;
+  }
+
+  const TargetTrack track = {
+    .hour_angle_cdeg = s_objects[index].hour_angle_cdeg,
+    .declination_cdeg = s_objects[index].declination_cdeg,
+    .latitude_cdeg = s_latitude_cdeg,
+    .epoch = s_epoch,
+  };
+  *body_id = s_objects[index].body_id;
+  sky_track_to_horizontal(&track, now, altitude_deg, azimuth_deg);
+  return true;
+}
+
+bool sky_find_nearest(int16_t altitude_deg, int16_t azimuth_deg, time_t now, uint8_t *body_id) {
+  if (s_count == 0) {
+    return false;
+  }
+
+  // Pointing direction as a Q14 unit vector in the observer's equatorial frame
+  const int32_t altitude = DEG_TO_TRIGANGLE(altitude_deg);
+  const int32_t azimuth = DEG_TO_TRIGANGLE(azimuth_deg);
+  const int32_t cos_alt = cos_lookup(altitude) >> SKY_Q_SHIFT;
+  const int32_t up = sin_lookup(altitude) >> SKY_Q_SHIFT;
+  const int32_t north = (cos_alt * (cos_lookup(azimuth) >> SKY_Q_SHIFT)) >> SKY_Q_BITS;
+  const int32_t east = (cos_alt * (sin_lookup(azimuth) >> SKY_Q_SHIFT)) >> SKY_Q_BITS;
+
+  const int32_t z = ((up * s_sin_lat) >> SKY_Q_BITS) + ((north * s_cos_lat) >> SKY_Q_BITS);
+  const int32_t x_now = ((up * s_cos_lat) >> SKY_Q_BITS) - ((north * s_sin_lat) >> SKY_Q_BITS);
+  const int32_t y_now = -east;
+
+  // Turn the hour angle back to the snapshot epoch rather than moving every body forward
+  const int32_t drift = prv_cdeg_to_trig(prv_sidereal_drift_cdeg(s_epoch, now) % 36000);
+  const int32_t sin_drift = sin_lookup(drift) >> SKY_Q_SHIFT;
+  const int32_t cos_drift = cos_lookup(drift) >> SKY_Q_SHIFT;
+  const int32_t x = ((x_now * cos_drift) >> SKY_Q_BITS) + ((y_now * sin_drift) >> SKY_Q_BITS);
+  const int32_t y = ((y_now * cos_drift) >> SKY_Q_BITS) - ((x_now * sin_drift) >> SKY_Q_BITS);
+
+  int32_t band = 0;
+  while (band < SKY_GRID_BANDS - 1 &&
+         z >= (sin_lookup(DEG_TO_TRIGANGLE(-90 + 30 * (band + 1))) >> SKY_Q_SHIFT)) {
+    band++;
+  }
+  int32_t hour_angle = atan2_lookup((int16_t)y, (int16_t)x);
+  if (hour_angle < 0) {
+    hour_angle += TRIG_MAX_ANGLE;
+  }
+  const int32_t sector = (hour_angle * SKY_GRID_SECTORS / TRIG_MAX_ANGLE) % SKY_GRID_SECTORS;
+
+  // Anything closer than the cutoff has a larger dot product with the pointing vector
+  int32_t best_dot = cos_lookup(DEG_TO_TRIGANGLE(SKY_NEAREST_MAX_DEG)) >> SKY_Q_SHIFT;
+  int16_t best = -1;
+
+  for (int32_t b = band - 1; b <= band + 1; b++) {
+    if (b < 0 || b >= SKY_GRID_BANDS) {
+      continue;
+    }
+    const bool polar = (b == 0 || b == SKY_GRID_BANDS - 1);
+    const int32_t first = polar ? 0 : sector - 1;
+    const int32_t last = polar ? SKY_GRID_SECTORS - 1 : sector + 1;
+
+    for (int32_t s = first; s <= last; s++) {
+      const uint8_t cell = (uint8_t)(b * SKY_GRID_SECTORS + (s + SKY_GRID_SECTORS) % SKY_GRID_SECTORS);
+      for (uint8_t k = s_grid_start[cell]; k < s_grid_start[cell + 1]; k++) {
+        const SkyObject *object = &s_objects[s_grid_order[k]];
+        const int32_t dot = (x * object->x + y * object->y + z * object->z) >> SKY_Q_BITS;
+        if (dot > best_dot) {
+          best_dot = dot;
+          best = object->body_id;
+        }
+      }
+    }
+  }
+
+  if (best < 0) {
+    return false;
+  }
+  *body_id = (uint8_t)best;
+  return true;
+}
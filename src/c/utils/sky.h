@@ -0,0 +1,54 @@
+#pragma once
+
+#include <pebble.h>
+
+// Matches NUM_BODIES in body_info.c (which is not a compile-time constant)
+#define SKY_MAX_OBJECTS 29
+
+// A snapshot older than this is re-requested when the overlay is opened
+#define SKY_SNAPSHOT_MAX_AGE_S (15 * SECONDS_PER_MINUTE)
+
+// sky_find_nearest never reports a body further than this from the pointing direction
+#define SKY_NEAREST_MAX_DEG 12
+
+// Target position in the observer's equatorial frame at a known time, so it can be
+// advanced at the sidereal rate instead of using a frozen alt/az
+typedef struct {
+  uint16_t hour_angle_cdeg;  // Local hour angle, hundredths of a degree (0-35999)
+  int16_t declination_cdeg;  // Declination, hundredths of a degree
+  int16_t latitude_cdeg;     // Observer latitude, hundredths of a degree
+  time_t epoch;              // When the hour angle was valid
+} TargetTrack;
+
+// Integer square root, for vector lengths in the fixed-point sky math
+int32_t sky_isqrt(uint32_t value);
+
+// Alt/az of a tracked position at `now`, propagated at the sidereal rate in fixed point
+void sky_track_to_horizontal(const TargetTrack *track, time_t now,
+                             int16_t *altitude_deg, int16_t *azimuth_deg);
+
+// Ask the phone for a SKY_SNAPSHOT of every body above the horizon
+bool sky_request_snapshot(void);
+
+// Store a SKY_SNAPSHOT if the message carries one; returns true if it did
+bool sky_handle_message(DictionaryIterator *iter);
+
+// True if a snapshot exists and is younger than SKY_SNAPSHOT_MAX_AGE_S
+bool sky_snapshot_is_fresh(void);
+
+// Local sidereal time at `now` (hundredths of a degree) and the observer latitude
+// from the last snapshot, enough to place any fixed RA/Dec. False without a snapshot.
+bool sky_get_sidereal(time_t now, uint16_t *sidereal_cdeg, int16_t *latitude_cdeg);
+
+// Observer position from the last snapshot, hundredths of a degree. False without one.
+bool sky_get_observer(int16_t *latitude_cdeg, int16_t *longitude_cdeg);
+
+uint8_t sky_get_count(void);
+
+// Body id and current alt/az of the snapshot entry at index
+bool sky_get_object(uint8_t index, time_t now, uint8_t *body_id,
+                    int16_t *altitude_deg, int16_t *azimuth_deg);
+
+// Snapshot body closest to a pointing direction at `now`, within SKY_NEAREST_MAX_DEG.
+// Uses the snapshot's grid index, so it is cheap enough for every sensor update.
+bool sky_find_nearest(int16_t altitude_deg, int16_t azimuth_deg, time_t now, uint8_t *body_id);
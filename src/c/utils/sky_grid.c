@@ -0,0 +1,156 @@
+#include "sky_grid.h"
+#include "star_catalog.h"
+#include "logging.h"
+
+// 15° declination bands by 15° right ascension sectors. With a few hundred objects
+// that is one or two per cell, and a 66° viewport touches about a fifth of them.
+#define SKY_GRID_BANDS 12
+#define SKY_GRID_SECTORS 24
+#define SKY_GRID_CELLS (SKY_GRID_BANDS * SKY_GRID_SECTORS)
+#define SKY_GRID_CELL_DEG 15
+#define SKY_GRID_CELL_CDEG (SKY_GRID_CELL_DEG * 100)
+// Trig lookups are Q16
+#define SKY_GRID_Q_SHIFT (16 - SKY_GRID_Q_BITS)
+
+// Objects sorted by cell; cell c holds s_objects[s_cell_start[c]..s_cell_start[c + 1])
+static SkyGridObject *s_objects;
+static uint16_t *s_cell_start;
+static uint16_t s_count;
+
+static int32_t prv_cdeg_to_trig(int32_t cdeg) {
+  return (cdeg * (TRIG_MAX_ANGLE / 4)) / 9000;
+}
+
+static int32_t prv_band(int32_t dec_cdeg) {
+  const int32_t band = (dec_cdeg + 9000) / SKY_GRID_CELL_CDEG;
+  if (band < 0) {
+    return 0;
+  }
+  return band < SKY_GRID_BANDS ? band : SKY_GRID_BANDS - 1;
+}
+
+static uint16_t prv_cell(uint16_t ra_cdeg, int16_t dec_cdeg) {
+  return (uint16_t)(prv_band(dec_cdeg) * SKY_GRID_SECTORS +
+                    (ra_cdeg / SKY_GRID_CELL_CDEG) % SKY_GRID_SECTORS);
+}
+
+bool sky_grid_create(void) {
+  if (s_objects) {
+    return true;
+  }
+
+  const uint16_t count = star_catalog_count();
+  if (count == 0) {
+    return false;
+  }
+
+  s_objects = malloc(count * sizeof(SkyGridObject));
+  s_cell_start = calloc(SKY_GRID_CELLS + 1, sizeof(uint16_t));
+  if (!s_objects || !s_cell_start) {
+    HUBBLE_LOG(APP_LOG_LEVEL_ERROR, "Not enough memory for the sky grid");
+    sky_grid_destroy();
+    return false;
+  }
+
+  // Counting sort: count each cell, turn the counts into starts, then use the
+  // starts as write cursors (which leaves each one at the next cell's start)
+  StarCatalogEntry entry;
+  for (uint16_t i = 0; i < count; i++) {
+    if (star_catalog_get(i, &entry)) {
+      s_cell_start[prv_cell(entry.ra_cdeg, entry.dec_cdeg) + 1]++;
+    }
+  }
+  for (uint16_t cell = 0; cell < SKY_GRID_CELLS; cell++) {
+    s_cell_start[cell + 1] += s_cell_start[cell];
+  }
+
+  for (uint16_t i = 0; i < count; i++) {
+    if (!star_catalog_get(i, &entry)) {
+      continue;
+    }
+    const int32_t ra = prv_cdeg_to_trig(entry.ra_cdeg);
+    const int32_t dec = prv_cdeg_to_trig(entry.dec_cdeg);
+    const int32_t cos_dec = cos_lookup(dec) >> SKY_GRID_Q_SHIFT;
+
+    SkyGridObject *object = &s_objects[s_cell_start[prv_cell(entry.ra_cdeg, entry.dec_cdeg)]++];
+    object->x = (int16_t)((cos_dec * (cos_lookup(ra) >> SKY_GRID_Q_SHIFT)) >> SKY_GRID_Q_BITS);
+    object->y = (int16_t)((cos_dec * (sin_lookup(ra) >> SKY_GRID_Q_SHIFT)) >> SKY_GRID_Q_BITS);
+    object->z = (int16_t)(sin_lookup(dec) >> SKY_GRID_Q_SHIFT);
+    object->magnitude_x10 = entry.magnitude_x10;
+    object->type = entry.type;
+    object->index = i;
+  }
+
+  for (uint16_t cell = SKY_GRID_CELLS; cell > 0; cell--) {
+    s_cell_start[cell] = s_cell_start[cell - 1];
+  }
+  s_cell_start[0] = 0;
+  s_count = s_cell_start[SKY_GRID_CELLS];
+
+  HUBBLE_LOG(APP_LOG_LEVEL_INFO, "Sky grid holds %d objects", (int)s_count);
+  return true;
+}
+
+void sky_grid_destroy(void) {
+  free(s_objects);
+  free(s_cell_start);
+  s_objects = NULL;
+  s_cell_start = NULL;
+  s_count = 0;
+}
+
+uint16_t sky_grid_count(void) {
+  return s_count;
+}
+
+// Sectors either side of the center one needed to cover the cap: its right
+// ascension half-width is asin(sin r / cos dec), found by stepping whole sectors
+// so no inverse trig or square root is needed
+static int32_t prv_half_sectors(int16_t dec_cdeg, uint16_t radius_deg) {
+  const int32_t sin_radius = sin_lookup(DEG_TO_TRIGANGLE(radius_deg)) >> SKY_GRID_Q_SHIFT;
+  const int32_t cos_dec = cos_lookup(prv_cdeg_to_trig(dec_cdeg)) >> SKY_GRID_Q_SHIFT;
+  const int32_t target = sin_radius << SKY_GRID_Q_BITS;
+
+  for (int32_t half = 1; half <= SKY_GRID_SECTORS / 4; half++) {
+    const int32_t sin_half =
+        sin_lookup(DEG_TO_TRIGANGLE(half * SKY_GRID_CELL_DEG)) >> SKY_GRID_Q_SHIFT;
+    if (sin_half * cos_dec >= target) {
+      return half;
+    }
+  }
+  return SKY_GRID_SECTORS / 2;
+}
+
+uint16_t sky_grid_visit_cap(uint16_t ra_cdeg, int16_t dec_cdeg, uint16_t radius_deg,
+                            SkyGridVisitor visitor, void *context) {
+  if (!s_objects || !visitor) {
+    return 0;
+  }
+
+  const int32_t radius_cdeg = (int32_t)radius_deg * 100;
+  const int32_t low_cdeg = dec_cdeg - radius_cdeg;
+  const int32_t high_cdeg = dec_cdeg + radius_cdeg;
+
+  // A cap over a pole spans every right ascension
+  int32_t half = SKY_GRID_SECTORS / 2;
+  if (low_cdeg > -9000 && high_cdeg < 9000) {
+    half = prv_half_sectors(dec_cdeg, radius_deg);
+  }
+  const int32_t center = (ra_cdeg % 36000) / SKY_GRID_CELL_CDEG;
+  const int32_t first_sector = 2 * half + 1 >= SKY_GRID_SECTORS ? 0 : center - half;
+  const int32_t last_sector =
+      2 * half + 1 >= SKY_GRID_SECTORS ? SKY_GRID_SECTORS - 1 : center + half;
+
+  uint16_t visited = 0;
+  for (int32_t band = prv_band(low_cdeg); band <= prv_band(high_cdeg); band++) {
+    for (int32_t sector = first_sector; sector <= last_sector; sector++) {
+      const int32_t cell =
+          band * SKY_GRID_SECTORS + (sector + SKY_GRID_SECTORS) % SKY_GRID_SECTORS;
+      for (uint16_t k = s_cell_start[cell]; k < s_cell_start[cell + 1]; k++) {
+        visitor(&s_objects[k], context);
+        visited++;
+      }
+    }
+  }
+  return visited;
+}
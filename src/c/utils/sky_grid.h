@@ -0,0 +1,35 @@
+#pragma once
+
+#include <pebble.h>
+
+// RA/Dec cell index over the star catalog for the sky map. Records are read from
+// the resource once when the index is created and kept as unit vectors sorted by
+// cell, so a frame only rotates and projects objects in cells its viewport touches.
+
+// Unit vectors are Q14
+#define SKY_GRID_Q_BITS 14
+
+// Catalog object in the J2000 equatorial frame (x toward RA 0h, y toward 6h, z north)
+typedef struct {
+  int16_t x;
+  int16_t y;
+  int16_t z;
+  int8_t magnitude_x10;
+  uint8_t type;    // StarCatalogType
+  uint16_t index;  // Catalog index (body id - STAR_CATALOG_FIRST_BODY_ID)
+} SkyGridObject;
+
+typedef void (*SkyGridVisitor)(const SkyGridObject *object, void *context);
+
+// Load the catalog into RAM, 10 bytes per object plus the cell table. Returns false
+// if the catalog is missing or the heap is too small. Destroy when the view closes.
+bool sky_grid_create(void);
+void sky_grid_destroy(void);
+
+uint16_t sky_grid_count(void);
+
+// Visit the objects in every cell that overlaps the cap of radius_deg around
+// (ra_cdeg, dec_cdeg). Cells are coarse, so objects up to a cell outside the cap
+// are visited too and the caller still culls. Returns the number visited.
+uint16_t sky_grid_visit_cap(uint16_t ra_cdeg, int16_t dec_cdeg, uint16_t radius_deg,
+                            SkyGridVisitor visitor, void *context);
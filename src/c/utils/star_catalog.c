@@ -0,0 +1,276 @@
+#include "star_catalog.h"
+#include "logging.h"
+
+// Resource layout; see build_catalog.py
+#define STAR_CATALOG_MAGIC "HSTC"
+#define STAR_CATALOG_VERSION 2
+#define STAR_CATALOG_HEADER_SIZE 18
+#define STAR_CATALOG_RECORD_SIZE 8
+#define STAR_CATALOG_INDEX_ENTRY_SIZE 4
+
+typedef struct {
+  uint16_t count;
+  uint16_t star_count;
+  uint16_t index_count;
+  uint16_t index_offset;
+  uint16_t names_offset;
+  uint16_t names_size;
+} StarCatalogHeader;
+
+static ResHandle s_handle;
+static StarCatalogHeader s_header;
+static bool s_opened;
+
+static uint16_t prv_read_u16(const uint8_t *data) {
+  return (uint16_t)(data[0] | (data[1] << 8));
+}
+
+// ASCII-only; matches str.lower() in build_catalog.py for the names it accepts
+static char prv_lower(char c) {
+  return (c >= 'A' && c <= 'Z') ? (char)(c - 'A' + 'a') : c;
+}
+
+// Read the header once; every later access is a byte-range read at a known offset
+static bool prv_open(void) {
+  if (s_opened) {
+    return s_header.count > 0;
+  }
+  s_opened = true;
+
+  s_handle = resource_get_handle(RESOURCE_ID_STAR_CATALOG);
+  const size_t size = resource_size(s_handle);
+  uint8_t header[STAR_CATALOG_HEADER_SIZE];
+  if (size < sizeof(header) ||
+      resource_load_byte_range(s_handle, 0, header, sizeof(header)) != sizeof(header) ||
+      memcmp(header, STAR_CATALOG_MAGIC, 4) != 0 || header[4] != STAR_CATALOG_VERSION ||
+      header[5] != STAR_CATALOG_RECORD_SIZE) {
+    HUBBLE_LOG(APP_LOG_LEVEL_ERROR, "Star catalog resource is missing or malformed");
+    return false;
+  }
+
+  const StarCatalogHeader parsed = {
+    .count = prv_read_u16(&header[6]),
+    .star_count = prv_read_u16(&header[8]),
+    .index_count = prv_read_u16(&header[10]),
+    .index_offset = prv_read_u16(&header[12]),
+    .names_offset = prv_read_u16(&header[14]),
+    .names_size = prv_read_u16(&header[16]),
+  };
+  if (parsed.star_count > parsed.count ||
+      parsed.index_offset < STAR_CATALOG_HEADER_SIZE + parsed.count * STAR_CATALOG_RECORD_SIZE ||
+      parsed.names_offset <
+          parsed.index_offset + (uint32_t)parsed.index_count * STAR_CATALOG_INDEX_ENTRY_SIZE ||
+      (size_t)parsed.names_offset + parsed.names_size > size) {
+    HUBBLE_LOG(APP_LOG_LEVEL_ERROR, "Star catalog offsets out of range");
+    return false;
+  }
+
+  s_header = parsed;
+  return true;
+}
+
+static bool prv_read_record(uint16_t index, uint8_t record[STAR_CATALOG_RECORD_SIZE]) {
+  if (!prv_open() || index >= s_header.count) {
+    return false;
+  }
+  const uint32_t offset = STAR_CATALOG_HEADER_SIZE + (uint32_t)index * STAR_CATALOG_RECORD_SIZE;
+  return resource_load_byte_range(s_handle, offset, record, STAR_CATALOG_RECORD_SIZE) ==
+         STAR_CATALOG_RECORD_SIZE;
+}
+
+uint16_t star_catalog_count(void) {
+  return prv_open() ? s_header.count : 0;
+}
+
+uint16_t star_catalog_star_count(void) {
+  return prv_open() ? s_header.star_count : 0;
+}
+
+bool star_catalog_get(uint16_t index, StarCatalogEntry *entry) {
+  uint8_t record[STAR_CATALOG_RECORD_SIZE];
+  if (!entry || !prv_read_record(index, record)) {
+    return false;
+  }
+
+  entry->ra_cdeg = prv_read_u16(&record[0]);
+  entry->dec_cdeg = (int16_t)prv_read_u16(&record[2]);
+  entry->magnitude_x10 = (int8_t)record[4];
+  entry->type = record[5];
+  return true;
+}
+
+// Copy the NUL-terminated name at name_offset into buffer (at most size - 1 characters)
+static bool prv_read_name(uint16_t name_offset, char *buffer, size_t size) {
+  if (name_offset >= s_header.names_size) {
+    return false;
+  }
+
+  // Names are NUL-terminated, so reading a little past a short one is harmless
+  size_t length = size - 1;
+  if (length > (size_t)(s_header.names_size - name_offset)) {
+    length = s_header.names_size - name_offset;
+  }
+  const size_t read = resource_load_byte_range(s_handle, s_header.names_offset + name_offset,
+                                               (uint8_t *)buffer, length);
+  buffer[read < length ? read : length] = '\0';
+  return true;
+}
+
+bool star_catalog_get_name(uint16_t index, char *buffer, size_t size) {
+  uint8_t record[STAR_CATALOG_RECORD_SIZE];
+  if (!buffer || size == 0 || !prv_read_record(index, record)) {
+    return false;
+  }
+  return prv_read_name(prv_read_u16(&record[6]), buffer, size);
+}
+
+static bool prv_read_index(uint16_t rank, uint16_t *body_id, uint16_t *name_offset) {
+  if (!prv_open() || rank >= s_header.index_count) {
+    return false;
+  }
+
+  uint8_t entry[STAR_CATALOG_INDEX_ENTRY_SIZE];
+  const uint32_t offset = s_header.index_offset + (uint32_t)rank * STAR_CATALOG_INDEX_ENTRY_SIZE;
+  if (resource_load_byte_range(s_handle, offset, entry, sizeof(entry)) != sizeof(entry)) {
+    return false;
+  }
+  *body_id = prv_read_u16(&entry[0]);
+  *name_offset = prv_read_u16(&entry[2]);
+  return true;
+}
+
+uint16_t star_catalog_name_count(void) {
+  return prv_open() ? s_header.index_count : 0;
+}
+
+bool star_catalog_get_sorted(uint16_t rank, int *body_id) {
+  uint16_t id;
+  uint16_t name_offset;
+  if (!body_id || !prv_read_index(rank, &id, &name_offset)) {
+    return false;
+  }
+  *body_id = id;
+  return true;
+}
+
+// Compare the first `length` characters of the name at `rank` with key, ignoring
+// case. A name shorter than the key sorts before it. One index read and one name
+// read per call.
+static int prv_compare_prefix(uint16_t rank, const char *key, size_t length) {
+  uint16_t body_id;
+  uint16_t name_offset;
+  char name[STAR_CATALOG_NAME_SIZE];
+  if (!prv_read_index(rank, &body_id, &name_offset) ||
+      !prv_read_name(name_offset, name, sizeof(name))) {
+    return 1;
+  }
+
+  for (size_t i = 0; i < length; i++) {
+    const int a = (unsigned char)prv_lower(name[i]);
+    const int b = (unsigned char)prv_lower(key[i]);
+    if (a != b) {
+      return a - b;
+    }
+    if (a == '\0') {
+      break;
+    }
+  }
+  return 0;
+}
+
+// First rank whose name prefix compares >= key (or > key when `upper`)
+static uint16_t prv_bound(const char *key, size_t length, bool upper) {
+  uint16_t low = 0;
+  uint16_t high = s_header.index_count;
+  while (low < high) {
+    const uint16_t mid = low + (high - low) / 2;
+    const int cmp = prv_compare_prefix(mid, key, length);
+    if (cmp < 0 || (upper && cmp == 0)) {
+      low = mid + 1;
+    } else {
+      high = mid;
+    }
+  }
+  return low;
+}
+
+uint16_t star_catalog_find_prefix(const char *prefix, uint16_t *first_rank) {
+  if (!prefix || !prv_open()) {
+    return 0;
+  }
+
+  const size_t length = strlen(prefix);
+  const uint16_t first = prv_bound(prefix, length, false);
+  if (first_rank) {
+    *first_rank = first;
+  }
+  return prv_bound(prefix, length, true) - first;
+}
+
+// Lowercase character at `position` of the name at `rank`, or '\0' past its end
+static char prv_char_at(uint16_t rank, size_t position) {
+  uint16_t body_id;
+  uint16_t name_offset;
+  char name[STAR_CATALOG_NAME_SIZE];
+  if (position >= sizeof(name) - 1 || !prv_read_index(rank, &body_id, &name_offset) ||
+      !prv_read_name(name_offset, name, sizeof(name))) {
+    return '\0';
+  }
+  for (size_t i = 0; i < position; i++) {
+    if (name[i] == '\0') {
+      return '\0';
+    }
+  }
+  return prv_lower(name[position]);
+}
+
+char star_catalog_next_char(const char *prefix, char current, bool forward) {
+  if (!prefix || !prv_open()) {
+    return '\0';
+  }
+
+  const size_t length = strlen(prefix);
+  if (length >= STAR_CATALOG_NAME_SIZE - 1) {
+    return '\0';
+  }
+
+  uint16_t first;
+  const uint16_t count = star_catalog_find_prefix(prefix, &first);
+  if (count == 0) {
+    return '\0';
+  }
+
+  // Search for the prefix extended by the neighbouring character; names in the
+  // prefix range are sorted by their next character, so the bound lands on it
+  char key[STAR_CATALOG_NAME_SIZE + 1];
+  memcpy(key, prefix, length);
+  key[length + 1] = '\0';
+  current = prv_lower(current);
+  if (!forward && current == '\0') {
+    // Start from the far end of the wheel
+    current = 0x7F;
+  }
+
+  if (forward) {
+    if ((unsigned char)current >= 0x7F) {
+      return '\0';
+    }
+    key[length] = (char)(current + 1);
+    const uint16_t rank = prv_bound(key, length + 1, false);
+    return rank < first + count ? prv_char_at(rank, length) : '\0';
+  }
+
+  key[length] = current;
+  const uint16_t rank = prv_bound(key, length + 1, false);
+  // A name equal to the prefix sorts first and has no next character
+  return rank > first ? prv_char_at(rank - 1, length) : '\0';
+}
+
+bool star_catalog_is_body(int body_id) {
+  return body_id >= STAR_CATALOG_FIRST_BODY_ID &&
+         body_id < STAR_CATALOG_FIRST_BODY_ID + star_catalog_count();
+}
+
+uint16_t star_catalog_index_of(int body_id) {
+  return (uint16_t)(body_id - STAR_CATALOG_FIRST_BODY_ID);
+}
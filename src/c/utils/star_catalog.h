@@ -0,0 +1,67 @@
+#pragma once
+
+#include <pebble.h>
+
+// Bright stars and Messier objects packed into the STAR_CATALOG raw resource by
+// tools/star_catalog/build_catalog.py. Entries are read from flash on demand, so the
+// catalog costs an 18-byte header in RAM however large it grows.
+
+// Catalog entry i is body id STAR_CATALOG_FIRST_BODY_ID + i, after the built-in bodies
+#define STAR_CATALOG_FIRST_BODY_ID 29
+
+// Longest name plus the terminator
+#define STAR_CATALOG_NAME_SIZE 16
+
+// Order matches TYPES in build_catalog.py
+typedef enum {
+  StarCatalogTypeStar = 0,
+  StarCatalogTypeDoubleStar,
+  StarCatalogTypeOpenCluster,
+  StarCatalogTypeGlobularCluster,
+  StarCatalogTypeNebula,
+  StarCatalogTypePlanetaryNebula,
+  StarCatalogTypeGalaxy,
+  StarCatalogTypeRemnant,
+  StarCatalogTypeOther,
+} StarCatalogType;
+
+typedef struct {
+  uint16_t ra_cdeg;      // J2000 right ascension, hundredths of a degree (0-35999)
+  int16_t dec_cdeg;      // J2000 declination, hundredths of a degree
+  int8_t magnitude_x10;  // Visual magnitude * 10
+  uint8_t type;          // StarCatalogType
+} StarCatalogEntry;
+
+// Number of entries; 0 if the resource is missing or malformed
+uint16_t star_catalog_count(void);
+
+// Entries [0, star_count) are stars, the rest are deep-sky objects
+uint16_t star_catalog_star_count(void);
+
+bool star_catalog_get(uint16_t index, StarCatalogEntry *entry);
+
+// Copy the entry's name into buffer (at most size - 1 characters)
+bool star_catalog_get_name(uint16_t index, char *buffer, size_t size);
+
+// The resource also carries a case-insensitive name index over every body,
+// built-in bodies included. Lookups binary-search it in flash: O(log n) reads
+// and no allocation.
+
+// Number of names in the index
+uint16_t star_catalog_name_count(void);
+
+// Body id at position `rank` of the sorted name index
+bool star_catalog_get_sorted(uint16_t rank, int *body_id);
+
+// Number of names starting with prefix (ignoring case); the first one is at
+// *first_rank. An empty prefix matches every name.
+uint16_t star_catalog_find_prefix(const char *prefix, uint16_t *first_rank);
+
+// Next (or previous) character, in lowercase, that follows prefix in some name,
+// strictly after (before) `current`. Pass '\0' as current to start from the
+// first (last) character. Returns '\0' when there is none.
+char star_catalog_next_char(const char *prefix, char current, bool forward);
+
+// Map between body ids and catalog indices
+bool star_catalog_is_body(int body_id);
+uint16_t star_catalog_index_of(int body_id);
@@ -0,0 +1,15 @@
+#pragma once
+
+#include <pebble.h>
+
+// JS sends plain numbers, so tuple width depends on the value; read any width
+static inline int32_t tuple_int(const Tuple *tuple) {
+  switch (tuple->length) {
+    case 1:
+      return tuple->value->int8;
+    case 2:
+      return tuple->value->int16;
+    default:
+      return tuple->value->int32;
+  }
+}
@@ -0,0 +1,14 @@
+#pragma once
+
+// AppWorkerMessage types shared by the app and the background compass worker
+// (worker_src/c). Header-only so both binaries can include it.
+
+// App -> worker: reply with WORKER_MSG_HEADING right away
+#define WORKER_MSG_REQUEST_HEADING 1
+
+// Worker -> app: data0 = CompassStatus + 1 (0 if nothing sampled yet),
+// data1 = magnetic heading as a trig angle, data2 = reading age in seconds
+#define WORKER_MSG_HEADING 2
+
+// App -> worker: data0 = 1 while the app is using the compass itself, 0 when done
+#define WORKER_MSG_SET_PAUSED 3
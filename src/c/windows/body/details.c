@@ -1,6 +1,11 @@
 #include "details.h"
 #include "../../style.h"
 #include "../../utils/bodymsg.h"
+#include "../../utils/constellation_figure.h"
+#include "../../utils/image_cache.h"
+#include "../../utils/moon_render.h"
+#include "../../utils/star_catalog.h"
+#include "../../utils/heap_stats.h"
 #include "../../utils/logging.h"
 #include "options.h"
 #include "action_indicator.h"
@@ -9,7 +14,9 @@
 // #define DEMO_MODE
 
 #define HERO_IMAGE_SIZE 50
-#define CONSTELLATION_IMAGE_SIZE 80
+// Figures are vectors, so rectangular screens scale them with the display. Round
+// screens keep 80px to leave room for the grid columns either side.
+#define CONSTELLATION_IMAGE_SIZE PBL_IF_ROUND_ELSE(80, PBL_DISPLAY_WIDTH * 5 / 9)
 #define CONSTELLATION_BODY_ID_START 10
 #define GRID_MARGIN 0
 #define GRID_ROUND_SIDE_PADDING 8
@@ -49,8 +56,16 @@ static TextLayer *s_title_layer;
 static TextLayer *s_detail_layer;
 static TextLayer *s_grid_layers[GRID_ROWS][GRID_COLS];
 static TextLayer *s_long_text_layer;
+// Borrowed from the image cache; s_image_resource_id is what we hold a reference to
 static GDrawCommandImage *s_pdc_image;
 static GBitmap *s_bitmap_image;
+static uint32_t s_image_resource_id;
+// Constellations are drawn from a figure read out of the shared table
+static ConstellationFigure s_figure;
+static int s_figure_body_id = -1;
+// Rendered moons are borrowed from moon_render rather than the image cache
+static bool s_moon_borrowed;
+static uint16_t s_moon_phase_cdeg;
 static StatusBarLayer *s_status_layer;
 static Layer *s_action_indicator_layer;
 static Layer *s_content_indicator_layer;
@@ -59,6 +74,8 @@ static ContentIndicator *s_content_indicator;
 static int16_t s_page_height;
 static DetailsContent s_content;
 static bool s_is_loading;
+// Body type the current frames were laid out for
+static bool s_layout_is_constellation;
 
 static bool prv_is_loading(void) {
   return s_is_loading;
@@ -80,8 +97,12 @@ static const DetailsContent s_loading_content = {
     .body_id = -1,  // Not a specific body
 };
 
+static bool prv_is_constellation_id(int body_id) {
+  return body_id >= CONSTELLATION_BODY_ID_START && body_id < STAR_CATALOG_FIRST_BODY_ID;
+}
+
 static bool prv_is_constellation(void) {
-  return s_content.body_id >= CONSTELLATION_BODY_ID_START;
+  return prv_is_constellation_id(s_content.body_id);
 }
 
 #ifdef DEMO_MODE
@@ -102,11 +123,12 @@ static void prv_apply_demo_mode(DetailsContent *content) {
     content->altitude_deg = -52;
     content->azimuth_deg = 39;
     content->illumination_x10 = -110;  // -11.0
-    content->image_resource_id = RESOURCE_ID_FULL_MOON;
-    content->image_type = DETAILS_IMAGE_TYPE_BITMAP;
+    content->image_resource_id = 0;
+    content->image_type = DETAILS_IMAGE_TYPE_MOON;
+    content->moon_phase_cdeg = 18000;
   } 
-  // Check if this is a constellation (body_id >= 10)
-  else if (content->body_id >= CONSTELLATION_BODY_ID_START) {
+  // Check if this is a constellation (body_id 10-28)
+  else if (prv_is_constellation_id(content->body_id)) {
     // Cassiopeia demo data
     content->title_text = "Cassiopeia";
     content->detail_text = "69° above horizon";
@@ -134,7 +156,8 @@ static void prv_draw_image(Layer *layer, GContext *ctx) {
   const GPoint origin = GPoint((bounds.size.w - image_bounds.w) / 2,
                                (bounds.size.h - image_bounds.h) / 2);
 
-  if (s_content.image_type == DETAILS_IMAGE_TYPE_BITMAP && s_bitmap_image) {
+  if ((s_content.image_type == DETAILS_IMAGE_TYPE_BITMAP ||
+       s_content.image_type == DETAILS_IMAGE_TYPE_MOON) && s_bitmap_image) {
     const GRect target =
         GRect(origin.x, origin.y, image_bounds.w, image_bounds.h);
     graphics_context_set_compositing_mode(ctx, GCompOpSet);
@@ -144,27 +167,77 @@ static void prv_draw_image(Layer *layer, GContext *ctx) {
 
   if (s_content.image_type == DETAILS_IMAGE_TYPE_PDC && s_pdc_image) {
     gdraw_command_image_draw(ctx, s_pdc_image, origin);
+    return;
   }
-}
 
-static void prv_update_image(void) {
-  // Clean up old images
-  if (s_pdc_image) {
-    gdraw_command_image_destroy(s_pdc_image);
-    s_pdc_image = NULL;
+  if (s_content.image_type == DETAILS_IMAGE_TYPE_FIGURE && s_figure_body_id >= 0) {
+    constellation_figure_draw(ctx, &s_figure,
+                              GRect(origin.x, origin.y, image_bounds.w, image_bounds.h));
   }
-  if (s_bitmap_image) {
-    gbitmap_destroy(s_bitmap_image);
-    s_bitmap_image = NULL;
+}
+
+static void prv_release_image(void) {
+  if (s_moon_borrowed) {
+    moon_render_release();
+    s_moon_borrowed = false;
+  } else if (s_image_resource_id != 0) {
+    image_cache_release(s_image_resource_id);
   }
+  s_image_resource_id = 0;
+  s_pdc_image = NULL;
+  s_bitmap_image = NULL;
+  s_figure_body_id = -1;
+}
 
-  // Load new image only if resource_id is valid (non-zero)
-  if (s_content.image_resource_id != 0) {
-    if (s_content.image_type == DETAILS_IMAGE_TYPE_BITMAP) {
-      s_bitmap_image = gbitmap_create_with_resource(s_content.image_resource_id);
-    } else {
-      s_pdc_image = gdraw_command_image_create_with_resource(s_content.image_resource_id);
+static void prv_acquire_image(void) {
+  if (s_content.image_type == DETAILS_IMAGE_TYPE_FIGURE) {
+    if (constellation_figure_load(s_content.body_id, &s_figure)) {
+      s_figure_body_id = s_content.body_id;
     }
+    return;
+  }
+
+  if (s_content.image_type == DETAILS_IMAGE_TYPE_MOON) {
+    s_bitmap_image = moon_render_acquire(s_content.moon_phase_cdeg, HERO_IMAGE_SIZE);
+    s_moon_borrowed = s_bitmap_image != NULL;
+    s_moon_phase_cdeg = s_content.moon_phase_cdeg;
+    return;
+  }
+
+  // Only load image if resource_id is valid (non-zero)
+  if (s_content.image_resource_id == 0) {
+    return;
+  }
+  if (s_content.image_type == DETAILS_IMAGE_TYPE_BITMAP) {
+    s_bitmap_image = image_cache_acquire_bitmap(s_content.image_resource_id);
+  } else {
+    s_pdc_image = image_cache_acquire_pdc(s_content.image_resource_id);
+  }
+  if (s_bitmap_image || s_pdc_image) {
+    s_image_resource_id = s_content.image_resource_id;
+  }
+}
+
+static void prv_update_image(void) {
+  // Refreshing the same body keeps the image we already hold
+  bool have_image;
+  switch (s_content.image_type) {
+    case DETAILS_IMAGE_TYPE_BITMAP:
+      have_image = s_bitmap_image != NULL && s_image_resource_id == s_content.image_resource_id;
+      break;
+    case DETAILS_IMAGE_TYPE_PDC:
+      have_image = s_pdc_image != NULL && s_image_resource_id == s_content.image_resource_id;
+      break;
+    case DETAILS_IMAGE_TYPE_MOON:
+      have_image = s_moon_borrowed && s_moon_phase_cdeg == s_content.moon_phase_cdeg;
+      break;
+    default:
+      have_image = s_figure_body_id >= 0 && s_figure_body_id == s_content.body_id;
+      break;
+  }
+  if (!have_image) {
+    prv_release_image();
+    prv_acquire_image();
   }
 
   // Mark image layer for redraw
@@ -189,8 +262,9 @@ static void prv_format_additional_info(char *buffer, size_t buffer_size) {
   snprintf(az_str, sizeof(az_str), "%d° %s", s_content.azimuth_deg, directions[dir_index]);
 
   // Combine into formatted string.
-  // If the body is the Sun or beyond (>= 9), do not display illumination.
-  if (s_content.body_id >= 9) {
+  // The Sun and constellations (>= 9) have no illumination to show; catalog
+  // stars and deep-sky objects show their magnitude like the planets.
+  if (s_content.body_id >= 9 && !star_catalog_is_body(s_content.body_id)) {
     snprintf(buffer, buffer_size,
              "Altitude\n%s\n\nAzimuth\n%s",
              alt_str, az_str);
@@ -211,11 +285,19 @@ static void prv_format_additional_info(char *buffer, size_t buffer_size) {
   }
 }
 
+static void prv_layout_content(void);
+
 static void prv_update_content_display(void) {
   if (!s_window) {
     return;
   }
 
+  // Switching between a body and a constellation only moves and hides layers
+  if (s_scroll_layer && s_layout_is_constellation != prv_is_constellation()) {
+    s_layout_is_constellation = prv_is_constellation();
+    prv_layout_content();
+  }
+
   // Update title
   if (s_title_layer) {
     text_layer_set_text(s_title_layer, s_content.title_text);
@@ -226,17 +308,17 @@ static void prv_update_content_display(void) {
     text_layer_set_text(s_detail_layer, s_content.detail_text);
   }
 
-  // Update grid text (only exists for non-constellations)
-  if (!prv_is_constellation()) {
-    if (s_grid_layers[0][0]) text_layer_set_text(s_grid_layers[0][0], s_content.grid_top_left);
-    if (s_grid_layers[0][1]) text_layer_set_text(s_grid_layers[0][1], s_content.grid_top_right);
-    if (s_grid_layers[1][0]) text_layer_set_text(s_grid_layers[1][0], s_content.grid_bottom_left);
-    if (s_grid_layers[1][1]) text_layer_set_text(s_grid_layers[1][1], s_content.grid_bottom_right);
-  }
+  // Update grid text (hidden for constellations)
+  if (s_grid_layers[0][0]) text_layer_set_text(s_grid_layers[0][0], s_content.grid_top_left);
+  if (s_grid_layers[0][1]) text_layer_set_text(s_grid_layers[0][1], s_content.grid_top_right);
+  if (s_grid_layers[1][0]) text_layer_set_text(s_grid_layers[1][0], s_content.grid_bottom_left);
+  if (s_grid_layers[1][1]) text_layer_set_text(s_grid_layers[1][1], s_content.grid_bottom_right);
 
   // Update long text with altitude, azimuth, and illumination info
   if (s_long_text_layer) {
-    prv_format_additional_info(s_content.long_text, sizeof(s_content.long_text));
+    if (!prv_is_loading()) {
+      prv_format_additional_info(s_content.long_text, sizeof(s_content.long_text));
+    }
 
     text_layer_set_text(s_long_text_layer, s_content.long_text);
   }
@@ -308,129 +390,57 @@ static void prv_click_config_provider(void *context) {
   window_single_repeating_click_subscribe(BUTTON_ID_DOWN, 100, prv_scroll_down_handler);
 }
 
-static void prv_create_grid_layers(GRect bounds, GFont font) {
-  // Don't create grid layers for constellations - they don't have rise/set times
-  if (prv_is_constellation()) {
-    for (int row = 0; row < GRID_ROWS; ++row) {
-      for (int col = 0; col < GRID_COLS; ++col) {
-        s_grid_layers[row][col] = NULL;
-      }
-    }
-    return;
-  }
-
-  const int16_t column_width = (bounds.size.w - GRID_MARGIN * 3) / 2;
-  const int16_t row_height = GRID_ROW_HEIGHT;
-  int16_t y = bounds.origin.y;
-
-  const char *grid_text[GRID_ROWS][GRID_COLS] = {
-    {s_content.grid_top_left, s_content.grid_top_right},
-    {s_content.grid_bottom_left, s_content.grid_bottom_right}
-  };
+static TextLayer *prv_create_text_layer(const char *text, const char *font_key, GTextAlignment alignment) {
+  // Frames are assigned by prv_layout_content once the layer tree exists
+  TextLayer *text_layer = text_layer_create(GRectZero);
+  text_layer_set_text(text_layer, text);
+  text_layer_set_background_color(text_layer, GColorClear);
+  text_layer_set_text_color(text_layer, layout_get()->foreground);
+  text_layer_set_font(text_layer, fonts_get_system_font(font_key));
+  text_layer_set_overflow_mode(text_layer, GTextOverflowModeWordWrap);
+  text_layer_set_text_alignment(text_layer, alignment);
+  scroll_layer_add_child(s_scroll_layer, text_layer_get_layer(text_layer));
+  return text_layer;
+}
 
+static void prv_set_grid_hidden(bool hidden) {
   for (int row = 0; row < GRID_ROWS; ++row) {
-    int16_t x = GRID_MARGIN;
     for (int col = 0; col < GRID_COLS; ++col) {
-      GRect frame = GRect(x, y, column_width, row_height);
-      s_grid_layers[row][col] = text_layer_create(frame);
-      text_layer_set_text(s_grid_layers[row][col], grid_text[row][col]);
-      text_layer_set_background_color(s_grid_layers[row][col], GColorClear);
-      text_layer_set_text_color(s_grid_layers[row][col], layout_get()->foreground);
-      text_layer_set_font(s_grid_layers[row][col], font);
-      text_layer_set_overflow_mode(s_grid_layers[row][col], GTextOverflowModeWordWrap);
-      text_layer_set_text_alignment(s_grid_layers[row][col],GTextAlignmentCenter);
-      scroll_layer_add_child(s_scroll_layer,
-                             text_layer_get_layer(s_grid_layers[row][col]));
-
-      x += column_width + GRID_MARGIN;
+      if (s_grid_layers[row][col]) {
+        layer_set_hidden(text_layer_get_layer(s_grid_layers[row][col]), hidden);
+      }
     }
-    y += row_height + GRID_MARGIN;
   }
 }
 
-static void prv_window_load(Window *window) {
-  const Layout *layout = layout_get();
-  Layer *window_layer = window_get_root_layer(window);
-  const GRect bounds = layer_get_bounds(window_layer);
-  s_page_height = bounds.size.h;
-
-  s_status_layer = status_bar_layer_create();
-  status_bar_layer_set_colors(s_status_layer, layout->background, layout->foreground);
-  layer_add_child(window_layer, status_bar_layer_get_layer(s_status_layer));
+static void prv_set_grid_frame(int row, int col, GRect frame) {
+  if (s_grid_layers[row][col]) {
+    layer_set_frame(text_layer_get_layer(s_grid_layers[row][col]), frame);
+  }
+}
 
-  // Create action indicator (initially hidden during loading)
-  s_action_indicator_layer = action_indicator_create(bounds);
-  action_indicator_add_to_window(window);
-  action_indicator_set_visible(!prv_is_loading());
+// Positions every layer for the current body type and re-flows the scroll
+// content. Safe to call again on a loaded window when the body type changes.
+static void prv_layout_content(void) {
+  if (!s_window || !s_scroll_layer) {
+    return;
+  }
 
-  const GRect scroll_bounds = GRect(bounds.origin.x,
-                                    bounds.origin.y + STATUS_BAR_LAYER_HEIGHT,
-                                    bounds.size.w, bounds.size.h - STATUS_BAR_LAYER_HEIGHT);
-  s_scroll_layer = scroll_layer_create(scroll_bounds);
-  scroll_layer_set_shadow_hidden(s_scroll_layer, true);
-  scroll_layer_set_context(s_scroll_layer, s_scroll_layer);
-  scroll_layer_set_callbacks(
-      s_scroll_layer,
-      (ScrollLayerCallbacks){
-          .click_config_provider = prv_click_config_provider,
-          .content_offset_changed_handler = prv_content_offset_changed_handler,
-      });
-  scroll_layer_set_click_config_onto_window(s_scroll_layer, window);
-  scroll_layer_set_paging(s_scroll_layer, true);
+  const GRect bounds = layer_get_bounds(window_get_root_layer(s_window));
 
-  // Set up content indicator
-  s_content_indicator = scroll_layer_get_content_indicator(s_scroll_layer);
-  
-  // Create a layer for the indicator background (black background)
-  const int16_t indicator_height = 20;
-  const GRect indicator_frame = GRect(0, scroll_bounds.size.h - indicator_height, 
-                                      scroll_bounds.size.w, indicator_height);
-  s_content_indicator_layer = layer_create(indicator_frame);
-  layer_set_update_proc(s_content_indicator_layer, prv_draw_content_indicator_background);
-  layer_add_child(scroll_layer_get_layer(s_scroll_layer), s_content_indicator_layer);
-  
-  // Configure the down direction with white arrow
-  ContentIndicatorConfig indicator_config = {
-    .layer = s_content_indicator_layer,
-    .times_out = false,
-    .alignment = GAlignCenter,
-    .colors = {
-      .foreground = GColorWhite,
-      .background = GColorBlack,
-    }
-  };
-  content_indicator_configure_direction(s_content_indicator, ContentIndicatorDirectionDown, &indicator_config);
-  
-  // Initially hidden (will be shown when at top via callback)
-  content_indicator_set_content_available(s_content_indicator, ContentIndicatorDirectionDown, false);
+  // Constellations have no rise/set times, so the grid stays hidden
+  prv_set_grid_hidden(prv_is_constellation());
 
   // Title
   const int16_t side_margin = GRID_MARGIN;
   int16_t y_cursor = TITLE_TOP_MARGIN;
-  GRect title_frame =
+  const GRect title_frame =
       GRect(side_margin, y_cursor, bounds.size.w - side_margin * 2, FONT_HEIGHT);
-  s_title_layer = text_layer_create(title_frame);
-  text_layer_set_text(s_title_layer, s_content.title_text);
-  text_layer_set_background_color(s_title_layer, GColorClear);
-  text_layer_set_text_color(s_title_layer, layout->foreground);
-  text_layer_set_font(s_title_layer, fonts_get_system_font(title_font_key));
-  text_layer_set_text_alignment(s_title_layer, GTextAlignmentCenter);
-  scroll_layer_add_child(s_scroll_layer, text_layer_get_layer(s_title_layer));
+  layer_set_frame(text_layer_get_layer(s_title_layer), title_frame);
 
   y_cursor += title_frame.size.h + TITLE_BOTTOM_MARGIN;
 
-  // Hero image
-  s_pdc_image = NULL;
-  s_bitmap_image = NULL;
-  // Only load image if resource_id is valid (non-zero)
-  if (s_content.image_resource_id != 0) {
-    if (s_content.image_type == DETAILS_IMAGE_TYPE_BITMAP) {
-      s_bitmap_image = gbitmap_create_with_resource(s_content.image_resource_id);
-    } else {
-      s_pdc_image = gdraw_command_image_create_with_resource(s_content.image_resource_id);
-    }
-  }
-  // Use actual image size for current content
+  // Hero image - use actual image size for current content
   const GSize hero_size = prv_get_image_size();
   const int16_t image_layer_height = hero_size.h + HERO_IMAGE_FRAME_PADDING;
 
@@ -446,7 +456,8 @@ static void prv_window_load(Window *window) {
     // Calculate available space on each side of the centered image
     const int16_t left_space = image_start_x - GRID_ROUND_SIDE_PADDING;
     const int16_t right_space = bounds.size.w - (image_start_x + hero_size.w) - GRID_ROUND_SIDE_PADDING;
-    const int16_t grid_column_width = (left_space < right_space ? left_space : right_space) - GRID_MARGIN;
+    const int16_t grid_space = (left_space < right_space ? left_space : right_space) - GRID_MARGIN;
+    const int16_t grid_column_width = grid_space > 0 ? grid_space : 0;
     
     // Position grid columns on either side of the centered image
     const int16_t left_grid_x = GRID_ROUND_SIDE_PADDING;
@@ -459,100 +470,51 @@ static void prv_window_load(Window *window) {
     
     // Image layer dimensions (include padding for drawing)
     const int16_t image_layer_width = hero_size.w + HERO_IMAGE_FRAME_PADDING;
-    const int16_t image_layer_height_round = hero_size.h + HERO_IMAGE_FRAME_PADDING;
     // Position layer so that when drawing function centers image within layer, image is centered in window
     // Drawing function centers at (layer.w/2, layer.h/2) relative to layer origin
     // We want image center at (bounds.size.w/2, bounds.size.h/2)
     const int16_t image_layer_x = image_center_x - (image_layer_width / 2);
-    const int16_t image_layer_y = image_center_y - (image_layer_height_round / 2) - STATUS_BAR_LAYER_HEIGHT;
-
-    // Left column (RISE) - not created for constellations to save memory
-    if (!prv_is_constellation()) {
-      for (int row = 0; row < GRID_ROWS; ++row) {
-        GRect frame = GRect(left_grid_x, grid_y + row * (grid_row_height + GRID_MARGIN), grid_column_width, grid_row_height);
-        s_grid_layers[row][0] = text_layer_create(frame);
-        const char *text = (row == 0 ? s_content.grid_top_left : s_content.grid_bottom_left);
-        text_layer_set_text(s_grid_layers[row][0], text);
-        text_layer_set_background_color(s_grid_layers[row][0], GColorClear);
-        text_layer_set_text_color(s_grid_layers[row][0], layout->foreground);
-        text_layer_set_font(s_grid_layers[row][0], fonts_get_system_font(grid_font_key));
-        text_layer_set_overflow_mode(s_grid_layers[row][0], GTextOverflowModeWordWrap);
-        text_layer_set_text_alignment(s_grid_layers[row][0], GTextAlignmentCenter);
-        scroll_layer_add_child(s_scroll_layer, text_layer_get_layer(s_grid_layers[row][0]));
-      }
-    } else {
-      for (int row = 0; row < GRID_ROWS; ++row) {
-        s_grid_layers[row][0] = NULL;
-      }
+    const int16_t image_layer_y = image_center_y - (image_layer_height / 2) - STATUS_BAR_LAYER_HEIGHT;
+
+    // Left column (RISE) and right column (SET)
+    for (int row = 0; row < GRID_ROWS; ++row) {
+      const int16_t row_y = grid_y + row * (grid_row_height + GRID_MARGIN);
+      prv_set_grid_frame(row, 0, GRect(left_grid_x, row_y, grid_column_width, grid_row_height));
+      prv_set_grid_frame(row, 1, GRect(right_grid_x, row_y, grid_column_width, grid_row_height));
     }
 
     // Image centered in window (horizontally and vertically)
     // Layer is positioned to account for padding, but image itself is perfectly centered
-    s_image_layer = layer_create(GRect(image_layer_x, image_layer_y, image_layer_width, image_layer_height_round));
-    layer_set_update_proc(s_image_layer, prv_draw_image);
-    scroll_layer_add_child(s_scroll_layer, s_image_layer);
-
-    // Right column (SET) - not created for constellations to save memory
-    if (!prv_is_constellation()) {
-      for (int row = 0; row < GRID_ROWS; ++row) {
-        GRect frame = GRect(right_grid_x, grid_y + row * (grid_row_height + GRID_MARGIN), grid_column_width, grid_row_height);
-        s_grid_layers[row][1] = text_layer_create(frame);
-        const char *text = (row == 0 ? s_content.grid_top_right : s_content.grid_bottom_right);
-        text_layer_set_text(s_grid_layers[row][1], text);
-        text_layer_set_background_color(s_grid_layers[row][1], GColorClear);
-        text_layer_set_text_color(s_grid_layers[row][1], layout->foreground);
-        text_layer_set_font(s_grid_layers[row][1], fonts_get_system_font(grid_font_key));
-        text_layer_set_overflow_mode(s_grid_layers[row][1], GTextOverflowModeWordWrap);
-        text_layer_set_text_alignment(s_grid_layers[row][1], GTextAlignmentCenter);
-        scroll_layer_add_child(s_scroll_layer, text_layer_get_layer(s_grid_layers[row][1]));
-      }
-    } else {
-      for (int row = 0; row < GRID_ROWS; ++row) {
-        s_grid_layers[row][1] = NULL;
-      }
-    }
+    layer_set_frame(s_image_layer, GRect(image_layer_x, image_layer_y, image_layer_width, image_layer_height));
 
-    y_cursor = image_layer_y + image_layer_height_round + HERO_IMAGE_BOTTOM_MARGIN;
+    y_cursor = image_layer_y + image_layer_height + HERO_IMAGE_BOTTOM_MARGIN;
+
+    // Detail text placed after image
+    const GRect detail_frame = GRect(side_margin, y_cursor, bounds.size.w - side_margin * 2, 21);
+    layer_set_frame(text_layer_get_layer(s_detail_layer), detail_frame);
+
+    y_cursor += detail_frame.size.h + DETAIL_BOTTOM_MARGIN;
   } else {
-    // Non-round watch: current layout (image, detail text, then grid)
-    s_image_layer = layer_create(GRect(0, y_cursor, bounds.size.w, image_layer_height));
-    layer_set_update_proc(s_image_layer, prv_draw_image);
-    scroll_layer_add_child(s_scroll_layer, s_image_layer);
+    // Non-round watch: image, detail text, then grid
+    layer_set_frame(s_image_layer, GRect(0, y_cursor, bounds.size.w, image_layer_height));
     y_cursor += image_layer_height + HERO_IMAGE_BOTTOM_MARGIN;
 
     // Detail text
-    GRect detail_frame = GRect(side_margin, y_cursor, bounds.size.w - side_margin * 2, FONT_HEIGHT);
-    s_detail_layer = text_layer_create(detail_frame);
-    text_layer_set_text(s_detail_layer, s_content.detail_text);
-    text_layer_set_background_color(s_detail_layer, GColorClear);
-    text_layer_set_text_color(s_detail_layer, layout->foreground);
-    text_layer_set_font(s_detail_layer, fonts_get_system_font(detail_font_key));
-    text_layer_set_overflow_mode(s_detail_layer, GTextOverflowModeWordWrap);
-    text_layer_set_text_alignment(s_detail_layer, GTextAlignmentCenter);
-    scroll_layer_add_child(s_scroll_layer, text_layer_get_layer(s_detail_layer));
+    const GRect detail_frame = GRect(side_margin, y_cursor, bounds.size.w - side_margin * 2, FONT_HEIGHT);
+    layer_set_frame(text_layer_get_layer(s_detail_layer), detail_frame);
 
     y_cursor += detail_frame.size.h + DETAIL_BOTTOM_MARGIN;
 
     // Grid values (2x2)
-    const GRect grid_bounds =
-        GRect(0, y_cursor, bounds.size.w, GRID_ROW_HEIGHT * GRID_ROWS + GRID_MARGIN);
-    prv_create_grid_layers(grid_bounds, fonts_get_system_font(grid_font_key));
-    y_cursor += grid_bounds.size.h;
-  }
-
-  // Detail text (for round watches, placed after image)
-  if (PBL_IF_ROUND_ELSE(1, 0)) {
-    GRect detail_frame = GRect(side_margin, y_cursor, bounds.size.w - side_margin * 2, 21);
-    s_detail_layer = text_layer_create(detail_frame);
-    text_layer_set_text(s_detail_layer, s_content.detail_text);
-    text_layer_set_background_color(s_detail_layer, GColorClear);
-    text_layer_set_text_color(s_detail_layer, layout->foreground);
-    text_layer_set_font(s_detail_layer, fonts_get_system_font(detail_font_key));
-    text_layer_set_overflow_mode(s_detail_layer, GTextOverflowModeWordWrap);
-    text_layer_set_text_alignment(s_detail_layer, GTextAlignmentCenter);
-    scroll_layer_add_child(s_scroll_layer, text_layer_get_layer(s_detail_layer));
-
-    y_cursor += detail_frame.size.h + DETAIL_BOTTOM_MARGIN;
+    const int16_t column_width = (bounds.size.w - GRID_MARGIN * 3) / 2;
+    for (int row = 0; row < GRID_ROWS; ++row) {
+      int16_t x = GRID_MARGIN;
+      for (int col = 0; col < GRID_COLS; ++col) {
+        prv_set_grid_frame(row, col, GRect(x, y_cursor, column_width, GRID_ROW_HEIGHT));
+        x += column_width + GRID_MARGIN;
+      }
+      y_cursor += GRID_ROW_HEIGHT + GRID_MARGIN;
+    }
   }
 
   // Adjust spacing so first page ends at exactly scroll_bounds.size.h
@@ -570,16 +532,8 @@ static void prv_window_load(Window *window) {
   }
 
   // Long-form text after the first "page"
-  GRect long_frame = GRect(LONG_TEXT_SIDE_MARGIN, y_cursor, bounds.size.w - LONG_TEXT_SIDE_MARGIN * 2, bounds.size.h);
-
-  s_long_text_layer = text_layer_create(long_frame);
-  text_layer_set_text(s_long_text_layer, s_content.long_text);
-  text_layer_set_background_color(s_long_text_layer, GColorClear);
-  text_layer_set_text_color(s_long_text_layer, layout->foreground);
-  text_layer_set_font(s_long_text_layer, fonts_get_system_font(detail_font_key));
-  text_layer_set_overflow_mode(s_long_text_layer, GTextOverflowModeWordWrap);
-  text_layer_set_text_alignment(s_long_text_layer, PBL_IF_ROUND_ELSE(GTextAlignmentCenter, GTextAlignmentLeft));
-  scroll_layer_add_child(s_scroll_layer, text_layer_get_layer(s_long_text_layer));
+  const GRect long_frame = GRect(LONG_TEXT_SIDE_MARGIN, y_cursor, bounds.size.w - LONG_TEXT_SIDE_MARGIN * 2, bounds.size.h);
+  layer_set_frame(text_layer_get_layer(s_long_text_layer), long_frame);
 
   y_cursor += bounds.size.h + GRID_MARGIN;
 
@@ -588,10 +542,101 @@ static void prv_window_load(Window *window) {
   const int16_t content_height = y_cursor > min_height ? y_cursor : min_height;
   scroll_layer_set_content_size(s_scroll_layer, GSize(bounds.size.w, content_height));
 
+  layer_mark_dirty(scroll_layer_get_layer(s_scroll_layer));
+}
+
+static void prv_window_load(Window *window) {
+  const Layout *layout = layout_get();
+  Layer *window_layer = window_get_root_layer(window);
+  const GRect bounds = layer_get_bounds(window_layer);
+  s_page_height = bounds.size.h;
+
+  s_status_layer = status_bar_layer_create();
+  status_bar_layer_set_colors(s_status_layer, layout->background, layout->foreground);
+  layer_add_child(window_layer, status_bar_layer_get_layer(s_status_layer));
+
+  // Create action indicator (initially hidden during loading)
+  s_action_indicator_layer = action_indicator_create(bounds);
+  action_indicator_add_to_window(window);
+  action_indicator_set_visible(!prv_is_loading());
+
+  const GRect scroll_bounds = GRect(bounds.origin.x,
+                                    bounds.origin.y + STATUS_BAR_LAYER_HEIGHT,
+                                    bounds.size.w, bounds.size.h - STATUS_BAR_LAYER_HEIGHT);
+  s_scroll_layer = scroll_layer_create(scroll_bounds);
+  scroll_layer_set_shadow_hidden(s_scroll_layer, true);
+  scroll_layer_set_context(s_scroll_layer, s_scroll_layer);
+  scroll_layer_set_callbacks(
+      s_scroll_layer,
+      (ScrollLayerCallbacks){
+          .click_config_provider = prv_click_config_provider,
+          .content_offset_changed_handler = prv_content_offset_changed_handler,
+      });
+  scroll_layer_set_click_config_onto_window(s_scroll_layer, window);
+  scroll_layer_set_paging(s_scroll_layer, true);
+
+  // Set up content indicator
+  s_content_indicator = scroll_layer_get_content_indicator(s_scroll_layer);
+  
+  // Create a layer for the indicator background (black background)
+  const int16_t indicator_height = 20;
+  const GRect indicator_frame = GRect(0, scroll_bounds.size.h - indicator_height, 
+                                      scroll_bounds.size.w, indicator_height);
+  s_content_indicator_layer = layer_create(indicator_frame);
+  layer_set_update_proc(s_content_indicator_layer, prv_draw_content_indicator_background);
+  layer_add_child(scroll_layer_get_layer(s_scroll_layer), s_content_indicator_layer);
+  
+  // Configure the down direction with white arrow
+  ContentIndicatorConfig indicator_config = {
+    .layer = s_content_indicator_layer,
+    .times_out = false,
+    .alignment = GAlignCenter,
+    .colors = {
+      .foreground = GColorWhite,
+      .background = GColorBlack,
+    }
+  };
+  content_indicator_configure_direction(s_content_indicator, ContentIndicatorDirectionDown, &indicator_config);
+  
+  // Initially hidden (will be shown when at top via callback)
+  content_indicator_set_content_available(s_content_indicator, ContentIndicatorDirectionDown, false);
+
+  // The layer tree is the same for every body; prv_layout_content places it
+  s_title_layer = prv_create_text_layer(s_content.title_text, title_font_key, GTextAlignmentCenter);
+
+  prv_release_image();
+  prv_acquire_image();
+  s_image_layer = layer_create(GRectZero);
+  layer_set_update_proc(s_image_layer, prv_draw_image);
+  scroll_layer_add_child(s_scroll_layer, s_image_layer);
+
+  s_detail_layer = prv_create_text_layer(s_content.detail_text, detail_font_key, GTextAlignmentCenter);
+
+  // Grid layers exist for constellations too (hidden) so switching bodies never rebuilds the window
+  const char *grid_text[GRID_ROWS][GRID_COLS] = {
+    {s_content.grid_top_left, s_content.grid_top_right},
+    {s_content.grid_bottom_left, s_content.grid_bottom_right}
+  };
+  for (int row = 0; row < GRID_ROWS; ++row) {
+    for (int col = 0; col < GRID_COLS; ++col) {
+      s_grid_layers[row][col] = prv_create_text_layer(grid_text[row][col], grid_font_key, GTextAlignmentCenter);
+    }
+  }
+
+  s_long_text_layer = prv_create_text_layer(s_content.long_text, detail_font_key,
+                                            PBL_IF_ROUND_ELSE(GTextAlignmentCenter, GTextAlignmentLeft));
+
+  s_layout_is_constellation = prv_is_constellation();
+  prv_layout_content();
+
   layer_add_child(window_layer, scroll_layer_get_layer(s_scroll_layer));
+
+  heap_stats_record(HeapSiteDetails, HeapEventLoad);
 }
 
 static void prv_window_unload(Window *window) {
+  heap_stats_record(HeapSiteDetails, HeapEventUnload);
+
   for (int row = 0; row < GRID_ROWS; ++row) {
     for (int col = 0; col < GRID_COLS; ++col) {
       if (s_grid_layers[row][col]) {
@@ -617,14 +662,10 @@ static void prv_window_unload(Window *window) {
     layer_destroy(s_image_layer);
     s_image_layer = NULL;
   }
-  if (s_pdc_image) {
-    gdraw_command_image_destroy(s_pdc_image);
-    s_pdc_image = NULL;
-  }
-  if (s_bitmap_image) {
-    gbitmap_destroy(s_bitmap_image);
-    s_bitmap_image = NULL;
-  }
+  // Images stay cached for the next view, within what this platform can spare
+  prv_release_image();
+  image_cache_trim_idle();
+  moon_render_trim_idle();
   if (s_status_layer) {
     status_bar_layer_destroy(s_status_layer);
     s_status_layer = NULL;
@@ -646,10 +687,6 @@ void details_init(void) {
     return;
   }
 
-  // Initialize bodymsg system for body data requests and declination handling
-  bodymsg_init();
-  bodymsg_register_callbacks();
-  
   s_content = s_loading_content;
   s_is_loading = false;
   s_window = window_create();
@@ -678,10 +715,6 @@ void details_deinit(void) {
   s_status_layer = NULL;
   s_content_indicator_layer = NULL;
   s_content_indicator = NULL;
-  
-  // Deinitialize bodymsg system
-  bodymsg_deregister_callbacks();
-  bodymsg_deinit();
 }
 
 void details_show(const DetailsContent *content) {
@@ -689,9 +722,6 @@ void details_show(const DetailsContent *content) {
     details_init();
   }
 
-  // Check if body type is changing (regular body <-> constellation)
-  bool old_is_constellation = prv_is_constellation();
-  
   // Update content
   if (content) {
     s_content = *content;
@@ -705,25 +735,10 @@ void details_show(const DetailsContent *content) {
 
     // Show action indicator now that loading is complete
     action_indicator_set_visible(true);
-
-    // Deregister bodymsg callbacks after successfully receiving body data
-    // This allows other windows (like events) to take control of message handling
-    bodymsg_deregister_callbacks();
-    HUBBLE_LOG(APP_LOG_LEVEL_INFO, "Details received body data, deregistered bodymsg callbacks");
   }
 
-  bool new_is_constellation = prv_is_constellation();
-  
-  // Check if window is already visible
-  bool window_visible = window_stack_contains_window(s_window);
-
-  if (window_visible && old_is_constellation != new_is_constellation) {
-    // Body type changed, need to recreate window with correct layout
-    // Remove and re-push the window - handlers will automatically unload/load
-    window_stack_remove(s_window, false);
-    window_stack_push(s_window, false);
-  } else if (window_visible) {
-    // Window is already visible, update the content in place
+  if (window_stack_contains_window(s_window)) {
+    // Window is already visible, update the content (and layout, if the body type changed) in place
     prv_update_content_display();
   } else {
     // Window not visible, push it to show
@@ -736,12 +751,6 @@ void details_show_body(int body_id) {
     details_init();
   }
 
-  // Ensure callbacks are registered before requesting body data
-  // (They may have been deregistered after a previous request)
-  if (bodymsg_is_ready()) {
-    bodymsg_register_callbacks();
-  }
-
   // Request body data from the phone
   if (bodymsg_request_body(body_id)) {
     // Show window with loading content
@@ -751,7 +760,12 @@ void details_show_body(int body_id) {
     s_is_loading = true;
     // Hide action indicator during loading
     action_indicator_set_visible(false);
-    window_stack_push(s_window, true);
+    if (window_stack_contains_window(s_window)) {
+      // Reuse the loaded layer tree rather than rebuilding the window
+      prv_update_content_display();
+    } else {
+      window_stack_push(s_window, true);
+    }
   } else {
     HUBBLE_LOG(APP_LOG_LEVEL_ERROR, "Failed to request body data for ID %d", body_id);
     // Don't show window if request fails
@@ -759,6 +773,21 @@ void details_show_body(int body_id) {
   }
 }
 
+void details_refresh(void) {
+  if (!s_window || s_content.body_id < 0) {
+    return;
+  }
+
+  // Keep the current data on screen until the phone answers; details_show
+  // then updates the existing layers
+  if (bodymsg_request_body(s_content.body_id)) {
+    s_is_loading = true;
+    action_indicator_set_visible(false);
+  } else {
+    HUBBLE_LOG(APP_LOG_LEVEL_ERROR, "Failed to refresh body data for ID %d", s_content.body_id);
+  }
+}
+
 void details_hide(void) {
   if (s_window) {
     window_stack_remove(s_window, true);
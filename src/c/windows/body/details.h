@@ -5,10 +5,13 @@
 #pragma once
 
 #include <pebble.h>
+#include "locator.h"
 
 typedef enum {
   DETAILS_IMAGE_TYPE_PDC,
   DETAILS_IMAGE_TYPE_BITMAP,
+  DETAILS_IMAGE_TYPE_FIGURE,  // Constellation figure drawn from the shared table
+  DETAILS_IMAGE_TYPE_MOON,    // Moon rendered for moon_phase_cdeg
 } DetailsImageType;
 
 typedef struct {
@@ -24,7 +27,10 @@ typedef struct {
   int16_t azimuth_deg;  // Azimuth in degrees (0-360)
   int16_t altitude_deg; // Altitude in degrees (-90 to 90)
   int16_t illumination_x10; // Illumination as magnitude * 10 (-256 to 255)
+  uint16_t moon_phase_cdeg;  // Moon phase angle in hundredths of a degree: 0 new, 18000 full, 36000 wraps to new
   int body_id;  // Body ID for favoriting (-1 if not applicable)
+  bool has_track;     // True if track holds an equatorial snapshot from the phone
+  TargetTrack track;  // Lets the locator propagate alt/az after the snapshot ages
 } DetailsContent;
 
 void details_init(void);
@@ -36,6 +42,9 @@ void details_show(const DetailsContent *content);
 // Show details for a specific body by requesting data from the phone
 void details_show_body(int body_id);
 
+// Re-request the shown body and update the window in place when it arrives
+void details_refresh(void);
+
 void details_hide(void);
 
 // Get the current details content (for use by options menu)
@@ -1,10 +1,15 @@
 #include "locator.h"
-#include "../../providers/altitude_provider.h"
-#include "../../providers/azimuth_provider.h"
+#include "../../providers/governor.h"
+#include "../../providers/sensor_hub.h"
 #include "../../style.h"
 #include "../../utils/settings.h"
 #include "../../utils/bodymsg.h"
+#include "../../utils/compass_worker.h"
+#include "../../utils/declination.h"
+#include "../../utils/heap_stats.h"
 #include "../../utils/logging.h"
+#include "../../utils/body_info.h"
+#include "../../utils/sky.h"
 #include <pebble.h>
 #include <string.h>
 
@@ -18,6 +23,29 @@
 #define CORNER_LABEL_PADDING_RECT 0
 #define CORNER_LABEL_PADDING_ROUND 20
 
+// Sensor callbacks can arrive faster than the display needs; cap redraws
+#define LOCATOR_MAX_FPS 10
+#define LOCATOR_FRAME_MS (1000 / LOCATOR_MAX_FPS)
+
+// Target and overlay positions are re-propagated this often
+#define TRACK_INTERVAL_MS 1000
+
+// Overlay: bodies further than this from the pointing direction (either axis) are culled,
+// matching the reticle's +/-90° span; only the closest few get a name
+#define OVERLAY_FOV_DEG 90
+#define OVERLAY_MAX_LABELS 3
+#define OVERLAY_DOT_RADIUS 2
+
+// Identify mode: name of the body under the crosshair, with a short tick when it changes
+#define IDENTIFY_TICK_MS 25
+#define IDENTIFY_NONE -1
+
+#if defined(PBL_COLOR)
+#define RETICLE_BACKGROUND_PIXEL GColorBlackARGB8
+#else
+#define RETICLE_BACKGROUND_PIXEL 0
+#endif
+
 static Window *s_window;
 static Layer *s_crosshair_layer;
 static TextLayer *s_target_grid[GRID_ROWS][GRID_COLS];
@@ -28,12 +56,58 @@ static ActionBarLayer *s_action_bar;
 static GBitmap *s_icon_light_on;
 static GBitmap *s_icon_light_off;
 static bool s_light_enabled;
+static AppTimer *s_light_timer;
+
+static SensorHubSubscription *s_altitude_subscription;
+static SensorHubSubscription *s_azimuth_subscription;
+static SensorHubSubscription *s_calibration_subscription;
+
+// Static reticle captured from the frame buffer on first draw, then blitted
+static GBitmap *s_reticle_bitmap;
+static GRect s_reticle_rect;
+
+// Frame budget and what is currently on screen, to skip redundant redraws
+static AppTimer *s_frame_timer;
+static time_t s_last_frame_s;
+static uint16_t s_last_frame_ms;
+static GPoint s_drawn_target_offset;
+static bool s_target_drawn;
+
+typedef struct {
+  int16_t target_altitude_deg;
+  int16_t target_azimuth_deg;
+  int16_t current_altitude_deg;
+  int16_t current_azimuth_deg;
+  bool azimuth_shown;
+  bool declination_applied;
+} LabelState;
+
+static LabelState s_shown_labels;
+static bool s_labels_shown;
+
+static TargetTrack s_track;
+static bool s_tracking;
+static AppTimer *s_track_timer;
+
+// Multi-target overlay: snapshot bodies propagated to alt/az once per track tick
+typedef struct {
+  uint8_t body_id;
+  int16_t altitude_deg;
+  int16_t azimuth_deg;
+} OverlayObject;
+
+static OverlayObject s_overlay[SKY_MAX_OBJECTS];
+static uint8_t s_overlay_count;
+static bool s_overlay_enabled;
+static GBitmap *s_icon_track;
+
+static bool s_identify_enabled;
+static int16_t s_identified_body = IDENTIFY_NONE;
 #ifdef DEMO_MODE
 static bool s_is_calibrated = true;  // Demo mode: Always calibrated
 #else
 static bool s_is_calibrated;
 #endif
-static bool s_declination_requested = false;
 
 #ifdef DEMO_MODE
 // Demo mode: Target Cassiopeia at alt 69, az 326
@@ -48,9 +122,16 @@ static int16_t s_current_azimuth_deg = 0;
 #endif
 
 static void prv_update_labels(void);
-static void prv_request_declination(void);
-static void prv_on_declination_received(int8_t declination);
-static void prv_inbox_received_callback(DictionaryIterator *iter, void *context);
+static void prv_request_refresh(void);
+static void prv_start_tracking(void);
+static void prv_stop_tracking(void);
+static void prv_update_overlay(void);
+static void prv_on_declination_received(void);
+static bool prv_handle_message(DictionaryIterator *iter);
+
+static const BodymsgHandlers s_message_handlers = {
+  .received = prv_handle_message,
+};
 
 static int16_t prv_normalize_azimuth_delta(int16_t delta) {
   // Wrap into [-180, 180] for smallest rotation distance.
@@ -63,73 +144,50 @@ static int16_t prv_normalize_azimuth_delta(int16_t delta) {
   return delta;
 }
 
-static void prv_request_declination(void) {
-#if defined(PBL_COMPASS)
-  if (s_declination_requested) {
-    return;  // Already requested
+static bool prv_handle_message(DictionaryIterator *iter) {
+  // Check if this is a DECLINATION response or push (stored by the declination module)
+  if (declination_handle_message(iter)) {
+    prv_on_declination_received();
+    return true;
   }
 
-  DictionaryIterator *out_iter;
-  AppMessageResult result = app_message_outbox_begin(&out_iter);
-  
-  if (result != APP_MSG_OK) {
-    HUBBLE_LOG(APP_LOG_LEVEL_ERROR, "Failed to begin outbox for declination request: %d", (int)result);
-    return;
+  // Multi-body snapshot for the overlay
+  if (sky_handle_message(iter)) {
+    if (s_overlay_enabled) {
+      prv_update_overlay();
+    }
+    // The snapshot carries the observer, which may be far from the declination's
+    declination_request_if_stale();
+    return true;
   }
 
-  // Send REQUEST_DECLINATION message (value doesn't matter, just the key)
-  int dummy_value = 1;
-  dict_write_int(out_iter, MESSAGE_KEY_REQUEST_DECLINATION, &dummy_value, sizeof(int), true);
-  
-  result = app_message_outbox_send();
-  if (result == APP_MSG_OK) {
-    s_declination_requested = true;
-    HUBBLE_LOG(APP_LOG_LEVEL_INFO, "Requested magnetic declination");
-  } else {
-    HUBBLE_LOG(APP_LOG_LEVEL_ERROR, "Failed to send declination request: %d", (int)result);
-  }
-#endif
+  // Anything else, like worker settings, is bodymsg's
+  return false;
 }
 
-static void prv_inbox_received_callback(DictionaryIterator *iter, void *context) {
-  // Check if this is a DECLINATION response
-  Tuple *declination_tuple = dict_find(iter, MESSAGE_KEY_DECLINATION);
-  if (declination_tuple) {
-    // Declination is sent as rounded integer degrees
-    int8_t declination = (int8_t)declination_tuple->value->int16;
-
-    prv_on_declination_received(declination);
-  }
-}
-
-static void prv_on_declination_received(int8_t declination) {
-  LocalSettings *settings = settings_get();
-  settings->magnetic_declination = declination;
-  settings_save();
-  
-  HUBBLE_LOG(APP_LOG_LEVEL_INFO, "Stored magnetic declination: %d degrees", declination);
-  prv_update_labels();
-  
-  // Trigger crosshair redraw to update target indicator position
-  if (s_crosshair_layer) {
-    layer_mark_dirty(s_crosshair_layer);
-  }
+static void prv_on_declination_received(void) {
+  // Labels and target indicator both depend on the declination
+  prv_request_refresh();
 }
 
-static void prv_on_altitude(int16_t altitude_deg) {
+static void prv_on_altitude(int16_t altitude_deg, void *context) {
+  (void)context;
   locator_set_current_altitude(altitude_deg);
 }
 
 #if defined(PBL_COMPASS)
-static void prv_on_azimuth(int16_t azimuth_deg) {
+static void prv_on_azimuth(int16_t azimuth_deg, void *context) {
+  (void)context;
   locator_set_current_azimuth(azimuth_deg);
 }
 
-static void prv_on_calibration(bool is_calibrated) {
-  s_is_calibrated = is_calibrated;
+static void prv_on_calibration(int16_t is_calibrated, void *context) {
+  (void)context;
+  s_is_calibrated = is_calibrated != 0;
 
   // Only update UI if layers are initialized
   if (s_crosshair_layer && s_calibration_layer) {
+    s_labels_shown = false;
     prv_update_labels();
     layer_set_hidden(s_crosshair_layer, !is_calibrated);
     layer_set_hidden(text_layer_get_layer(s_calibration_layer), is_calibrated);
@@ -142,43 +200,70 @@ static void prv_update_labels(void) {
     return;
   }
 
+  LabelState state;
+  memset(&state, 0, sizeof(state));
+  state.target_altitude_deg = s_target.altitude_deg;
+  state.target_azimuth_deg = s_target.azimuth_deg;
+  state.current_altitude_deg = s_current_altitude_deg;
+
+#if defined(PBL_COMPASS)
+  LocalSettings *settings = settings_get();
+
+  #ifdef DEMO_MODE
+  settings->magnetic_declination = 0;
+  #endif
+
+  if (s_current_grid[1][1] && s_is_calibrated) {
+    int16_t corrected_azimuth = s_current_azimuth_deg;
+
+    // Only apply magnetic declination if it's not the unset value (255)
+    state.declination_applied = settings->magnetic_declination != 255;
+    if (state.declination_applied) {
+      corrected_azimuth += settings->magnetic_declination;
+    }
+
+    // Normalize to 0-359 range
+    while (corrected_azimuth < 0) corrected_azimuth += 360;
+    while (corrected_azimuth >= 360) corrected_azimuth -= 360;
+
+    state.current_azimuth_deg = corrected_azimuth;
+    state.azimuth_shown = true;
+  }
+#endif
+
+  // Formatting and relayout of text are the expensive part; skip both when nothing changed
+  if (s_labels_shown && memcmp(&state, &s_shown_labels, sizeof(state)) == 0) {
+    return;
+  }
+
   static char s_target_alt_text[8];
   static char s_target_az_text[8];
   static char s_current_alt_text[8];
 
-  snprintf(s_target_alt_text, sizeof(s_target_alt_text), "%d°", s_target.altitude_deg);
-  snprintf(s_target_az_text, sizeof(s_target_az_text), "%d°", s_target.azimuth_deg);
-  snprintf(s_current_alt_text, sizeof(s_current_alt_text), "%d°", s_current_altitude_deg);
-
-  text_layer_set_text(s_target_grid[1][0], s_target_alt_text);
-  text_layer_set_text(s_target_grid[1][1], s_target_az_text);
-  text_layer_set_text(s_current_grid[1][0], s_current_alt_text);
+  if (!s_labels_shown || state.target_altitude_deg != s_shown_labels.target_altitude_deg) {
+    snprintf(s_target_alt_text, sizeof(s_target_alt_text), "%d°", state.target_altitude_deg);
+    text_layer_set_text(s_target_grid[1][0], s_target_alt_text);
+  }
+  if (!s_labels_shown || state.target_azimuth_deg != s_shown_labels.target_azimuth_deg) {
+    snprintf(s_target_az_text, sizeof(s_target_az_text), "%d°", state.target_azimuth_deg);
+    text_layer_set_text(s_target_grid[1][1], s_target_az_text);
+  }
+  if (!s_labels_shown || state.current_altitude_deg != s_shown_labels.current_altitude_deg) {
+    snprintf(s_current_alt_text, sizeof(s_current_alt_text), "%d°", state.current_altitude_deg);
+    text_layer_set_text(s_current_grid[1][0], s_current_alt_text);
+  }
 
 #if defined(PBL_COMPASS)
-  if (s_current_grid[1][1]) {
-    if (s_is_calibrated) {
-      LocalSettings *settings = settings_get();
-      
-      int16_t corrected_azimuth = s_current_azimuth_deg;
-      
-      // Only apply magnetic declination if it's not the unset value (255)
-      if (settings->magnetic_declination != 255) {
-        corrected_azimuth += settings->magnetic_declination;
-      }
-      
-      // Normalize to 0-359 range
-      while (corrected_azimuth < 0) corrected_azimuth += 360;
-      while (corrected_azimuth >= 360) corrected_azimuth -= 360;
-      
-      #ifdef DEMO_MODE
-      settings->magnetic_declination = 0;
-      #endif
-
+  if (s_current_grid[1][1] &&
+      (!s_labels_shown || state.azimuth_shown != s_shown_labels.azimuth_shown ||
+       state.current_azimuth_deg != s_shown_labels.current_azimuth_deg ||
+       state.declination_applied != s_shown_labels.declination_applied)) {
+    if (state.azimuth_shown) {
       static char s_current_az_text[20];
-      if (settings->magnetic_declination != 255) {
-        snprintf(s_current_az_text, sizeof(s_current_az_text), "%d°😊", corrected_azimuth);
+      if (state.declination_applied) {
+        snprintf(s_current_az_text, sizeof(s_current_az_text), "%d°😊", state.current_azimuth_deg);
       } else {
-        snprintf(s_current_az_text, sizeof(s_current_az_text), "%d°", corrected_azimuth);
+        snprintf(s_current_az_text, sizeof(s_current_az_text), "%d°", state.current_azimuth_deg);
       }
       text_layer_set_text(s_current_grid[1][1], s_current_az_text);
     } else {
@@ -186,6 +271,9 @@ static void prv_update_labels(void) {
     }
   }
 #endif
+
+  s_shown_labels = state;
+  s_labels_shown = true;
 }
 
 static void prv_update_action_icons(void) {
@@ -194,28 +282,92 @@ static void prv_update_action_icons(void) {
   }
   action_bar_layer_set_icon(s_action_bar, BUTTON_ID_UP,
                             s_light_enabled ? s_icon_light_on : s_icon_light_off);
+#if defined(PBL_COMPASS)
+  action_bar_layer_set_icon(s_action_bar, BUTTON_ID_SELECT, s_icon_track);
+#endif
+}
+
+static void prv_set_light(bool enabled);
+
+static void prv_light_timeout_callback(void *context) {
+  (void)context;
+  s_light_timer = NULL;
+  prv_set_light(false);
+}
+
+static void prv_set_light(bool enabled) {
+  if (s_light_timer) {
+    app_timer_cancel(s_light_timer);
+    s_light_timer = NULL;
+  }
+
+  s_light_enabled = enabled;
+  light_enable(enabled);
+  if (enabled) {
+    // Don't let a forgotten backlight drain the battery during long sessions
+    s_light_timer = app_timer_register(governor_get_light_timeout_ms(), prv_light_timeout_callback, NULL);
+  }
+  prv_update_action_icons();
 }
 
 static void prv_light_toggle_click_handler(ClickRecognizerRef recognizer, void *context) {
   (void)recognizer;
   (void)context;
-  s_light_enabled = !s_light_enabled;
-  light_enable(s_light_enabled);
-  prv_update_action_icons();
+  prv_set_light(!s_light_enabled);
 }
 
+#if defined(PBL_COMPASS)
+// SELECT cycles target only -> overlay -> overlay with identification -> target only
+static void prv_overlay_toggle_click_handler(ClickRecognizerRef recognizer, void *context) {
+  (void)recognizer;
+  (void)context;
+  if (!s_overlay_enabled) {
+    s_overlay_enabled = true;
+  } else if (!s_identify_enabled) {
+    s_identify_enabled = true;
+  } else {
+    s_overlay_enabled = false;
+    s_identify_enabled = false;
+  }
+  s_identified_body = IDENTIFY_NONE;
+
+  if (s_overlay_enabled) {
+    // One snapshot covers the whole sky; positions are propagated locally after that
+    if (!sky_snapshot_is_fresh()) {
+      sky_request_snapshot();
+    }
+    prv_update_overlay();
+    prv_start_tracking();
+  } else if (s_crosshair_layer) {
+    layer_mark_dirty(s_crosshair_layer);
+  }
+}
+#endif
+
 static void prv_click_config_provider(void *context) {
   (void)context;
   window_single_click_subscribe(BUTTON_ID_UP, prv_light_toggle_click_handler);
+#if defined(PBL_COMPASS)
+  window_single_click_subscribe(BUTTON_ID_SELECT, prv_overlay_toggle_click_handler);
+#endif
 }
 
-static void prv_draw_crosshair(Layer *layer, GContext *ctx) {
-  const GRect bounds = layer_get_bounds(layer);
-  const GPoint center = grect_center_point(&bounds);
-  const uint16_t radius = bounds.size.w < bounds.size.h ? bounds.size.w / 4 : bounds.size.h / 4;
+static uint16_t prv_reticle_radius(GRect bounds) {
+  return bounds.size.w < bounds.size.h ? bounds.size.w / 4 : bounds.size.h / 4;
+}
+
+// Bounding box of everything prv_draw_reticle touches, in layer coordinates
+static GRect prv_reticle_rect(GRect bounds, GPoint center, uint16_t radius) {
+#if defined(PBL_COMPASS)
+  return GRect(center.x - radius - 1, center.y - radius - 1, radius * 2 + 3, radius * 2 + 3);
+#else
+  return GRect(bounds.origin.x, center.y - radius - 1, bounds.size.w, radius * 2 + 3);
+#endif
+}
 
+static void prv_draw_reticle(GContext *ctx, GRect bounds, GPoint center, uint16_t radius) {
   graphics_context_set_stroke_color(ctx, GColorWhite);
-  graphics_context_set_fill_color(ctx, GColorBlack);
+  graphics_context_set_fill_color(ctx, GColorWhite);
 
 #if defined(PBL_COMPASS)
   // Concentric circles
@@ -237,11 +389,65 @@ static void prv_draw_crosshair(Layer *layer, GContext *ctx) {
 
   // Small center dot
   graphics_fill_circle(ctx, center, 2);
+}
+
+static uint8_t prv_read_pixel(const GBitmapDataRowInfo *row, int16_t x, GBitmapFormat format) {
+  if (x < row->min_x || x > row->max_x) {
+    // Outside a round display's visible span
+    return RETICLE_BACKGROUND_PIXEL;
+  }
+  if (format == GBitmapFormat1Bit) {
+    return (row->data[x / 8] >> (x % 8)) & 1;
+  }
+  return row->data[x];
+}
+
+static void prv_write_pixel(const GBitmapDataRowInfo *row, int16_t x, uint8_t pixel, GBitmapFormat format) {
+  if (format == GBitmapFormat1Bit) {
+    if (pixel) {
+      row->data[x / 8] |= (uint8_t)(1 << (x % 8));
+    } else {
+      row->data[x / 8] &= (uint8_t)~(1 << (x % 8));
+    }
+  } else {
+    row->data[x] = pixel;
+  }
+}
+
+// Copy the freshly drawn reticle out of the frame buffer. Only the window background
+// lies beneath it (labels are above this layer), so the copy is exactly the reticle.
+static void prv_cache_reticle(GContext *ctx, Layer *layer, GRect rect) {
+  GBitmap *frame_buffer = graphics_capture_frame_buffer(ctx);
+  if (!frame_buffer) {
+    return;
+  }
+
+  GBitmapFormat format = gbitmap_get_format(frame_buffer);
+  const GBitmapFormat source_format = format;
+  if (format == GBitmapFormat8BitCircular) {
+    format = GBitmapFormat8Bit;
+  }
+
+  // Layer is a direct child of the full-screen root layer
+  const GPoint origin = layer_get_frame(layer).origin;
+  s_reticle_bitmap = gbitmap_create_blank(rect.size, format);
+  if (s_reticle_bitmap) {
+    for (int16_t y = 0; y < rect.size.h; y++) {
+      const GBitmapDataRowInfo src = gbitmap_get_data_row_info(frame_buffer, origin.y + rect.origin.y + y);
+      const GBitmapDataRowInfo dst = gbitmap_get_data_row_info(s_reticle_bitmap, y);
+      for (int16_t x = 0; x < rect.size.w; x++) {
+        const uint8_t pixel = prv_read_pixel(&src, origin.x + rect.origin.x + x, source_format);
+        prv_write_pixel(&dst, x, pixel, format);
+      }
+    }
+  }
+
+  graphics_release_frame_buffer(ctx, frame_buffer);
+}
 
-  // Target indicator: offset from center by current vs. target deltas.
-  const int16_t delta_alt = s_target.altitude_deg - s_current_altitude_deg;
 #if defined(PBL_COMPASS)
-  // Apply magnetic declination correction to current azimuth
+// Current heading with magnetic declination applied when known
+static int16_t prv_corrected_current_azimuth(void) {
   LocalSettings *settings = settings_get();
   int16_t corrected_current_azimuth = s_current_azimuth_deg;
   
@@ -249,15 +455,18 @@ static void prv_draw_crosshair(Layer *layer, GContext *ctx) {
   if (settings->magnetic_declination != 255) {
     corrected_current_azimuth += settings->magnetic_declination;
   }
-  
-  const int16_t delta_az = prv_normalize_azimuth_delta(s_target.azimuth_deg - corrected_current_azimuth);
+  return corrected_current_azimuth;
+}
 #endif
 
-  // Map degrees to pixels using the crosshair radius; clamp to stay on the reticle.
+// Reticle offset for a sky position relative to the current pointing direction.
+// Map degrees to pixels using the crosshair radius; clamp to stay on the reticle.
+static GPoint prv_sky_offset(int16_t delta_alt, int16_t delta_az, uint16_t radius) {
   const int16_t max_span_deg = 90;  // map +/-90° to full radius
 #if defined(PBL_COMPASS)
   int16_t dx = (int16_t)((radius * delta_az) / max_span_deg);
 #else
+  (void)delta_az;
   int16_t dx = 0;
 #endif
   int16_t dy = (int16_t)((-radius * delta_alt) / max_span_deg);  // negative to move up for positive altitude
@@ -266,8 +475,156 @@ static void prv_draw_crosshair(Layer *layer, GContext *ctx) {
   if (dy > (int16_t)radius) dy = radius;
   if (dy < -(int16_t)radius) dy = -(int16_t)radius;
 
+  return GPoint(dx, dy);
+}
+
+// Target indicator offset from the reticle center for the current vs. target deltas
+static GPoint prv_target_offset(uint16_t radius) {
+  const int16_t delta_alt = s_target.altitude_deg - s_current_altitude_deg;
+#if defined(PBL_COMPASS)
+  const int16_t delta_az = prv_normalize_azimuth_delta(s_target.azimuth_deg - prv_corrected_current_azimuth());
+#else
+  const int16_t delta_az = 0;
+#endif
+  return prv_sky_offset(delta_alt, delta_az, radius);
+}
+
+#if defined(PBL_COMPASS)
+// Plot every snapshot body inside the reticle's span; name the nearest few
+static void prv_draw_overlay(GContext *ctx, GPoint center, uint16_t radius) {
+  const int16_t current_azimuth = prv_corrected_current_azimuth();
+  // Azimuth differences shrink toward the zenith; scale them for the distance ranking
+  const int32_t cos_alt = cos_lookup(DEG_TO_TRIGANGLE(s_current_altitude_deg));
+
+  uint8_t nearest[OVERLAY_MAX_LABELS];
+  int32_t nearest_distance[OVERLAY_MAX_LABELS];
+  GPoint nearest_point[OVERLAY_MAX_LABELS];
+  uint8_t nearest_count = 0;
+
+  graphics_context_set_fill_color(ctx, GColorWhite);
+
+  for (uint8_t i = 0; i < s_overlay_count; i++) {
+    const OverlayObject *object = &s_overlay[i];
+    const int16_t delta_alt = object->altitude_deg - s_current_altitude_deg;
+    const int16_t delta_az = prv_normalize_azimuth_delta(object->azimuth_deg - current_azimuth);
+
+    // Cheap field-of-view cull before any drawing
+    if (delta_alt > OVERLAY_FOV_DEG || delta_alt < -OVERLAY_FOV_DEG ||
+        delta_az > OVERLAY_FOV_DEG || delta_az < -OVERLAY_FOV_DEG) {
+      continue;
+    }
+
+    const GPoint offset = prv_sky_offset(delta_alt, delta_az, radius);
+    const GPoint point = GPoint(center.x + offset.x, center.y + offset.y);
+    graphics_fill_circle(ctx, point, OVERLAY_DOT_RADIUS);
+
+    // Keep the closest few, sorted, for labelling
+    const int32_t scaled_az = (delta_az * cos_alt) / TRIG_MAX_RATIO;
+    const int32_t distance = delta_alt * delta_alt + scaled_az * scaled_az;
+    uint8_t slot = nearest_count;
+    while (slot > 0 && nearest_distance[slot - 1] > distance) {
+      if (slot < OVERLAY_MAX_LABELS) {
+        nearest[slot] = nearest[slot - 1];
+        nearest_distance[slot] = nearest_distance[slot - 1];
+        nearest_point[slot] = nearest_point[slot - 1];
+      }
+      slot--;
+    }
+    if (slot < OVERLAY_MAX_LABELS) {
+      nearest[slot] = object->body_id;
+      nearest_distance[slot] = distance;
+      nearest_point[slot] = point;
+      if (nearest_count < OVERLAY_MAX_LABELS) {
+        nearest_count++;
+      }
+    }
+  }
+
+  graphics_context_set_text_color(ctx, GColorWhite);
+  const GFont font = fonts_get_system_font(FONT_KEY_GOTHIC_14);
+  for (uint8_t i = 0; i < nearest_count; i++) {
+    const char *name = body_info_get_name(nearest[i]);
+    if (!name) {
+      continue;
+    }
+    const GRect box = GRect(nearest_point[i].x + OVERLAY_DOT_RADIUS + 2, nearest_point[i].y - 9, 70, 16);
+    graphics_draw_text(ctx, name, font, box, GTextOverflowModeTrailingEllipsis, GTextAlignmentLeft, NULL);
+  }
+}
+
+// Caption on the bottom of the reticle ring, boxed so the ring line doesn't cut through it
+static void prv_draw_identified(GContext *ctx, GPoint center, uint16_t radius) {
+  const char *name = s_identified_body != IDENTIFY_NONE ? body_info_get_name(s_identified_body) : NULL;
+  if (!name) {
+    return;
+  }
+
+  const GFont font = fonts_get_system_font(FONT_KEY_GOTHIC_14_BOLD);
+  const GRect max_box = GRect(center.x - radius - 20, center.y + radius - 9, radius * 2 + 40, 18);
+  const GSize size = graphics_text_layout_get_content_size(name, font, max_box,
+                                                           GTextOverflowModeTrailingEllipsis,
+                                                           GTextAlignmentCenter);
+  const GRect box = GRect(center.x - size.w / 2 - 2, max_box.origin.y, size.w + 4, max_box.size.h);
+
+  graphics_context_set_fill_color(ctx, GColorBlack);
+  graphics_fill_rect(ctx, box, 0, GCornerNone);
+  graphics_context_set_text_color(ctx, GColorWhite);
+  graphics_draw_text(ctx, name, font, GRect(box.origin.x, box.origin.y - 2, box.size.w, box.size.h),
+                     GTextOverflowModeTrailingEllipsis, GTextAlignmentCenter, NULL);
+}
+
+// Look up the body nearest the pointing direction; tick the motor when it changes
+static void prv_update_identify(void) {
+  int16_t body = IDENTIFY_NONE;
+  uint8_t body_id;
+  if (s_is_calibrated &&
+      sky_find_nearest(s_current_altitude_deg, prv_corrected_current_azimuth(), time(NULL), &body_id)) {
+    body = body_id;
+  }
+
+  if (body == s_identified_body) {
+    return;
+  }
+  s_identified_body = body;
+
+  if (body != IDENTIFY_NONE) {
+    static const uint32_t s_tick_segments[] = { IDENTIFY_TICK_MS };
+    vibes_enqueue_custom_pattern((VibePattern){
+      .durations = s_tick_segments,
+      .num_segments = ARRAY_LENGTH(s_tick_segments),
+    });
+  }
+}
+#endif
+
+static void prv_draw_crosshair(Layer *layer, GContext *ctx) {
+  const GRect bounds = layer_get_bounds(layer);
+  const GPoint center = grect_center_point(&bounds);
+  const uint16_t radius = prv_reticle_radius(bounds);
+
+  if (s_reticle_bitmap) {
+    graphics_draw_bitmap_in_rect(ctx, s_reticle_bitmap, s_reticle_rect);
+  } else {
+    prv_draw_reticle(ctx, bounds, center, radius);
+    s_reticle_rect = prv_reticle_rect(bounds, center, radius);
+    prv_cache_reticle(ctx, layer, s_reticle_rect);
+  }
+
+#if defined(PBL_COMPASS)
+  if (s_overlay_enabled) {
+    prv_draw_overlay(ctx, center, radius);
+  }
+  if (s_identify_enabled) {
+    prv_draw_identified(ctx, center, radius);
+  }
+#endif
+
+  const GPoint offset = prv_target_offset(radius);
+  s_drawn_target_offset = offset;
+  s_target_drawn = true;
+
   const uint16_t target_radius = radius / 6 > 2 ? radius / 6 : 2;
-  GPoint target_center = GPoint(center.x + dx, center.y + dy);
+  GPoint target_center = GPoint(center.x + offset.x, center.y + offset.y);
 
   graphics_context_set_fill_color(ctx, GColorWhite);
   graphics_fill_circle(ctx, target_center, target_radius);
@@ -275,6 +632,54 @@ static void prv_draw_crosshair(Layer *layer, GContext *ctx) {
   graphics_draw_circle(ctx, target_center, target_radius);
 }
 
+static void prv_refresh(void) {
+  time_ms(&s_last_frame_s, &s_last_frame_ms);
+  prv_update_labels();
+#if defined(PBL_COMPASS)
+  if (s_identify_enabled) {
+    prv_update_identify();
+  }
+#endif
+
+  // Only redraw the crosshair when the target indicator actually moves a pixel.
+  // With the overlay on, any pointing change moves the other bodies too.
+  if (s_crosshair_layer && !layer_get_hidden(s_crosshair_layer)) {
+    if (s_overlay_enabled) {
+      layer_mark_dirty(s_crosshair_layer);
+      return;
+    }
+    const GPoint offset = prv_target_offset(prv_reticle_radius(layer_get_bounds(s_crosshair_layer)));
+    if (!s_target_drawn || !gpoint_equal(&offset, &s_drawn_target_offset)) {
+      layer_mark_dirty(s_crosshair_layer);
+    }
+  }
+}
+
+static void prv_frame_timer_callback(void *context) {
+  (void)context;
+  s_frame_timer = NULL;
+  prv_refresh();
+}
+
+// Coalesce updates so the locator redraws at most LOCATOR_MAX_FPS times a second
+static void prv_request_refresh(void) {
+  if (s_frame_timer) {
+    // Already scheduled; it will pick up the latest values
+    return;
+  }
+
+  time_t now_s;
+  uint16_t now_ms;
+  time_ms(&now_s, &now_ms);
+  const int32_t elapsed_ms = (int32_t)(now_s - s_last_frame_s) * 1000 + (now_ms - s_last_frame_ms);
+
+  if (elapsed_ms >= 0 && elapsed_ms < LOCATOR_FRAME_MS) {
+    s_frame_timer = app_timer_register(LOCATOR_FRAME_MS - elapsed_ms, prv_frame_timer_callback, NULL);
+  } else {
+    prv_refresh();
+  }
+}
+
 static void prv_create_grid(TextLayer *grid[GRID_ROWS][GRID_COLS], Layer *parent,
                             GRect bounds, const char *text[GRID_ROWS][GRID_COLS],
                             GFont header_font, GFont value_font, const GColor color) {
@@ -324,6 +729,9 @@ static void prv_window_load(Window *window) {
                                        crosshair_y,
                                        content_bounds.size.w, 
                                        crosshair_height);
+  s_labels_shown = false;
+  s_target_drawn = false;
+  s_identified_body = IDENTIFY_NONE;
   s_crosshair_layer = layer_create(crosshair_bounds);
   layer_set_update_proc(s_crosshair_layer, prv_draw_crosshair);
   layer_add_child(window_layer, s_crosshair_layer);
@@ -436,6 +844,9 @@ static void prv_window_load(Window *window) {
   s_light_enabled = false;
   s_icon_light_on = gbitmap_create_with_resource(RESOURCE_ID_ACTION_LIGHT_ON);
   s_icon_light_off = gbitmap_create_with_resource(RESOURCE_ID_ACTION_LIGHT_OFF);
+#if defined(PBL_COMPASS)
+  s_icon_track = gbitmap_create_with_resource(RESOURCE_ID_ACTION_TRACK);
+#endif
 
   s_action_bar = action_bar_layer_create();
   action_bar_layer_set_click_config_provider(s_action_bar, prv_click_config_provider);
@@ -445,35 +856,86 @@ static void prv_window_load(Window *window) {
 
   prv_update_labels();
 
+  // Declination replies and overlay snapshots come here while the locator is open
+  bodymsg_add_handlers(&s_message_handlers);
+
 #ifdef DEMO_MODE
   // Demo mode: Always show crosshair and hide calibration message
   layer_set_hidden(text_layer_get_layer(s_calibration_layer), true);
   layer_set_hidden(s_crosshair_layer, false);
 #elif defined(PBL_COMPASS)
+  // Start from the background worker's heading, if it has a recent calibrated one,
+  // so the first frame doesn't ask for a figure-8 while the compass wakes up
+  int16_t worker_azimuth;
+  s_is_calibrated = compass_worker_get_azimuth(&worker_azimuth);
+  if (s_is_calibrated) {
+    s_current_azimuth_deg = worker_azimuth;
+  }
+  compass_worker_set_paused(true);
+
   // Apply current calibration state to UI after window is loaded
-  prv_on_calibration(s_is_calibrated);
-  
-  // Register inbox callback for declination response
-  app_message_register_inbox_received(prv_inbox_received_callback);
+  prv_on_calibration(s_is_calibrated, NULL);
   
-  // Request magnetic declination from JavaScript
-  prv_request_declination();
+  // The persisted declination is used as-is; only ask the phone in the
+  // background if it is missing or stale
+  declination_request_if_stale();
 #else
   // On non-compass watches, hide calibration message and show crosshair
   layer_set_hidden(text_layer_get_layer(s_calibration_layer), true);
   layer_set_hidden(s_crosshair_layer, false);
 #endif
+
+  // Subscribe once the layers exist so the initial values can update labels.
+  // The hub keeps the sensors running for as long as any window listens.
+#ifndef DEMO_MODE
+  s_altitude_subscription = sensor_hub_subscribe(SensorStreamAltitude, 0, prv_on_altitude, NULL);
+
+#if defined(PBL_COMPASS)
+  s_azimuth_subscription = sensor_hub_subscribe(SensorStreamAzimuth, 0, prv_on_azimuth, NULL);
+  s_calibration_subscription = sensor_hub_subscribe(SensorStreamCalibration, 0, prv_on_calibration, NULL);
+#endif
+
+  governor_init();
+  governor_request_quality(GovernorQualityHigh);
+#endif
+
+  // Keep the target moving with the sky while the window is up
+  prv_start_tracking();
+
+  heap_stats_record(HeapSiteLocator, HeapEventLoad);
 }
 
 static void prv_window_unload(Window *window) {
+  heap_stats_record(HeapSiteLocator, HeapEventUnload);
+
+  prv_stop_tracking();
+
+#ifndef DEMO_MODE
+  governor_deinit();
+  sensor_hub_unsubscribe(s_calibration_subscription);
+  sensor_hub_unsubscribe(s_azimuth_subscription);
+  sensor_hub_unsubscribe(s_altitude_subscription);
+  s_calibration_subscription = NULL;
+  s_azimuth_subscription = NULL;
+  s_altitude_subscription = NULL;
+#endif
+
   // Disable light when going back
-  light_enable(false);
-  s_light_enabled = false;
+  prv_set_light(false);
+
+  if (s_frame_timer) {
+    app_timer_cancel(s_frame_timer);
+    s_frame_timer = NULL;
+  }
+  if (s_reticle_bitmap) {
+    gbitmap_destroy(s_reticle_bitmap);
+    s_reticle_bitmap = NULL;
+  }
   
 #if defined(PBL_COMPASS)
-  // Unregister inbox callback
-  app_message_register_inbox_received(NULL);
+  compass_worker_set_paused(false);
 #endif
+  bodymsg_remove_handlers(&s_message_handlers);
 
   for (int row = 0; row < GRID_ROWS; ++row) {
     for (int col = 0; col < GRID_COLS; ++col) {
@@ -500,6 +962,10 @@ static void prv_window_unload(Window *window) {
     gbitmap_destroy(s_icon_light_off);
     s_icon_light_off = NULL;
   }
+  if (s_icon_track) {
+    gbitmap_destroy(s_icon_track);
+    s_icon_track = NULL;
+  }
   layer_destroy(s_crosshair_layer);
   s_crosshair_layer = NULL;
   text_layer_destroy(s_calibration_layer);
@@ -519,18 +985,6 @@ void locator_init(void) {
                                     .load = prv_window_load,
                                     .unload = prv_window_unload,
                                 });
-
-  // Start sensors/providers after window creation so callbacks can update labels.
-#ifndef DEMO_MODE
-  altitude_provider_init();
-  altitude_provider_set_handler(prv_on_altitude);
-
-#if defined(PBL_COMPASS)
-  azimuth_provider_init();
-  azimuth_provider_set_handler(prv_on_azimuth);
-  azimuth_provider_set_calibration_handler(prv_on_calibration);
-#endif
-#endif
 }
 
 void locator_deinit(void) {
@@ -538,14 +992,6 @@ void locator_deinit(void) {
     return;
   }
 
-#ifndef DEMO_MODE
-#if defined(PBL_COMPASS)
-  azimuth_provider_deinit();
-  s_declination_requested = false;
-#endif
-  altitude_provider_deinit();
-#endif
-
   window_stack_remove(s_window, false);
   window_destroy(s_window);
   s_window = NULL;
@@ -556,17 +1002,81 @@ void locator_deinit(void) {
   s_status_layer = NULL;
 }
 
+static void prv_propagate_target(void) {
+  sky_track_to_horizontal(&s_track, time(NULL), &s_target.altitude_deg, &s_target.azimuth_deg);
+  prv_request_refresh();
+}
+
+// Refresh overlay positions from the sky snapshot; cheap enough once a second
+static void prv_update_overlay(void) {
+  const time_t now = time(NULL);
+  s_overlay_count = 0;
+  for (uint8_t i = 0; i < sky_get_count(); i++) {
+    OverlayObject *object = &s_overlay[s_overlay_count];
+    if (sky_get_object(i, now, &object->body_id, &object->altitude_deg, &object->azimuth_deg) &&
+        object->altitude_deg >= 0) {
+      s_overlay_count++;
+    }
+  }
+
+  if (s_crosshair_layer) {
+    layer_mark_dirty(s_crosshair_layer);
+  }
+}
+
+static void prv_track_timer_callback(void *context) {
+  (void)context;
+  s_track_timer = NULL;
+  if (!s_tracking && !s_overlay_enabled) {
+    return;
+  }
+
+  if (s_tracking) {
+    prv_propagate_target();
+  }
+  if (s_overlay_enabled) {
+    prv_update_overlay();
+  }
+  s_track_timer = app_timer_register(TRACK_INTERVAL_MS, prv_track_timer_callback, NULL);
+}
+
+static void prv_start_tracking(void) {
+  if ((!s_tracking && !s_overlay_enabled) || s_track_timer || !s_crosshair_layer) {
+    return;
+  }
+  prv_track_timer_callback(NULL);
+}
+
+static void prv_stop_tracking(void) {
+  if (s_track_timer) {
+    app_timer_cancel(s_track_timer);
+    s_track_timer = NULL;
+  }
+}
+
+void locator_set_target_track(const TargetTrack *track) {
+  s_tracking = (track != NULL);
+  if (!s_tracking) {
+    prv_stop_tracking();
+    return;
+  }
+
+  s_track = *track;
+  prv_propagate_target();
+  prv_start_tracking();
+}
+
 void locator_set_target(int16_t altitude_deg, int16_t azimuth_deg) {
   s_target.altitude_deg = altitude_deg;
   s_target.azimuth_deg = azimuth_deg;
-  prv_update_labels();
+  prv_request_refresh();
 }
 
 TargetData locator_get_target(void) { return s_target; }
 
 void locator_set_current_altitude(int16_t altitude_deg) {
   s_current_altitude_deg = altitude_deg;
-  prv_update_labels();
+  prv_request_refresh();
 }
 
 int16_t locator_get_current_altitude(void) { return s_current_altitude_deg; }
@@ -574,7 +1084,7 @@ int16_t locator_get_current_altitude(void) { return s_current_altitude_deg; }
 #if defined(PBL_COMPASS)
 void locator_set_current_azimuth(int16_t azimuth_deg) {
   s_current_azimuth_deg = azimuth_deg;
-  prv_update_labels();
+  prv_request_refresh();
 }
 
 int16_t locator_get_current_azimuth(void) { return s_current_azimuth_deg; }
@@ -1,6 +1,7 @@
 #pragma once
 
 #include <pebble.h>
+#include "../../utils/sky.h"
 
 typedef struct {
   int16_t altitude_deg;
@@ -13,6 +14,10 @@ void locator_deinit(void);
 void locator_set_target(int16_t altitude_deg, int16_t azimuth_deg);
 TargetData locator_get_target(void);
 
+// Keep the target current from an equatorial snapshot; NULL stops tracking.
+// Call after locator_set_target, which remains the fallback.
+void locator_set_target_track(const TargetTrack *track);
+
 void locator_set_current_altitude(int16_t altitude_deg);
 int16_t locator_get_current_altitude(void);
 void locator_set_current_azimuth(int16_t azimuth_deg);
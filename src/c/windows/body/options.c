@@ -3,7 +3,7 @@
 #include "details.h"
 #include "../favorites.h"
 #include "../../style.h"
-#include "../../utils/settings.h"
+#include "../../utils/favorites_store.h"
 
 static ActionMenu *s_menu;
 static ActionMenuLevel *s_root;
@@ -25,18 +25,10 @@ static void prv_on_favorite(ActionMenu *menu, const ActionMenuItem *action, void
   const DetailsContent *content = details_get_current_content();
   if (content && content->body_id >= 0) {
     int body_id = content->body_id;
-    LocalSettings *settings = settings_get();
-    bool was_favorited = (settings->favorites & (1 << body_id)) != 0;
+    bool was_favorited = favorites_store_contains(body_id);
 
-      // Toggle the favorite bit
-      if (was_favorited) {
-        settings->favorites &= ~(1 << body_id);
-      } else {
-        settings->favorites |= (1 << body_id);
-      }
-
-      // Save settings
-      settings_save();
+      // Toggle the favorite bit (saved by the store)
+      favorites_store_set(body_id, !was_favorited);
 
       // If unfavoriting and we came from favorites menu, remove it from stack
       if (was_favorited) {
@@ -59,6 +51,7 @@ static void prv_on_locate(ActionMenu *menu, const ActionMenuItem *action, void *
   const DetailsContent *content = details_get_current_content();
   if (content) {
     locator_set_target(content->altitude_deg, content->azimuth_deg);
+    locator_set_target_track(content->has_track ? &content->track : NULL);
   }
 
   locator_show();
@@ -69,17 +62,8 @@ static void prv_on_refresh(ActionMenu *menu, const ActionMenuItem *action, void
   (void)action;
   (void)context;
 
-  // Get current body ID
-  const DetailsContent *content = details_get_current_content();
-  if (content && content->body_id >= 0) {
-    int body_id = content->body_id;
-    
-    // Remove the details window from the stack
-    details_hide();
-    
-    // Request the body data again and show the window
-    details_show_body(body_id);
-  }
+  // Request the body data again; the details window updates without being rebuilt
+  details_refresh();
 }
 
 
@@ -103,7 +87,7 @@ void options_menu_show(void) {
   // Determine favorite action text based on current status
   const DetailsContent *content = details_get_current_content();
   const char *favorite_text = "Favorite";
-  if (content && content->body_id >= 0 && (settings_get()->favorites & (1 << content->body_id))) {
+  if (content && favorites_store_contains(content->body_id)) {
     favorite_text = "Unfavorite";
   }
   action_menu_level_add_action(s_root, favorite_text, prv_on_favorite, NULL);
@@ -0,0 +1,198 @@
+#include "catalog.h"
+#include "../body/details.h"
+#include "../../style.h"
+#include "../../utils/heap_stats.h"
+#include "../../utils/logging.h"
+#include "../../utils/body_info.h"
+#include "../../utils/star_catalog.h"
+
+// Where a section's ids come from. Star catalog ranges are only known once the
+// resource has been read, so they are resolved when the menu asks for them.
+typedef enum {
+  CatalogRangeFixed = 0,
+  CatalogRangeStars,
+  CatalogRangeDeepSky,
+} CatalogRange;
+
+// A run of consecutive body ids shown under one (optional) header
+typedef struct {
+  const char *title;
+  uint8_t range;
+  uint16_t first_id;
+  uint16_t last_id;
+} CatalogSection;
+
+typedef struct {
+  const CatalogSection *sections;
+  uint8_t num_sections;
+} CatalogDef;
+
+static const CatalogSection s_planet_sections[] = {
+  { .first_id = 1, .last_id = 8 },
+};
+
+static const CatalogSection s_zodiac_sections[] = {
+  { .first_id = 10, .last_id = 21 },
+};
+
+static const CatalogSection s_constellation_sections[] = {
+  { .first_id = 22, .last_id = 28 },
+};
+
+static const CatalogSection s_star_sections[] = {
+  { .title = "Bright Stars", .range = CatalogRangeStars },
+  { .title = "Messier", .range = CatalogRangeDeepSky },
+};
+
+static const CatalogDef s_catalogs[CatalogCount] = {
+  [CatalogPlanets] = { s_planet_sections, ARRAY_LENGTH(s_planet_sections) },
+  [CatalogZodiac] = { s_zodiac_sections, ARRAY_LENGTH(s_zodiac_sections) },
+  [CatalogConstellations] = { s_constellation_sections, ARRAY_LENGTH(s_constellation_sections) },
+  [CatalogStars] = { s_star_sections, ARRAY_LENGTH(s_star_sections) },
+};
+
+static Window *s_window;
+static MenuLayer *s_menu_layer;
+static const CatalogDef *s_catalog;
+
+static const CatalogSection *prv_section(uint16_t section_index) {
+  if (!s_catalog || section_index >= s_catalog->num_sections) {
+    return NULL;
+  }
+  return &s_catalog->sections[section_index];
+}
+
+// Resolve a section to its first body id and row count
+static uint16_t prv_section_range(const CatalogSection *section, int *first_id) {
+  switch (section->range) {
+    case CatalogRangeStars:
+      *first_id = STAR_CATALOG_FIRST_BODY_ID;
+      return star_catalog_star_count();
+    case CatalogRangeDeepSky:
+      *first_id = STAR_CATALOG_FIRST_BODY_ID + star_catalog_star_count();
+      return star_catalog_count() - star_catalog_star_count();
+    default:
+      *first_id = section->first_id;
+      return section->last_id - section->first_id + 1;
+  }
+}
+
+static int prv_body_id(const MenuIndex *cell_index) {
+  const CatalogSection *section = prv_section(cell_index->section);
+  if (!section) {
+    return -1;
+  }
+  int first_id;
+  if (cell_index->row >= prv_section_range(section, &first_id)) {
+    return -1;
+  }
+  return first_id + cell_index->row;
+}
+
+static uint16_t prv_get_num_sections(MenuLayer *menu_layer, void *context) {
+  return s_catalog ? s_catalog->num_sections : 0;
+}
+
+static uint16_t prv_get_num_rows(MenuLayer *menu_layer, uint16_t section_index, void *context) {
+  const CatalogSection *section = prv_section(section_index);
+  int first_id;
+  return section ? prv_section_range(section, &first_id) : 0;
+}
+
+static int16_t prv_get_header_height(MenuLayer *menu_layer, uint16_t section_index, void *context) {
+  const CatalogSection *section = prv_section(section_index);
+  return section && section->title ? MENU_CELL_BASIC_HEADER_HEIGHT : 0;
+}
+
+static void prv_draw_header(GContext *ctx, const Layer *cell_layer, uint16_t section_index, void *context) {
+  const CatalogSection *section = prv_section(section_index);
+  if (section && section->title) {
+    menu_cell_basic_header_draw(ctx, cell_layer, section->title);
+  }
+}
+
+// Rows are drawn straight from body_info (or the catalog resource) when they
+// scroll into view, so nothing is allocated per item
+static void prv_draw_row(GContext *ctx, const Layer *cell_layer, MenuIndex *cell_index, void *context) {
+  char name[STAR_CATALOG_NAME_SIZE];
+  if (!body_info_copy_name(prv_body_id(cell_index), name, sizeof(name))) {
+    name[0] = '\0';
+  }
+  menu_cell_basic_draw(ctx, cell_layer, name, NULL, NULL);
+}
+
+static void prv_select_click(MenuLayer *menu_layer, MenuIndex *cell_index, void *context) {
+  const int body_id = prv_body_id(cell_index);
+  HUBBLE_LOG(APP_LOG_LEVEL_INFO, "Catalog menu selected: body ID %d", body_id);
+
+  if (body_id >= 0) {
+    details_show_body(body_id);
+  } else {
+    HUBBLE_LOG(APP_LOG_LEVEL_ERROR, "Invalid menu index: %d/%d", cell_index->section, cell_index->row);
+    details_show(NULL);
+  }
+}
+
+static void prv_window_load(Window *window) {
+  const Layout *layout = layout_get();
+
+  Layer *window_layer = window_get_root_layer(window);
+  const GRect bounds = layer_get_bounds(window_layer);
+
+  s_menu_layer = menu_layer_create(bounds);
+  menu_layer_set_callbacks(s_menu_layer, NULL, (MenuLayerCallbacks){
+                                                   .get_num_sections = prv_get_num_sections,
+                                                   .get_num_rows = prv_get_num_rows,
+                                                   .get_header_height = prv_get_header_height,
+                                                   .draw_header = prv_draw_header,
+                                                   .draw_row = prv_draw_row,
+                                                   .select_click = prv_select_click,
+                                               });
+  menu_layer_set_normal_colors(s_menu_layer, layout->background, layout->foreground);
+  menu_layer_set_highlight_colors(s_menu_layer, layout->highlight, layout->highlight_foreground);
+  menu_layer_set_click_config_onto_window(s_menu_layer, window);
+  layer_add_child(window_layer, menu_layer_get_layer(s_menu_layer));
+
+  heap_stats_record(HeapSiteCatalog, HeapEventLoad);
+}
+
+static void prv_window_unload(Window *window) {
+  heap_stats_record(HeapSiteCatalog, HeapEventUnload);
+
+  menu_layer_destroy(s_menu_layer);
+  s_menu_layer = NULL;
+
+  // Nothing stays resident between visits
+  window_destroy(window);
+  s_window = NULL;
+  s_catalog = NULL;
+}
+
+void catalog_show(CatalogId catalog) {
+  if (catalog >= CatalogCount) {
+    return;
+  }
+  s_catalog = &s_catalogs[catalog];
+
+  if (s_window) {
+    // Still on the stack; show the requested catalog in it
+    menu_layer_reload_data(s_menu_layer);
+    menu_layer_set_selected_index(s_menu_layer, MenuIndex(0, 0), MenuRowAlignTop, false);
+    return;
+  }
+
+  s_window = window_create();
+  window_set_background_color(s_window, layout_get()->background);
+  window_set_window_handlers(s_window, (WindowHandlers){
+                                    .load = prv_window_load,
+                                    .unload = prv_window_unload,
+                                });
+  window_stack_push(s_window, true);
+}
+
+void catalog_hide(void) {
+  if (s_window) {
+    // The unload handler destroys the window
+    window_stack_remove(s_window, true);
+  }
+}
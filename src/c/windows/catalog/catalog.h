@@ -0,0 +1,17 @@
+#pragma once
+
+#include <pebble.h>
+
+// Body lists reachable from the home menu; each is a table of sections in catalog.c
+typedef enum {
+  CatalogPlanets = 0,
+  CatalogZodiac,
+  CatalogConstellations,
+  CatalogStars,
+  CatalogCount,
+} CatalogId;
+
+// Push a browser for the catalog. The window is created here and destroyed
+// when it leaves the stack.
+void catalog_show(CatalogId catalog);
+void catalog_hide(void);
@@ -1,6 +0,0 @@
-#pragma once
-
-void constellations_zodiac_menu_init(void);
-void constellations_zodiac_menu_deinit(void);
-void constellations_zodiac_menu_show(void);
-void constellations_zodiac_menu_hide(void);
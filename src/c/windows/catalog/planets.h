@@ -1,6 +0,0 @@
-#pragma once
-
-void planets_menu_init(void);
-void planets_menu_deinit(void);
-void planets_menu_show(void);
-void planets_menu_hide(void);
@@ -0,0 +1,317 @@
+#include "search.h"
+#include "../body/details.h"
+#include "../../style.h"
+#include "../../utils/heap_stats.h"
+#include "../../utils/logging.h"
+#include "../../utils/body_info.h"
+#include "../../utils/star_catalog.h"
+
+#define SEARCH_MARGIN PBL_IF_ROUND_ELSE(18, 6)
+#define SEARCH_TOP PBL_IF_ROUND_ELSE(14, 0)
+#define SEARCH_HEADER_HEIGHT 22
+#define SEARCH_QUERY_HEIGHT 32
+#define SEARCH_LINE_HEIGHT 20
+#define SEARCH_PREVIEW_ROWS 3
+
+static Window *s_window;
+static Layer *s_canvas;
+static Window *s_results_window;
+static MenuLayer *s_results_layer;
+
+// Characters kept with SELECT, and the one the wheel is on ('\0' is the stop
+// between the last and first character, meaning "just the prefix")
+static char s_prefix[STAR_CATALOG_NAME_SIZE];
+static size_t s_prefix_len;
+static char s_candidate;
+
+// Ranks of the names matching prefix + candidate in the sorted name index
+static uint16_t s_first_rank;
+static uint16_t s_match_count;
+
+static void prv_build_query(char *query, size_t size) {
+  size_t len = 0;
+  for (; len < s_prefix_len && len < size - 1; len++) {
+    query[len] = s_prefix[len];
+  }
+  if (s_candidate && len < size - 1) {
+    query[len++] = s_candidate;
+  }
+  query[len] = '\0';
+}
+
+static void prv_update_matches(void) {
+  char query[STAR_CATALOG_NAME_SIZE];
+  prv_build_query(query, sizeof(query));
+  s_match_count = star_catalog_find_prefix(query, &s_first_rank);
+
+  if (s_canvas) {
+    layer_mark_dirty(s_canvas);
+  }
+}
+
+static bool prv_copy_ranked_name(uint16_t rank, char *buffer, size_t size) {
+  int body_id;
+  return star_catalog_get_sorted(rank, &body_id) && body_info_copy_name(body_id, buffer, size);
+}
+
+static void prv_show_ranked_body(uint16_t rank) {
+  int body_id;
+  if (star_catalog_get_sorted(rank, &body_id)) {
+    details_show_body(body_id);
+  }
+}
+
+// ---- Results list ----
+
+static uint16_t prv_results_get_num_rows(MenuLayer *menu_layer, uint16_t section_index,
+                                         void *context) {
+  return s_match_count;
+}
+
+static void prv_results_draw_row(GContext *ctx, const Layer *cell_layer, MenuIndex *cell_index,
+                                 void *context) {
+  char name[STAR_CATALOG_NAME_SIZE];
+  if (!prv_copy_ranked_name(s_first_rank + cell_index->row, name, sizeof(name))) {
+    name[0] = '\0';
+  }
+  menu_cell_basic_draw(ctx, cell_layer, name, NULL, NULL);
+}
+
+static void prv_results_select_click(MenuLayer *menu_layer, MenuIndex *cell_index, void *context) {
+  prv_show_ranked_body(s_first_rank + cell_index->row);
+}
+
+static void prv_results_window_load(Window *window) {
+  const Layout *layout = layout_get();
+  Layer *window_layer = window_get_root_layer(window);
+
+  s_results_layer = menu_layer_create(layer_get_bounds(window_layer));
+  menu_layer_set_callbacks(s_results_layer, NULL, (MenuLayerCallbacks){
+                                                      .get_num_rows = prv_results_get_num_rows,
+                                                      .draw_row = prv_results_draw_row,
+                                                      .select_click = prv_results_select_click,
+                                                  });
+  menu_layer_set_normal_colors(s_results_layer, layout->background, layout->foreground);
+  menu_layer_set_highlight_colors(s_results_layer, layout->highlight, layout->highlight_foreground);
+  menu_layer_set_click_config_onto_window(s_results_layer, window);
+  layer_add_child(window_layer, menu_layer_get_layer(s_results_layer));
+
+  heap_stats_record(HeapSiteCatalog, HeapEventLoad);
+}
+
+static void prv_results_window_unload(Window *window) {
+  heap_stats_record(HeapSiteCatalog, HeapEventUnload);
+
+  menu_layer_destroy(s_results_layer);
+  s_results_layer = NULL;
+
+  window_destroy(window);
+  s_results_window = NULL;
+}
+
+static void prv_show_results(void) {
+  if (s_match_count == 0) {
+    vibes_short_pulse();
+    return;
+  }
+
+  // A single match needs no list
+  if (s_match_count == 1) {
+    prv_show_ranked_body(s_first_rank);
+    return;
+  }
+
+  if (s_results_window) {
+    menu_layer_reload_data(s_results_layer);
+    return;
+  }
+
+  s_results_window = window_create();
+  window_set_background_color(s_results_window, layout_get()->background);
+  window_set_window_handlers(s_results_window, (WindowHandlers){
+                                                   .load = prv_results_window_load,
+                                                   .unload = prv_results_window_unload,
+                                               });
+  window_stack_push(s_results_window, true);
+}
+
+// ---- Letter wheel ----
+
+static char prv_display_char(char c) {
+  if (c == ' ') {
+    return '_';
+  }
+  return (c >= 'a' && c <= 'z') ? (char)(c - 'a' + 'A') : c;
+}
+
+static void prv_draw_text(GContext *ctx, const char *text, const char *font_key, GRect frame,
+                          GTextAlignment alignment) {
+  graphics_draw_text(ctx, text, fonts_get_system_font(font_key), frame,
+                     GTextOverflowModeTrailingEllipsis, alignment, NULL);
+}
+
+static void prv_canvas_update_proc(Layer *layer, GContext *ctx) {
+  const Layout *layout = layout_get();
+  const GRect bounds = layer_get_bounds(layer);
+  const int16_t width = bounds.size.w - 2 * SEARCH_MARGIN;
+  int16_t y = SEARCH_TOP;
+
+  graphics_context_set_text_color(ctx, layout->foreground);
+  prv_draw_text(ctx, "Search", FONT_KEY_GOTHIC_18_BOLD,
+                GRect(SEARCH_MARGIN, y, width, SEARCH_HEADER_HEIGHT), GTextAlignmentCenter);
+  y += SEARCH_HEADER_HEIGHT;
+
+  // Typed prefix followed by the wheel character in a highlight box
+  char prefix[STAR_CATALOG_NAME_SIZE];
+  for (size_t i = 0; i <= s_prefix_len; i++) {
+    prefix[i] = i < s_prefix_len ? prv_display_char(s_prefix[i]) : '\0';
+  }
+  const char wheel[2] = { s_candidate ? prv_display_char(s_candidate) : ' ', '\0' };
+  GFont font = fonts_get_system_font(FONT_KEY_GOTHIC_24_BOLD);
+  const GRect text_box = GRect(0, 0, bounds.size.w * 2, SEARCH_QUERY_HEIGHT);
+  const int16_t prefix_w = s_prefix_len ?
+      graphics_text_layout_get_content_size(prefix, font, text_box, GTextOverflowModeFill,
+                                            GTextAlignmentLeft).w : 0;
+  const int16_t wheel_w = 18;
+
+  // Keep the wheel in view once the prefix is wider than the screen
+  int16_t x = (bounds.size.w - prefix_w - wheel_w) / 2;
+  if (x + prefix_w + wheel_w > bounds.size.w - SEARCH_MARGIN) {
+    x = bounds.size.w - SEARCH_MARGIN - prefix_w - wheel_w;
+  }
+  if (s_prefix_len) {
+    graphics_draw_text(ctx, prefix, font, GRect(x, y, prefix_w + 4, SEARCH_QUERY_HEIGHT),
+                       GTextOverflowModeFill, GTextAlignmentLeft, NULL);
+  }
+  const GRect wheel_frame = GRect(x + prefix_w + 1, y + 4, wheel_w, SEARCH_QUERY_HEIGHT - 6);
+  graphics_context_set_fill_color(ctx, layout->highlight);
+  graphics_fill_rect(ctx, wheel_frame, 3, GCornersAll);
+  graphics_context_set_text_color(ctx, layout->highlight_foreground);
+  graphics_draw_text(ctx, wheel, font, GRect(wheel_frame.origin.x, y, wheel_w, SEARCH_QUERY_HEIGHT),
+                     GTextOverflowModeFill, GTextAlignmentCenter, NULL);
+  y += SEARCH_QUERY_HEIGHT;
+
+  graphics_context_set_text_color(ctx, layout->foreground);
+  char count_text[16];
+  snprintf(count_text, sizeof(count_text), s_match_count == 1 ? "%u match" : "%u matches",
+           s_match_count);
+  prv_draw_text(ctx, count_text, FONT_KEY_GOTHIC_18_BOLD,
+                GRect(SEARCH_MARGIN, y, width, SEARCH_LINE_HEIGHT), GTextAlignmentCenter);
+  y += SEARCH_LINE_HEIGHT + 2;
+
+  // First few matches, read from the name index as they are drawn
+  for (uint16_t i = 0; i < SEARCH_PREVIEW_ROWS && i < s_match_count; i++) {
+    char name[STAR_CATALOG_NAME_SIZE];
+    if (!prv_copy_ranked_name(s_first_rank + i, name, sizeof(name))) {
+      break;
+    }
+    prv_draw_text(ctx, name, FONT_KEY_GOTHIC_18, GRect(SEARCH_MARGIN, y, width, SEARCH_LINE_HEIGHT),
+                  GTextAlignmentCenter);
+    y += SEARCH_LINE_HEIGHT;
+  }
+  if (s_match_count > SEARCH_PREVIEW_ROWS) {
+    prv_draw_text(ctx, "...", FONT_KEY_GOTHIC_18, GRect(SEARCH_MARGIN, y, width, SEARCH_LINE_HEIGHT),
+                  GTextAlignmentCenter);
+  }
+}
+
+static void prv_turn_wheel(bool forward) {
+  // Running off either end lands on the '\0' stop, and from there on the far end
+  s_candidate = star_catalog_next_char(s_prefix, s_candidate, forward);
+  prv_update_matches();
+}
+
+static void prv_up_click_handler(ClickRecognizerRef recognizer, void *context) {
+  prv_turn_wheel(false);
+}
+
+static void prv_down_click_handler(ClickRecognizerRef recognizer, void *context) {
+  prv_turn_wheel(true);
+}
+
+static void prv_select_click_handler(ClickRecognizerRef recognizer, void *context) {
+  if (!s_candidate) {
+    prv_show_results();
+    return;
+  }
+  if (s_prefix_len < sizeof(s_prefix) - 1) {
+    s_prefix[s_prefix_len++] = s_candidate;
+    s_prefix[s_prefix_len] = '\0';
+  }
+  s_candidate = '\0';
+  prv_update_matches();
+}
+
+static void prv_select_long_click_handler(ClickRecognizerRef recognizer, void *context) {
+  prv_show_results();
+}
+
+static void prv_back_click_handler(ClickRecognizerRef recognizer, void *context) {
+  if (s_prefix_len == 0) {
+    window_stack_pop(true);
+    return;
+  }
+  // Put the deleted character back on the wheel so it can be changed
+  s_candidate = s_prefix[--s_prefix_len];
+  s_prefix[s_prefix_len] = '\0';
+  prv_update_matches();
+}
+
+static void prv_click_config_provider(void *context) {
+  window_single_repeating_click_subscribe(BUTTON_ID_UP, 100, prv_up_click_handler);
+  window_single_repeating_click_subscribe(BUTTON_ID_DOWN, 100, prv_down_click_handler);
+  window_single_click_subscribe(BUTTON_ID_SELECT, prv_select_click_handler);
+  window_long_click_subscribe(BUTTON_ID_SELECT, 0, prv_select_long_click_handler, NULL);
+  window_single_click_subscribe(BUTTON_ID_BACK, prv_back_click_handler);
+}
+
+static void prv_window_load(Window *window) {
+  Layer *window_layer = window_get_root_layer(window);
+
+  s_canvas = layer_create(layer_get_bounds(window_layer));
+  layer_set_update_proc(s_canvas, prv_canvas_update_proc);
+  layer_add_child(window_layer, s_canvas);
+
+  s_prefix[0] = '\0';
+  s_prefix_len = 0;
+  s_candidate = '\0';
+  prv_update_matches();
+
+  heap_stats_record(HeapSiteCatalog, HeapEventLoad);
+}
+
+static void prv_window_unload(Window *window) {
+  heap_stats_record(HeapSiteCatalog, HeapEventUnload);
+
+  layer_destroy(s_canvas);
+  s_canvas = NULL;
+
+  // Nothing stays resident between visits
+  window_destroy(window);
+  s_window = NULL;
+}
+
+void search_show(void) {
+  if (s_window) {
+    return;
+  }
+
+  s_window = window_create();
+  window_set_background_color(s_window, layout_get()->background);
+  window_set_click_config_provider(s_window, prv_click_config_provider);
+  window_set_window_handlers(s_window, (WindowHandlers){
+                                    .load = prv_window_load,
+                                    .unload = prv_window_unload,
+                                });
+  window_stack_push(s_window, true);
+}
+
+void search_hide(void) {
+  if (s_results_window) {
+    window_stack_remove(s_results_window, false);
+  }
+  if (s_window) {
+    // The unload handler destroys the window
+    window_stack_remove(s_window, true);
+  }
+}
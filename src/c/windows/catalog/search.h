@@ -0,0 +1,10 @@
+#pragma once
+
+#include <pebble.h>
+
+// Letter-wheel search over every body name. UP/DOWN turn the wheel through the
+// characters that can follow the typed prefix, SELECT keeps the shown one, BACK
+// deletes it and long SELECT lists the matches. The windows are created here
+// and destroyed when they leave the stack.
+void search_show(void);
+void search_hide(void);
@@ -1,21 +1,183 @@
 #include "events.h"
+#include "heap_debug.h"
 #include "../style.h"
+#include "../utils/body_info.h"
 #include "../utils/bodymsg.h"
+#include "../utils/events_store.h"
+#include "../utils/heap_stats.h"
 #include "../utils/logging.h"
+#include "../utils/msgproc.h"
+
+// A sync that stalls this long is dropped and the stored list stays
+#define EVENTS_SYNC_TIMEOUT_MS 15000
+
+typedef enum {
+  EventsStatusIdle,
+  EventsStatusRefreshing,
+  EventsStatusOffline,
+} EventsStatus;
 
 static Window *s_window;
-static TextLayer *s_text_layer;
+static MenuLayer *s_menu_layer;
 static bool s_refresh_pending = false;
+static EventsStatus s_status = EventsStatusIdle;
+static AppTimer *s_sync_timer;
+// Rows start at the first event that hasn't happened yet
+static uint16_t s_first_index;
+static uint16_t s_num_rows;
+static char s_header_text[24];
+
+static const BodymsgHandlers s_message_handlers;
+
+static const char *const s_type_names[EventTypeCount] = {
+  [EventTypeCivilDawn] = "Civil dawn",
+  [EventTypeCivilDusk] = "Civil dusk",
+  [EventTypeNauticalDawn] = "Nautical dawn",
+  [EventTypeNauticalDusk] = "Nautical dusk",
+  [EventTypeAstronomicalDawn] = "Astronomical dawn",
+  [EventTypeAstronomicalDusk] = "Astronomical dusk",
+  [EventTypeNoon] = "Solar noon",
+  [EventTypeMidnight] = "Solar midnight",
+  [EventTypeMarchEquinox] = "March equinox",
+  [EventTypeJuneSolstice] = "June solstice",
+  [EventTypeSeptemberEquinox] = "September equinox",
+  [EventTypeDecemberSolstice] = "December solstice",
+  [EventTypeLunarEclipse] = "Lunar eclipse",
+  [EventTypeSolarEclipse] = "Solar eclipse",
+  [EventTypePerigee] = "Lunar perigee",
+  [EventTypeApogee] = "Lunar apogee",
+};
+
+static void prv_format_title(const EventRecord *record, char *buffer, size_t size) {
+  const char *name = body_info_get_name(record->body_id);
+  if (!name) {
+    name = "";
+  }
+
+  switch (record->type) {
+    case EventTypeRise:
+      if (record->body_id == 0 || record->body_id == 9) {
+        snprintf(buffer, size, "%srise", name);
+      } else {
+        snprintf(buffer, size, "%s rises", name);
+      }
+      break;
+    case EventTypeSet:
+      if (record->body_id == 0 || record->body_id == 9) {
+        snprintf(buffer, size, "%sset", name);
+      } else {
+        snprintf(buffer, size, "%s sets", name);
+      }
+      break;
+    case EventTypeTransit:
+      snprintf(buffer, size, "Transit of %s", name);
+      break;
+    default:
+      snprintf(buffer, size, "%s", s_type_names[record->type] ? s_type_names[record->type] : "");
+      break;
+  }
+}
+
+static bool prv_same_day(const struct tm *a, const struct tm *b) {
+  return a->tm_year == b->tm_year && a->tm_yday == b->tm_yday;
+}
+
+// "Today 6:42 AM", "Tomorrow 18:05", "Sat Dec 21 15:50"
+static void prv_format_subtitle(const EventRecord *record, char *buffer, size_t size) {
+  const time_t now = time(NULL);
+  const time_t when = (time_t)record->minutes * 60;
+
+  struct tm today = *localtime(&now);
+  const time_t tomorrow_time = now + SECONDS_PER_DAY;
+  struct tm tomorrow = *localtime(&tomorrow_time);
+  struct tm event = *localtime(&when);
+
+  char day[12];
+  if (prv_same_day(&event, &today)) {
+    snprintf(day, sizeof(day), "Today");
+  } else if (prv_same_day(&event, &tomorrow)) {
+    snprintf(day, sizeof(day), "Tomorrow");
+  } else {
+    strftime(day, sizeof(day), "%a %b %d", &event);
+  }
+
+  char clock[12];
+  snprintf(buffer, size, "%s %s", day,
+           msgproc_format_time(event.tm_hour, event.tm_min, clock, sizeof(clock)));
+}
+
+static void prv_update_header(void) {
+  switch (s_status) {
+    case EventsStatusRefreshing:
+      snprintf(s_header_text, sizeof(s_header_text), "Refreshing...");
+      break;
+    case EventsStatusOffline:
+      snprintf(s_header_text, sizeof(s_header_text), "Offline");
+      break;
+    default: {
+      const time_t synced = events_store_synced_at();
+      if (synced == 0) {
+        snprintf(s_header_text, sizeof(s_header_text), "Events");
+        break;
+      }
+      const struct tm *synced_tm = localtime(&synced);
+      char clock[12];
+      snprintf(s_header_text, sizeof(s_header_text), "Updated %s",
+               msgproc_format_time(synced_tm->tm_hour, synced_tm->tm_min, clock, sizeof(clock)));
+      break;
+    }
+  }
+}
+
+static void prv_reload(void) {
+  s_first_index = events_store_first_upcoming(time(NULL));
+  s_num_rows = events_store_count() - s_first_index;
+  prv_update_header();
+  if (s_menu_layer) {
+    menu_layer_reload_data(s_menu_layer);
+  }
+}
+
+static void prv_set_status(EventsStatus status) {
+  s_status = status;
+  prv_reload();
+}
+
+static void prv_sync_timer_callback(void *context) {
+  s_sync_timer = NULL;
+  HUBBLE_LOG(APP_LOG_LEVEL_WARNING, "Events sync timed out");
+  s_refresh_pending = false;
+  events_store_revert();
+  prv_set_status(EventsStatusOffline);
+}
+
+static void prv_arm_sync_timer(void) {
+  if (s_sync_timer) {
+    app_timer_reschedule(s_sync_timer, EVENTS_SYNC_TIMEOUT_MS);
+  } else {
+    s_sync_timer = app_timer_register(EVENTS_SYNC_TIMEOUT_MS, prv_sync_timer_callback, NULL);
+  }
+}
 
-// Forward declarations
-static void prv_inbox_received_callback(DictionaryIterator *iter, void *context);
-static void prv_inbox_dropped_callback(AppMessageResult reason, void *context);
-static void prv_outbox_failed_callback(DictionaryIterator *iter, AppMessageResult reason, void *context);
+static void prv_cancel_sync_timer(void) {
+  if (s_sync_timer) {
+    app_timer_cancel(s_sync_timer);
+    s_sync_timer = NULL;
+  }
+}
+
+// Keep what the last sync left on the watch, and say so in the header
+static void prv_sync_failed(void) {
+  prv_cancel_sync_timer();
+  s_refresh_pending = false;
+  events_store_revert();
+  prv_set_status(EventsStatusOffline);
+}
 
 static void prv_request_events_refresh(void) {
   if (!bodymsg_is_ready()) {
     HUBBLE_LOG(APP_LOG_LEVEL_ERROR, "AppMessage not ready for events refresh");
-    text_layer_set_text(s_text_layer, "\n\n\nConnection Error");
+    prv_set_status(EventsStatusOffline);
     return;
   }
 
@@ -25,7 +187,7 @@ static void prv_request_events_refresh(void) {
 
   if (result != APP_MSG_OK) {
     HUBBLE_LOG(APP_LOG_LEVEL_ERROR, "Error preparing outbox: %d", (int)result);
-    text_layer_set_text(s_text_layer, "\n\n\nSend Error");
+    prv_set_status(EventsStatusOffline);
     return;
   }
 
@@ -37,30 +199,80 @@ static void prv_request_events_refresh(void) {
   result = app_message_outbox_send();
   if (result != APP_MSG_OK) {
     HUBBLE_LOG(APP_LOG_LEVEL_ERROR, "Error sending request: %d", (int)result);
-    text_layer_set_text(s_text_layer, "\n\n\nSend Error");
+    prv_set_status(EventsStatusOffline);
     return;
   }
 
   s_refresh_pending = true;
-  text_layer_set_text(s_text_layer, "\n\n\nRefreshing...");
+  prv_arm_sync_timer();
+  prv_set_status(EventsStatusRefreshing);
   HUBBLE_LOG(APP_LOG_LEVEL_INFO, "Requested events refresh");
 }
 
+static uint16_t prv_get_num_rows(MenuLayer *menu_layer, uint16_t section_index, void *context) {
+  // One placeholder row when there's nothing to list
+  return s_num_rows > 0 ? s_num_rows : 1;
+}
+
+static int16_t prv_get_header_height(MenuLayer *menu_layer, uint16_t section_index, void *context) {
+  return MENU_CELL_BASIC_HEADER_HEIGHT;
+}
+
+static void prv_draw_header(GContext *ctx, const Layer *cell_layer, uint16_t section_index, void *context) {
+  menu_cell_basic_header_draw(ctx, cell_layer, s_header_text);
+}
+
+static void prv_draw_row(GContext *ctx, const Layer *cell_layer, MenuIndex *cell_index, void *context) {
+  const EventRecord *record = cell_index->row < s_num_rows
+                                  ? events_store_get(s_first_index + cell_index->row)
+                                  : NULL;
+  if (!record) {
+    menu_cell_basic_draw(ctx, cell_layer, "No events",
+                         s_status == EventsStatusRefreshing ? NULL : "Sync with phone", NULL);
+    return;
+  }
+
+  char title[24];
+  char subtitle[24];
+  prv_format_title(record, title, sizeof(title));
+  prv_format_subtitle(record, subtitle, sizeof(subtitle));
+  menu_cell_basic_draw(ctx, cell_layer, title, subtitle, NULL);
+}
+
+static void prv_select_long_click(MenuLayer *menu_layer, MenuIndex *cell_index, void *context) {
+  // Hidden entry to the memory debug screen
+  heap_debug_show();
+}
+
 static void prv_window_load(Window *window) {
   const Layout *layout = layout_get();
 
   Layer *window_layer = window_get_root_layer(window);
   const GRect bounds = layer_get_bounds(window_layer);
 
-  // Create text layer
-  s_text_layer = text_layer_create(bounds);
-  text_layer_set_background_color(s_text_layer, layout->background);
-  text_layer_set_text_color(s_text_layer, layout->foreground);
-  text_layer_set_text(s_text_layer, "\n\n\nEvents");
-  text_layer_set_font(s_text_layer, fonts_get_system_font(FONT_KEY_GOTHIC_24_BOLD));
-  text_layer_set_text_alignment(s_text_layer, GTextAlignmentCenter);
+  // The stored list shows straight away, even with no phone in reach
+  events_store_open();
 
-  layer_add_child(window_layer, text_layer_get_layer(s_text_layer));
+  s_menu_layer = menu_layer_create(bounds);
+  menu_layer_set_callbacks(s_menu_layer, NULL, (MenuLayerCallbacks){
+    .get_num_rows = prv_get_num_rows,
+    .get_header_height = prv_get_header_height,
+    .draw_header = prv_draw_header,
+    .draw_row = prv_draw_row,
+    .select_long_click = prv_select_long_click,
+  });
+  menu_layer_set_normal_colors(s_menu_layer, layout->background, layout->foreground);
+  menu_layer_set_highlight_colors(s_menu_layer, layout->highlight, layout->highlight_foreground);
+  menu_layer_set_click_config_onto_window(s_menu_layer, window);
+  layer_add_child(window_layer, menu_layer_get_layer(s_menu_layer));
+
+  s_status = EventsStatusIdle;
+  prv_reload();
+
+  // EVENTS_* replies come here while the window is loaded
+  bodymsg_add_handlers(&s_message_handlers);
+
+  heap_stats_record(HeapSiteEvents, HeapEventLoad);
 }
 
 static void prv_window_appear(Window *window) {
@@ -68,46 +280,74 @@ static void prv_window_appear(Window *window) {
   prv_request_events_refresh();
 }
 
-static void prv_inbox_received_callback(DictionaryIterator *iter, void *context) {
+// Declination pushes and the rest fall through to bodymsg
+static bool prv_handle_message(DictionaryIterator *iter) {
+  Tuple *chunk_tuple = dict_find(iter, MESSAGE_KEY_EVENTS_CHUNK);
+  if (chunk_tuple && s_refresh_pending) {
+    if (events_store_handle_chunk(chunk_tuple->value->data, chunk_tuple->length)) {
+      prv_arm_sync_timer();
+    } else {
+      HUBBLE_LOG(APP_LOG_LEVEL_ERROR, "Bad events chunk, %d bytes", chunk_tuple->length);
+      prv_sync_failed();
+    }
+    return true;
+  }
+
   // Check if this is an EVENTS_REFRESHED message
   Tuple *events_refreshed_tuple = dict_find(iter, MESSAGE_KEY_EVENTS_REFRESHED);
-  if (events_refreshed_tuple && s_refresh_pending) {
+  if (!events_refreshed_tuple) {
+    return false;
+  }
+  if (s_refresh_pending) {
     int32_t event_count = events_refreshed_tuple->value->int32;
-    s_refresh_pending = false;
 
-    if (event_count >= 0) {
-      // Success - show count
-      static char buffer[64];
-      snprintf(buffer, sizeof(buffer), "\n\n\nRefreshed %d events", (int)event_count);
-      text_layer_set_text(s_text_layer, buffer);
+    if (event_count >= 0 && events_store_commit(event_count)) {
+      prv_cancel_sync_timer();
+      s_refresh_pending = false;
+      prv_set_status(EventsStatusIdle);
       HUBBLE_LOG(APP_LOG_LEVEL_INFO, "Events refresh completed: %d events", (int)event_count);
     } else {
-      // Error
-      text_layer_set_text(s_text_layer, "\n\n\nRefresh Failed");
       HUBBLE_LOG(APP_LOG_LEVEL_ERROR, "Events refresh failed");
+      prv_sync_failed();
     }
   }
+  return true;
 }
 
-static void prv_inbox_dropped_callback(AppMessageResult reason, void *context) {
+static void prv_inbox_dropped(AppMessageResult reason) {
   HUBBLE_LOG(APP_LOG_LEVEL_ERROR, "Events message dropped. Reason: %d", (int)reason);
+  // A dropped chunk leaves a gap the phone won't resend
   if (s_refresh_pending) {
-    s_refresh_pending = false;
-    text_layer_set_text(s_text_layer, "\n\n\nMessage Error");
+    prv_sync_failed();
   }
 }
 
-static void prv_outbox_failed_callback(DictionaryIterator *iter, AppMessageResult reason, void *context) {
+static void prv_send_failed(AppMessageResult reason) {
   HUBBLE_LOG(APP_LOG_LEVEL_ERROR, "Events message send failed. Reason: %d", (int)reason);
   if (s_refresh_pending) {
-    s_refresh_pending = false;
-    text_layer_set_text(s_text_layer, "\n\n\nSend Failed");
+    prv_sync_failed();
   }
 }
 
+static const BodymsgHandlers s_message_handlers = {
+  .received = prv_handle_message,
+  .dropped = prv_inbox_dropped,
+  .send_failed = prv_send_failed,
+};
+
 static void prv_window_unload(Window *window) {
-  text_layer_destroy(s_text_layer);
-  s_text_layer = NULL;
+  heap_stats_record(HeapSiteEvents, HeapEventUnload);
+
+  bodymsg_remove_handlers(&s_message_handlers);
+  prv_cancel_sync_timer();
+  s_refresh_pending = false;
+
+  menu_layer_destroy(s_menu_layer);
+  s_menu_layer = NULL;
+
+  events_store_close();
+  s_first_index = 0;
+  s_num_rows = 0;
 }
 
 void events_init(void) {
@@ -115,20 +355,6 @@ void events_init(void) {
     return;
   }
 
-  // Initialize bodymsg if not already initialized (for message routing)
-  if (!bodymsg_is_ready()) {
-    bodymsg_init();
-    bodymsg_register_callbacks();
-  }
-
-  // Deregister body message callbacks to allow events to handle messages
-  bodymsg_deregister_callbacks();
-
-  // Register events message callbacks
-  app_message_register_inbox_received(prv_inbox_received_callback);
-  app_message_register_inbox_dropped(prv_inbox_dropped_callback);
-  app_message_register_outbox_failed(prv_outbox_failed_callback);
-
   s_window = window_create();
   window_set_background_color(s_window, layout_get()->background);
   window_set_window_handlers(s_window, (WindowHandlers){
@@ -143,18 +369,10 @@ void events_deinit(void) {
     return;
   }
 
-  // Unregister events message callbacks
-  app_message_register_inbox_received(NULL);
-  app_message_register_inbox_dropped(NULL);
-  app_message_register_outbox_failed(NULL);
-
-  // Re-register body message callbacks
-  bodymsg_register_callbacks();
-
   window_stack_remove(s_window, false);
   window_destroy(s_window);
   s_window = NULL;
-  s_text_layer = NULL;
+  s_menu_layer = NULL;
   s_refresh_pending = false;
 }
 
@@ -169,4 +387,4 @@ void events_hide(void) {
   if (s_window) {
     window_stack_remove(s_window, true);
   }
-}
\ No newline at end of file
+}
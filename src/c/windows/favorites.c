@@ -1,37 +1,43 @@
 #include "favorites.h"
 #include "../style.h"
-#include "../utils/settings.h"
+#include "../utils/favorites_store.h"
 #include "../utils/body_info.h"
+#include "../utils/star_catalog.h"
+#include "../utils/heap_stats.h"
 #include "../utils/logging.h"
 #include "./body/details.h"
 
 static Window *s_window;
-static SimpleMenuLayer *s_menu_layer;
+static MenuLayer *s_menu_layer;
 static TextLayer *s_text_layer;
-static SimpleMenuSection s_menu_sections[1];
-static SimpleMenuItem *s_menu_items = NULL;
+// Body ids of the favorites, in id order; names are looked up as rows are drawn
+static uint16_t *s_favorite_ids = NULL;
 static int s_num_favorites = 0;
 
-static void prv_count_favorites() {
-  s_num_favorites = 0;
-  for (int i = 0; i < NUM_BODIES && i < 32; i++) {
-    if (settings_get()->favorites & (1 << i)) {
-      s_num_favorites++;
-    }
+static uint16_t prv_get_num_rows(MenuLayer *menu_layer, uint16_t section_index, void *context) {
+  return s_num_favorites;
+}
+
+static int16_t prv_get_header_height(MenuLayer *menu_layer, uint16_t section_index, void *context) {
+  return MENU_CELL_BASIC_HEADER_HEIGHT;
+}
+
+static void prv_draw_header(GContext *ctx, const Layer *cell_layer, uint16_t section_index, void *context) {
+  menu_cell_basic_header_draw(ctx, cell_layer, PBL_IF_ROUND_ELSE("        Favorites", "Favorites"));
+}
+
+static void prv_draw_row(GContext *ctx, const Layer *cell_layer, MenuIndex *cell_index, void *context) {
+  char name[STAR_CATALOG_NAME_SIZE];
+  if (cell_index->row >= s_num_favorites ||
+      !body_info_copy_name(s_favorite_ids[cell_index->row], name, sizeof(name))) {
+    name[0] = '\0';
   }
+  menu_cell_basic_draw(ctx, cell_layer, name, NULL, NULL);
 }
 
-static void prv_menu_select_callback(int index, void *context) {
-  // Find the actual body ID from the favorites list
-  int favorite_index = 0;
-  for (int body_id = 0; body_id < NUM_BODIES && body_id < 32; body_id++) {
-    if (settings_get()->favorites & (1 << body_id)) {
-      if (favorite_index == index) {
-        details_show_body(body_id);
-        return;
-      }
-      favorite_index++;
-    }
+static void prv_select_click(MenuLayer *menu_layer, MenuIndex *cell_index, void *context) {
+  if (cell_index->row < s_num_favorites) {
+    details_show_body(s_favorite_ids[cell_index->row]);
   }
 }
 
@@ -40,44 +46,39 @@ static void prv_window_load(Window *window) {
   Layer *window_layer = window_get_root_layer(window);
   const GRect bounds = layer_get_bounds(window_layer);
 
-  prv_count_favorites();
+  s_num_favorites = favorites_store_count();
 
-  HUBBLE_LOG(APP_LOG_LEVEL_INFO, "Settings: %d", settings_get()->favorites);
   HUBBLE_LOG(APP_LOG_LEVEL_INFO, "Favorites: %d", s_num_favorites);
 
   if (s_num_favorites > 0) {
     // Create menu with favorites
-    s_menu_items = malloc(sizeof(SimpleMenuItem) * s_num_favorites);
-    if (!s_menu_items) {
+    s_favorite_ids = malloc(sizeof(uint16_t) * s_num_favorites);
+    if (!s_favorite_ids) {
       HUBBLE_LOG(APP_LOG_LEVEL_ERROR, "Failed to allocate memory for favorites menu items");
+      s_num_favorites = 0;
       return;
     }
 
     int item_index = 0;
-    for (int body_id = 0; body_id < NUM_BODIES && body_id < 32; body_id++) {
-      if (settings_get()->favorites & (1 << body_id)) {
-        s_menu_items[item_index] = (SimpleMenuItem){
-          .title = body_info_get_name(body_id),
-          .callback = prv_menu_select_callback,
-        };
-        item_index++;
-      }
+    for (int body_id = favorites_store_next(0); body_id >= 0 && item_index < s_num_favorites;
+         body_id = favorites_store_next(body_id + 1)) {
+      s_favorite_ids[item_index++] = body_id;
     }
 
-    s_menu_sections[0] = (SimpleMenuSection){
-      .title = PBL_IF_ROUND_ELSE("        Favorites", "Favorites"),
-      .num_items = s_num_favorites,
-      .items = s_menu_items,
-    };
-
     const GRect menu_frame = GRect(bounds.origin.x, bounds.origin.y,
                                    bounds.size.w, bounds.size.h);
-    s_menu_layer = simple_menu_layer_create(menu_frame, window, s_menu_sections,
-                                           ARRAY_LENGTH(s_menu_sections), NULL);
-    MenuLayer *menu_layer = simple_menu_layer_get_menu_layer(s_menu_layer);
-    menu_layer_set_normal_colors(menu_layer, layout->background, layout->foreground);
-    menu_layer_set_highlight_colors(menu_layer, layout->highlight, layout->highlight_foreground);
-    layer_add_child(window_layer, simple_menu_layer_get_layer(s_menu_layer));
+    s_menu_layer = menu_layer_create(menu_frame);
+    menu_layer_set_callbacks(s_menu_layer, NULL, (MenuLayerCallbacks){
+      .get_num_rows = prv_get_num_rows,
+      .get_header_height = prv_get_header_height,
+      .draw_header = prv_draw_header,
+      .draw_row = prv_draw_row,
+      .select_click = prv_select_click,
+    });
+    menu_layer_set_normal_colors(s_menu_layer, layout->background, layout->foreground);
+    menu_layer_set_highlight_colors(s_menu_layer, layout->highlight, layout->highlight_foreground);
+    menu_layer_set_click_config_onto_window(s_menu_layer, window);
+    layer_add_child(window_layer, menu_layer_get_layer(s_menu_layer));
   } else {
     // Show "No favorites yet" text
     const GRect text_frame = GRect(bounds.origin.x + 10, bounds.origin.y + 10,
@@ -90,11 +91,15 @@ static void prv_window_load(Window *window) {
     text_layer_set_font(s_text_layer, fonts_get_system_font(FONT_KEY_GOTHIC_24_BOLD));
     layer_add_child(window_layer, text_layer_get_layer(s_text_layer));
   }
+
+  heap_stats_record(HeapSiteFavorites, HeapEventLoad);
 }
 
 static void prv_window_unload(Window *window) {
+  heap_stats_record(HeapSiteFavorites, HeapEventUnload);
+
   if (s_menu_layer) {
-    simple_menu_layer_destroy(s_menu_layer);
+    menu_layer_destroy(s_menu_layer);
     s_menu_layer = NULL;
   }
 
@@ -103,9 +108,9 @@ static void prv_window_unload(Window *window) {
     s_text_layer = NULL;
   }
 
-  if (s_menu_items) {
-    free(s_menu_items);
-    s_menu_items = NULL;
+  if (s_favorite_ids) {
+    free(s_favorite_ids);
+    s_favorite_ids = NULL;
   }
 
   s_num_favorites = 0;
@@ -0,0 +1,151 @@
+#include "heap_debug.h"
+#include "../style.h"
+#include "../utils/heap_stats.h"
+#include "../utils/logging.h"
+
+#define HEAP_DEBUG_LINE_SIZE 40
+#define HEAP_DEBUG_TEXT_SIZE ((HeapSiteCount * 2 + 3) * HEAP_DEBUG_LINE_SIZE)
+#define HEAP_DEBUG_MARGIN 4
+
+static Window *s_window;
+static ScrollLayer *s_scroll_layer;
+static TextLayer *s_text_layer;
+// Only allocated while the screen is open
+static char *s_text;
+
+static void prv_format(void) {
+  size_t len = snprintf(s_text, HEAP_DEBUG_TEXT_SIZE, "Now %lu used\n%lu free\n",
+                        (unsigned long)heap_bytes_used(), (unsigned long)heap_bytes_free());
+
+  // Peak used / lowest free / deepest stack, in bytes
+  for (int site = 0; site < HeapSiteCount && len < HEAP_DEBUG_TEXT_SIZE; site++) {
+    const HeapMark *mark = heap_stats_get_mark(site);
+    if (!mark->samples) {
+      continue;
+    }
+    len += snprintf(s_text + len, HEAP_DEBUG_TEXT_SIZE - len, "%s x%u\n%lu / %lu / %u\n",
+                    heap_stats_site_name(site), mark->samples,
+                    (unsigned long)mark->peak_used, (unsigned long)mark->min_free, mark->peak_stack);
+  }
+
+  if (len < HEAP_DEBUG_TEXT_SIZE && heap_stats_get_sample_count() == 0) {
+    snprintf(s_text + len, HEAP_DEBUG_TEXT_SIZE - len, "No samples");
+  }
+}
+
+static void prv_refresh(void) {
+  if (!s_text_layer || !s_text) {
+    return;
+  }
+
+  prv_format();
+  text_layer_set_text(s_text_layer, s_text);
+
+  const GRect frame = layer_get_frame(text_layer_get_layer(s_text_layer));
+  const GSize content = text_layer_get_content_size(s_text_layer);
+  layer_set_frame(text_layer_get_layer(s_text_layer),
+                  GRect(frame.origin.x, frame.origin.y, frame.size.w, content.h + HEAP_DEBUG_MARGIN));
+  scroll_layer_set_content_size(s_scroll_layer, GSize(frame.size.w, content.h + HEAP_DEBUG_MARGIN * 2));
+}
+
+static void prv_select_click_handler(ClickRecognizerRef recognizer, void *context) {
+  if (heap_stats_send()) {
+    vibes_short_pulse();
+  }
+}
+
+static void prv_select_long_click_handler(ClickRecognizerRef recognizer, void *context) {
+  heap_stats_reset();
+  vibes_double_pulse();
+  prv_refresh();
+}
+
+static void prv_click_config_provider(void *context) {
+  window_single_click_subscribe(BUTTON_ID_SELECT, prv_select_click_handler);
+  window_long_click_subscribe(BUTTON_ID_SELECT, 0, prv_select_long_click_handler, NULL);
+}
+
+static void prv_window_load(Window *window) {
+  const Layout *layout = layout_get();
+
+  Layer *window_layer = window_get_root_layer(window);
+  const GRect bounds = layer_get_bounds(window_layer);
+
+  s_text = malloc(HEAP_DEBUG_TEXT_SIZE);
+  if (!s_text) {
+    HUBBLE_LOG(APP_LOG_LEVEL_ERROR, "No heap for the debug screen");
+    return;
+  }
+
+  s_scroll_layer = scroll_layer_create(bounds);
+  scroll_layer_set_shadow_hidden(s_scroll_layer, true);
+  scroll_layer_set_callbacks(s_scroll_layer, (ScrollLayerCallbacks){
+                                                 .click_config_provider = prv_click_config_provider,
+                                             });
+  scroll_layer_set_click_config_onto_window(s_scroll_layer, window);
+
+  s_text_layer = text_layer_create(GRect(HEAP_DEBUG_MARGIN, 0, bounds.size.w - HEAP_DEBUG_MARGIN * 2,
+                                         bounds.size.h));
+  text_layer_set_background_color(s_text_layer, GColorClear);
+  text_layer_set_text_color(s_text_layer, layout->foreground);
+  text_layer_set_font(s_text_layer, fonts_get_system_font(FONT_KEY_GOTHIC_18));
+  text_layer_set_text_alignment(s_text_layer, PBL_IF_ROUND_ELSE(GTextAlignmentCenter, GTextAlignmentLeft));
+  scroll_layer_add_child(s_scroll_layer, text_layer_get_layer(s_text_layer));
+
+  layer_add_child(window_layer, scroll_layer_get_layer(s_scroll_layer));
+}
+
+static void prv_window_appear(Window *window) {
+  // Marks change while other windows are open, so re-read them every time
+  prv_refresh();
+}
+
+static void prv_window_unload(Window *window) {
+  if (s_text_layer) {
+    text_layer_destroy(s_text_layer);
+    s_text_layer = NULL;
+  }
+  if (s_scroll_layer) {
+    scroll_layer_destroy(s_scroll_layer);
+    s_scroll_layer = NULL;
+  }
+  free(s_text);
+  s_text = NULL;
+}
+
+void heap_debug_init(void) {
+  if (s_window) {
+    return;
+  }
+
+  s_window = window_create();
+  window_set_background_color(s_window, layout_get()->background);
+  window_set_window_handlers(s_window, (WindowHandlers){
+                                    .load = prv_window_load,
+                                    .appear = prv_window_appear,
+                                    .unload = prv_window_unload,
+                                });
+}
+
+void heap_debug_deinit(void) {
+  if (!s_window) {
+    return;
+  }
+
+  window_stack_remove(s_window, false);
+  window_destroy(s_window);
+  s_window = NULL;
+}
+
+void heap_debug_show(void) {
+  if (!s_window) {
+    heap_debug_init();
+  }
+  window_stack_push(s_window, true);
+}
+
+void heap_debug_hide(void) {
+  if (s_window) {
+    window_stack_remove(s_window, true);
+  }
+}
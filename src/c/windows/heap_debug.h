@@ -0,0 +1,11 @@
+#pragma once
+
+#include <pebble.h>
+
+// Hidden screen listing heap high-water marks per window (long-press SELECT on Events).
+// SELECT sends the marks to the phone; long-press SELECT resets them.
+void heap_debug_init(void);
+void heap_debug_deinit(void);
+
+void heap_debug_show(void);
+void heap_debug_hide(void);
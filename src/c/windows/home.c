@@ -1,18 +1,19 @@
 #include "home.h"
 #include "favorites.h"
 #include "events.h"
-#include "./catalog/planets.h"
-#include "./catalog/constellations_zodiac.h"
-#include "./catalog/constellations.h"
+#include "./catalog/catalog.h"
+#include "./catalog/search.h"
+#include "skymap.h"
 #include "./body/details.h"
 #include "../style.h"
+#include "../utils/heap_stats.h"
 #include "../utils/logging.h"
 
 static Window *s_window;
 static SimpleMenuLayer *s_menu_layer;
 static SimpleMenuSection s_menu_sections[2];
-static SimpleMenuItem s_main_items[2];
-static SimpleMenuItem s_catalog_items[5]; 
+static SimpleMenuItem s_main_items[4];
+static SimpleMenuItem s_catalog_items[6]; 
 
 static void prv_main_menu_select_callback(int index, void *context) {
 
@@ -23,6 +24,12 @@ static void prv_main_menu_select_callback(int index, void *context) {
     case 1:  // Refresh Events
       events_show();
       break;
+    case 2:  // Search by name
+      search_show();
+      break;
+    case 3:  // Sky map
+      skymap_show();
+      break;
     default:
       HUBBLE_LOG(APP_LOG_LEVEL_INFO, "Home menu selected: %s", s_main_items[index].title);
       vibes_short_pulse();
@@ -39,16 +46,19 @@ static void prv_catalog_menu_select_callback(int index, void *context) {
       details_show_body(0);
       break;
     case 1:  // Planets
-      planets_menu_show();
+      catalog_show(CatalogPlanets);
       break;
     case 2:  // The Sun
       details_show_body(9);
       break;
     case 3:  // Constellations - Zodiac
-      constellations_zodiac_menu_show();
+      catalog_show(CatalogZodiac);
       break;
     case 4:  // Constellations - Other
-      constellations_menu_show();
+      catalog_show(CatalogConstellations);
+      break;
+    case 5:  // Bright stars and Messier objects
+      catalog_show(CatalogStars);
       break;
     default:
       vibes_short_pulse();
@@ -71,6 +81,16 @@ static void prv_window_load(Window *window) {
       .title = "Refresh Events",
       .callback = prv_main_menu_select_callback,
   };
+  s_main_items[2] = (SimpleMenuItem){
+      .title = "Search",
+      .subtitle = "Find by name",
+      .callback = prv_main_menu_select_callback,
+  };
+  s_main_items[3] = (SimpleMenuItem){
+      .title = "Sky Map",
+      .subtitle = "What's overhead",
+      .callback = prv_main_menu_select_callback,
+  };
 
   // Catalog items
   s_catalog_items[0] = (SimpleMenuItem){
@@ -95,6 +115,11 @@ static void prv_window_load(Window *window) {
       .subtitle = "Other",
       .callback = prv_catalog_menu_select_callback,
   };
+  s_catalog_items[5] = (SimpleMenuItem){
+      .title = "Stars  >",
+      .subtitle = "& Messier",
+      .callback = prv_catalog_menu_select_callback,
+  };
 
   // Main menu section
   s_menu_sections[0] = (SimpleMenuSection){
@@ -118,9 +143,13 @@ static void prv_window_load(Window *window) {
   menu_layer_set_normal_colors(menu_layer, layout->background, layout->foreground);
   menu_layer_set_highlight_colors(menu_layer, layout->highlight, layout->highlight_foreground);
   layer_add_child(window_layer, simple_menu_layer_get_layer(s_menu_layer));
+
+  heap_stats_record(HeapSiteHome, HeapEventLoad);
 }
 
 static void prv_window_unload(Window *window) {
+  heap_stats_record(HeapSiteHome, HeapEventUnload);
+
   simple_menu_layer_destroy(s_menu_layer);
   s_menu_layer = NULL;
 }
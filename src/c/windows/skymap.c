@@ -0,0 +1,587 @@
+#include "skymap.h"
+#include "../style.h"
+#include "../providers/governor.h"
+#include "../providers/sensor_hub.h"
+#include "../utils/bodymsg.h"
+#include "../utils/body_info.h"
+#include "../utils/compass_worker.h"
+#include "../utils/heap_stats.h"
+#include "../utils/logging.h"
+#include "../utils/settings.h"
+#include "../utils/sky.h"
+#include "../utils/sky_grid.h"
+#include "../utils/star_catalog.h"
+
+// Fixed point: trig lookups are Q16, the projection runs in Q14 like sky.c
+#define SKYMAP_Q_BITS 14
+#define SKYMAP_Q (1 << SKYMAP_Q_BITS)
+#define SKYMAP_Q_SHIFT 2
+
+// Pointing view: the screen's inscribed circle spans +/-45°. Stereographic radius is
+// scale * tan(theta / 2), so scale = radius / tan(22.5°).
+#define SKYMAP_POINTING_SCALE_X1000 2414
+
+#define SKYMAP_MARGIN 2
+#define SKYMAP_MAX_LABELS 4
+// Stars fainter than this (magnitude * 10) are never labelled
+#define SKYMAP_LABEL_MAG_X10 20
+#define SKYMAP_BODY_RADIUS 3
+#define SKYMAP_STATUS_HEIGHT 18
+
+// Sensor updates are coalesced to this rate; the zenith chart only has to keep up
+// with the sky turning (a quarter degree a minute)
+#define SKYMAP_MAX_FPS 10
+#define SKYMAP_FRAME_MS (1000 / SKYMAP_MAX_FPS)
+#define SKYMAP_ZENITH_REFRESH_MS (30 * 1000)
+
+typedef enum {
+  SkyMapModeZenith = 0,
+  SkyMapModePointing,
+} SkyMapMode;
+
+typedef struct {
+  uint16_t index;
+  int8_t magnitude_x10;
+  GPoint point;
+} SkyMapLabel;
+
+// Everything a frame needs to place an object, computed once per frame
+typedef struct {
+  GContext *ctx;
+  GRect bounds;
+  GPoint center;
+  // Rows take a horizontal (up, north, east) vector to the view (forward, right, up)
+  int32_t view[3][3];
+  // Rows take a J2000 equatorial vector to the view, and to local "up"
+  int32_t equatorial[3][3];
+  int32_t up[3];
+  int32_t min_forward;  // Cosine of the viewport's corner angle
+  int32_t scale;        // Pixels at tan(theta / 2) == 1
+  uint16_t visited;
+  uint16_t drawn;
+  uint8_t label_count;
+  SkyMapLabel labels[SKYMAP_MAX_LABELS];
+} SkyMapFrame;
+
+static Window *s_window;
+static Layer *s_map_layer;
+static SkyMapMode s_mode;
+static bool s_grid_ready;
+static AppTimer *s_refresh_timer;
+
+#if defined(PBL_COMPASS)
+static SensorHubSubscription *s_altitude_subscription;
+static SensorHubSubscription *s_azimuth_subscription;
+static SensorHubSubscription *s_calibration_subscription;
+static int16_t s_altitude_deg;
+static int16_t s_azimuth_deg;
+static bool s_is_calibrated;
+static AppTimer *s_frame_timer;
+static time_t s_last_frame_s;
+static uint16_t s_last_frame_ms;
+#endif
+
+static int32_t prv_cdeg_to_trig(int32_t cdeg) {
+  return (cdeg * (TRIG_MAX_ANGLE / 4)) / 9000;
+}
+
+static int32_t prv_sin(int32_t angle) {
+  return sin_lookup(angle) >> SKYMAP_Q_SHIFT;
+}
+
+static int32_t prv_cos(int32_t angle) {
+  return cos_lookup(angle) >> SKYMAP_Q_SHIFT;
+}
+
+static int32_t prv_dot(const int32_t row[3], int32_t x, int32_t y, int32_t z) {
+  return (row[0] * x + row[1] * y + row[2] * z) >> SKYMAP_Q_BITS;
+}
+
+static uint16_t prv_radius(GRect bounds) {
+  const int16_t size = bounds.size.w < bounds.size.h ? bounds.size.w : bounds.size.h;
+  return size / 2 - SKYMAP_MARGIN;
+}
+
+// ---- Projection ----
+
+// View direction and orientation in degrees. The zenith chart looks straight up
+// with the top of the screen toward north, which puts east on the left.
+static void prv_get_view(int16_t *altitude_deg, int16_t *azimuth_deg) {
+#if defined(PBL_COMPASS)
+  if (s_mode == SkyMapModePointing) {
+    *altitude_deg = s_altitude_deg;
+    *azimuth_deg = s_azimuth_deg;
+    // Same correction the locator applies; 255 means unknown
+    const LocalSettings *settings = settings_get();
+    if (settings->magnetic_declination != 255) {
+      *azimuth_deg += settings->magnetic_declination;
+    }
+    return;
+  }
+#endif
+  *altitude_deg = 90;
+  *azimuth_deg = 180;
+}
+
+static bool prv_build_frame(SkyMapFrame *frame, time_t now) {
+  uint16_t sidereal_cdeg;
+  int16_t latitude_cdeg;
+  if (!sky_get_sidereal(now, &sidereal_cdeg, &latitude_cdeg)) {
+    return false;
+  }
+
+  // Equatorial (x toward RA 0h, y toward 6h, z north) to horizontal (up, north, east)
+  const int32_t sidereal = prv_cdeg_to_trig(sidereal_cdeg);
+  const int32_t latitude = prv_cdeg_to_trig(latitude_cdeg);
+  const int32_t sin_lst = prv_sin(sidereal);
+  const int32_t cos_lst = prv_cos(sidereal);
+  const int32_t sin_lat = prv_sin(latitude);
+  const int32_t cos_lat = prv_cos(latitude);
+  const int32_t horizontal[3][3] = {
+    { (cos_lat * cos_lst) >> SKYMAP_Q_BITS, (cos_lat * sin_lst) >> SKYMAP_Q_BITS, sin_lat },
+    { -((sin_lat * cos_lst) >> SKYMAP_Q_BITS), -((sin_lat * sin_lst) >> SKYMAP_Q_BITS), cos_lat },
+    { -sin_lst, cos_lst, 0 },
+  };
+
+  // Horizontal to view: forward along the view direction, right toward increasing
+  // azimuth, up toward the zenith (or north, looking straight up)
+  int16_t altitude_deg;
+  int16_t azimuth_deg;
+  prv_get_view(&altitude_deg, &azimuth_deg);
+  const int32_t sin_alt = prv_sin(DEG_TO_TRIGANGLE(altitude_deg));
+  const int32_t cos_alt = prv_cos(DEG_TO_TRIGANGLE(altitude_deg));
+  const int32_t sin_az = prv_sin(DEG_TO_TRIGANGLE(azimuth_deg));
+  const int32_t cos_az = prv_cos(DEG_TO_TRIGANGLE(azimuth_deg));
+  const int32_t view[3][3] = {
+    { sin_alt, (cos_alt * cos_az) >> SKYMAP_Q_BITS, (cos_alt * sin_az) >> SKYMAP_Q_BITS },
+    { 0, -sin_az, cos_az },
+    { cos_alt, -((sin_alt * cos_az) >> SKYMAP_Q_BITS), -((sin_alt * sin_az) >> SKYMAP_Q_BITS) },
+  };
+
+  for (int i = 0; i < 3; i++) {
+    for (int j = 0; j < 3; j++) {
+      frame->view[i][j] = view[i][j];
+      frame->equatorial[i][j] = prv_dot(view[i], horizontal[0][j], horizontal[1][j],
+                                        horizontal[2][j]);
+    }
+    frame->up[i] = horizontal[0][i];
+  }
+
+  const uint16_t radius = prv_radius(frame->bounds);
+  if (s_mode == SkyMapModeZenith) {
+    // The horizon is the edge of the chart
+    frame->scale = radius;
+    frame->min_forward = 0;
+  } else {
+    frame->scale = (radius * SKYMAP_POINTING_SCALE_X1000) / 1000;
+    // Anything further out than the screen corners can't land on screen
+    const int32_t corner = sky_isqrt(frame->bounds.size.w * frame->bounds.size.w +
+                                     frame->bounds.size.h * frame->bounds.size.h) / 2;
+    frame->min_forward = prv_cos(2 * atan2_lookup(corner, frame->scale));
+  }
+  return true;
+}
+
+static bool prv_project(const SkyMapFrame *frame, int32_t forward, int32_t right, int32_t up,
+                        GPoint *point) {
+  if (forward <= frame->min_forward) {
+    return false;
+  }
+  const int32_t denominator = SKYMAP_Q + forward;
+  point->x = frame->center.x + (frame->scale * right) / denominator;
+  point->y = frame->center.y - (frame->scale * up) / denominator;
+  return grect_contains_point(&frame->bounds, point);
+}
+
+static bool prv_project_horizontal(const SkyMapFrame *frame, int16_t altitude_deg,
+                                   int16_t azimuth_deg, GPoint *point) {
+  const int32_t cos_alt = prv_cos(DEG_TO_TRIGANGLE(altitude_deg));
+  const int32_t up = prv_sin(DEG_TO_TRIGANGLE(altitude_deg));
+  const int32_t north = (cos_alt * prv_cos(DEG_TO_TRIGANGLE(azimuth_deg))) >> SKYMAP_Q_BITS;
+  const int32_t east = (cos_alt * prv_sin(DEG_TO_TRIGANGLE(azimuth_deg))) >> SKYMAP_Q_BITS;
+  return prv_project(frame, prv_dot(frame->view[0], up, north, east),
+                     prv_dot(frame->view[1], up, north, east),
+                     prv_dot(frame->view[2], up, north, east), point);
+}
+
+// Right ascension and declination of the view direction: the equatorial vector
+// that maps to "forward" is the first row of the equatorial-to-view rotation
+static void prv_get_view_center(const SkyMapFrame *frame, uint16_t *ra_cdeg, int16_t *dec_cdeg) {
+  const int32_t *forward = frame->equatorial[0];
+  const int32_t ra = atan2_lookup((int16_t)forward[1], (int16_t)forward[0]);
+  const int32_t horizontal = sky_isqrt((uint32_t)(forward[0] * forward[0] + forward[1] * forward[1]));
+  int32_t dec = atan2_lookup((int16_t)forward[2], (int16_t)horizontal);
+  if (dec > TRIG_MAX_ANGLE / 2) {
+    dec -= TRIG_MAX_ANGLE;
+  }
+  // Inverse of prv_cdeg_to_trig; 0xffff * 9000 stays inside int32, unlike * 36000
+  *ra_cdeg = (uint16_t)((ra * 9000) / (TRIG_MAX_ANGLE / 4));
+  *dec_cdeg = (int16_t)((dec * 9000) / (TRIG_MAX_ANGLE / 4));
+}
+
+// Angular radius of the culling cone, rounded up
+static uint16_t prv_cap_deg(const SkyMapFrame *frame) {
+  const int32_t sin_cap = sky_isqrt((uint32_t)(SKYMAP_Q * SKYMAP_Q - frame->min_forward * frame->min_forward));
+  return TRIGANGLE_TO_DEG(atan2_lookup((int16_t)sin_cap, (int16_t)frame->min_forward)) + 1;
+}
+
+// ---- Drawing ----
+
+static void prv_consider_label(SkyMapFrame *frame, const SkyGridObject *object, GPoint point) {
+  if (object->magnitude_x10 > SKYMAP_LABEL_MAG_X10) {
+    return;
+  }
+
+  // Keep the brightest few, sorted brightest first
+  int slot = frame->label_count;
+  if (slot == SKYMAP_MAX_LABELS) {
+    if (object->magnitude_x10 >= frame->labels[slot - 1].magnitude_x10) {
+      return;
+    }
+    slot--;
+  } else {
+    frame->label_count++;
+  }
+  while (slot > 0 && frame->labels[slot - 1].magnitude_x10 > object->magnitude_x10) {
+    frame->labels[slot] = frame->labels[slot - 1];
+    slot--;
+  }
+  frame->labels[slot] = (SkyMapLabel){
+    .index = object->index,
+    .magnitude_x10 = object->magnitude_x10,
+    .point = point,
+  };
+}
+
+static void prv_draw_object(const SkyGridObject *object, void *context) {
+  SkyMapFrame *frame = context;
+  frame->visited++;
+
+  if (prv_dot(frame->up, object->x, object->y, object->z) < 0) {
+    return;
+  }
+  GPoint point;
+  if (!prv_project(frame, prv_dot(frame->equatorial[0], object->x, object->y, object->z),
+                   prv_dot(frame->equatorial[1], object->x, object->y, object->z),
+                   prv_dot(frame->equatorial[2], object->x, object->y, object->z), &point)) {
+    return;
+  }
+  frame->drawn++;
+
+  if (object->type > StarCatalogTypeDoubleStar) {
+    // Deep-sky objects are rings so they don't read as stars
+    graphics_draw_circle(frame->ctx, point, 2);
+    return;
+  }
+
+  if (object->magnitude_x10 < 0) {
+    graphics_fill_circle(frame->ctx, point, 3);
+  } else if (object->magnitude_x10 < 15) {
+    graphics_fill_circle(frame->ctx, point, 2);
+  } else if (object->magnitude_x10 < 30) {
+    graphics_fill_circle(frame->ctx, point, 1);
+  } else {
+    graphics_draw_pixel(frame->ctx, point);
+  }
+  prv_consider_label(frame, object, point);
+}
+
+static void prv_draw_label(GContext *ctx, const char *text, GPoint point) {
+  graphics_draw_text(ctx, text, fonts_get_system_font(FONT_KEY_GOTHIC_14),
+                     GRect(point.x + 4, point.y - 10, 70, 16), GTextOverflowModeTrailingEllipsis,
+                     GTextAlignmentLeft, NULL);
+}
+
+static void prv_draw_cardinals(SkyMapFrame *frame) {
+  static const char *const names[] = { "N", "E", "S", "W" };
+  const uint16_t radius = prv_radius(frame->bounds);
+
+  for (int i = 0; i < 4; i++) {
+    GPoint point;
+    if (!prv_project_horizontal(frame, 0, i * 90, &point)) {
+      continue;
+    }
+    if (s_mode == SkyMapModeZenith) {
+      // Pull the letter in from the horizon ring
+      point.x = frame->center.x + (point.x - frame->center.x) * (radius - 9) / radius;
+      point.y = frame->center.y + (point.y - frame->center.y) * (radius - 9) / radius;
+    }
+    graphics_draw_text(frame->ctx, names[i], fonts_get_system_font(FONT_KEY_GOTHIC_14_BOLD),
+                       GRect(point.x - 8, point.y - 10, 16, 16), GTextOverflowModeFill,
+                       GTextAlignmentCenter, NULL);
+  }
+}
+
+// Moon, planets and Sun from the snapshot; constellations are areas, not points
+static void prv_draw_bodies(SkyMapFrame *frame, time_t now) {
+  for (uint8_t i = 0; i < sky_get_count(); i++) {
+    uint8_t body_id;
+    int16_t altitude_deg;
+    int16_t azimuth_deg;
+    GPoint point;
+    if (!sky_get_object(i, now, &body_id, &altitude_deg, &azimuth_deg) || body_id > 9 ||
+        altitude_deg < 0 || !prv_project_horizontal(frame, altitude_deg, azimuth_deg, &point)) {
+      continue;
+    }
+    graphics_fill_circle(frame->ctx, point, SKYMAP_BODY_RADIUS);
+    const char *name = body_info_get_name(body_id);
+    if (name) {
+      prv_draw_label(frame->ctx, name, point);
+    }
+  }
+}
+
+static void prv_draw_status(GContext *ctx, GRect bounds, const char *text) {
+  graphics_draw_text(ctx, text, fonts_get_system_font(FONT_KEY_GOTHIC_14),
+                     GRect(bounds.origin.x, bounds.origin.y + bounds.size.h - SKYMAP_STATUS_HEIGHT -
+                               PBL_IF_ROUND_ELSE(12, 0),
+                           bounds.size.w, SKYMAP_STATUS_HEIGHT),
+                     GTextOverflowModeTrailingEllipsis, GTextAlignmentCenter, NULL);
+}
+
+static void prv_map_update_proc(Layer *layer, GContext *ctx) {
+  const Layout *layout = layout_get();
+  time_t start_s;
+  uint16_t start_ms;
+  time_ms(&start_s, &start_ms);
+
+  SkyMapFrame frame = {
+    .ctx = ctx,
+    .bounds = layer_get_bounds(layer),
+  };
+  frame.center = grect_center_point(&frame.bounds);
+  graphics_context_set_text_color(ctx, layout->foreground);
+
+  const time_t now = time(NULL);
+  if (!prv_build_frame(&frame, now)) {
+    prv_draw_status(ctx, frame.bounds, "Waiting for sky data");
+    return;
+  }
+
+  graphics_context_set_stroke_color(ctx, layout->highlight);
+  graphics_context_set_fill_color(ctx, layout->foreground);
+  if (s_mode == SkyMapModeZenith) {
+    graphics_draw_circle(ctx, frame.center, prv_radius(frame.bounds));
+  }
+
+  // Only cells around the view direction are projected
+  if (s_grid_ready) {
+    uint16_t ra_cdeg;
+    int16_t dec_cdeg;
+    prv_get_view_center(&frame, &ra_cdeg, &dec_cdeg);
+    sky_grid_visit_cap(ra_cdeg, dec_cdeg, prv_cap_deg(&frame), prv_draw_object, &frame);
+  }
+
+  // Names are read from flash only for the few labelled stars
+  for (uint8_t i = 0; i < frame.label_count; i++) {
+    char name[STAR_CATALOG_NAME_SIZE];
+    if (star_catalog_get_name(frame.labels[i].index, name, sizeof(name))) {
+      prv_draw_label(ctx, name, frame.labels[i].point);
+    }
+  }
+
+  graphics_context_set_fill_color(ctx, layout->highlight);
+  graphics_context_set_text_color(ctx, layout->highlight);
+  prv_draw_bodies(&frame, now);
+  prv_draw_cardinals(&frame);
+
+#if defined(PBL_COMPASS)
+  if (s_mode == SkyMapModePointing) {
+    graphics_draw_line(ctx, GPoint(frame.center.x - 5, frame.center.y),
+                       GPoint(frame.center.x + 5, frame.center.y));
+    graphics_draw_line(ctx, GPoint(frame.center.x, frame.center.y - 5),
+                       GPoint(frame.center.x, frame.center.y + 5));
+    if (!s_is_calibrated) {
+      graphics_context_set_text_color(ctx, layout->foreground);
+      prv_draw_status(ctx, frame.bounds, "Figure-8 to calibrate");
+    }
+  }
+#endif
+
+  time_t end_s;
+  uint16_t end_ms;
+  time_ms(&end_s, &end_ms);
+  HUBBLE_LOG(APP_LOG_LEVEL_DEBUG, "Sky map frame: %d visited, %d drawn, %d ms", (int)frame.visited,
+             (int)frame.drawn, (int)((end_s - start_s) * 1000 + end_ms - start_ms));
+}
+
+// ---- Updates ----
+
+static void prv_refresh_timer_callback(void *context) {
+  s_refresh_timer = app_timer_register(SKYMAP_ZENITH_REFRESH_MS, prv_refresh_timer_callback, NULL);
+  if (s_map_layer) {
+    layer_mark_dirty(s_map_layer);
+  }
+}
+
+#if defined(PBL_COMPASS)
+static void prv_frame_timer_callback(void *context) {
+  s_frame_timer = NULL;
+  time_ms(&s_last_frame_s, &s_last_frame_ms);
+  if (s_map_layer) {
+    layer_mark_dirty(s_map_layer);
+  }
+}
+
+// Coalesce sensor updates so the map redraws at most SKYMAP_MAX_FPS times a second
+static void prv_request_frame(void) {
+  if (s_frame_timer) {
+    return;
+  }
+
+  time_t now_s;
+  uint16_t now_ms;
+  time_ms(&now_s, &now_ms);
+  const int32_t elapsed_ms = (int32_t)(now_s - s_last_frame_s) * 1000 + (now_ms - s_last_frame_ms);
+  const uint32_t delay_ms =
+      (elapsed_ms >= 0 && elapsed_ms < SKYMAP_FRAME_MS) ? SKYMAP_FRAME_MS - elapsed_ms : 0;
+  s_frame_timer = app_timer_register(delay_ms, prv_frame_timer_callback, NULL);
+}
+
+static void prv_on_altitude(int16_t altitude_deg, void *context) {
+  s_altitude_deg = altitude_deg;
+  prv_request_frame();
+}
+
+static void prv_on_azimuth(int16_t azimuth_deg, void *context) {
+  s_azimuth_deg = azimuth_deg;
+  prv_request_frame();
+}
+
+static void prv_on_calibration(int16_t is_calibrated, void *context) {
+  s_is_calibrated = is_calibrated != 0;
+  prv_request_frame();
+}
+
+static void prv_start_pointing(void) {
+  int16_t worker_azimuth;
+  s_is_calibrated = compass_worker_get_azimuth(&worker_azimuth);
+  if (s_is_calibrated) {
+    s_azimuth_deg = worker_azimuth;
+  }
+  compass_worker_set_paused(true);
+
+  s_altitude_subscription = sensor_hub_subscribe(SensorStreamAltitude, 0, prv_on_altitude, NULL);
+  s_azimuth_subscription = sensor_hub_subscribe(SensorStreamAzimuth, 0, prv_on_azimuth, NULL);
+  s_calibration_subscription =
+      sensor_hub_subscribe(SensorStreamCalibration, 0, prv_on_calibration, NULL);
+  governor_init();
+  governor_request_quality(GovernorQualityHigh);
+}
+
+static void prv_stop_pointing(void) {
+  governor_deinit();
+  sensor_hub_unsubscribe(s_calibration_subscription);
+  sensor_hub_unsubscribe(s_azimuth_subscription);
+  sensor_hub_unsubscribe(s_altitude_subscription);
+  s_calibration_subscription = NULL;
+  s_azimuth_subscription = NULL;
+  s_altitude_subscription = NULL;
+  compass_worker_set_paused(false);
+
+  if (s_frame_timer) {
+    app_timer_cancel(s_frame_timer);
+    s_frame_timer = NULL;
+  }
+}
+
+static void prv_select_click_handler(ClickRecognizerRef recognizer, void *context) {
+  if (s_mode == SkyMapModeZenith) {
+    s_mode = SkyMapModePointing;
+    prv_start_pointing();
+  } else {
+    prv_stop_pointing();
+    s_mode = SkyMapModeZenith;
+  }
+  layer_mark_dirty(s_map_layer);
+}
+
+static void prv_click_config_provider(void *context) {
+  window_single_click_subscribe(BUTTON_ID_SELECT, prv_select_click_handler);
+}
+#endif
+
+static bool prv_handle_message(DictionaryIterator *iter) {
+  if (!sky_handle_message(iter)) {
+    return false;
+  }
+  if (s_map_layer) {
+    layer_mark_dirty(s_map_layer);
+  }
+  return true;
+}
+
+static const BodymsgHandlers s_message_handlers = {
+  .received = prv_handle_message,
+};
+
+static void prv_window_load(Window *window) {
+  Layer *window_layer = window_get_root_layer(window);
+
+  // The grid is the only large allocation and lives as long as the window
+  s_grid_ready = sky_grid_create();
+
+  s_map_layer = layer_create(layer_get_bounds(window_layer));
+  layer_set_update_proc(s_map_layer, prv_map_update_proc);
+  layer_add_child(window_layer, s_map_layer);
+
+  s_mode = SkyMapModeZenith;
+  s_refresh_timer = app_timer_register(SKYMAP_ZENITH_REFRESH_MS, prv_refresh_timer_callback, NULL);
+
+  // Snapshots arrive here while the map is open; bodymsg still takes everything else
+  bodymsg_add_handlers(&s_message_handlers);
+  if (!sky_snapshot_is_fresh()) {
+    sky_request_snapshot();
+  }
+
+  heap_stats_record(HeapSiteSkyMap, HeapEventLoad);
+}
+
+static void prv_window_unload(Window *window) {
+  heap_stats_record(HeapSiteSkyMap, HeapEventUnload);
+
+#if defined(PBL_COMPASS)
+  if (s_mode == SkyMapModePointing) {
+    prv_stop_pointing();
+  }
+#endif
+  if (s_refresh_timer) {
+    app_timer_cancel(s_refresh_timer);
+    s_refresh_timer = NULL;
+  }
+
+  bodymsg_remove_handlers(&s_message_handlers);
+
+  layer_destroy(s_map_layer);
+  s_map_layer = NULL;
+  sky_grid_destroy();
+  s_grid_ready = false;
+
+  // Nothing stays resident between visits
+  window_destroy(window);
+  s_window = NULL;
+}
+
+void skymap_show(void) {
+  if (s_window) {
+    return;
+  }
+
+  s_window = window_create();
+  window_set_background_color(s_window, layout_get()->background);
+#if defined(PBL_COMPASS)
+  window_set_click_config_provider(s_window, prv_click_config_provider);
+#endif
+  window_set_window_handlers(s_window, (WindowHandlers){
+                                    .load = prv_window_load,
+                                    .unload = prv_window_unload,
+                                });
+  window_stack_push(s_window, true);
+}
+
+void skymap_hide(void) {
+  if (s_window) {
+    // The unload handler destroys the window
+    window_stack_remove(s_window, true);
+  }
+}
@@ -0,0 +1,10 @@
+#pragma once
+
+#include <pebble.h>
+
+// Star chart of the catalog and the bodies in the sky snapshot. Starts as a
+// zenith-centered chart of the whole sky above the horizon (north up, east left);
+// on watches with a compass SELECT switches to following the pointing direction.
+// The window is created here and destroyed when it leaves the stack.
+void skymap_show(void);
+void skymap_hide(void);
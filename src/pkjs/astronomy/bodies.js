@@ -8,6 +8,23 @@ var CONSTELLATION_NAMES = [
   'Orion', 'Ursa Major', 'Ursa Minor', 'Cassiopeia', 'Cygnus', 'Crux', 'Lyra'
 ];
 
+// Same refraction option getHorizontal has always passed to Astronomy.Horizon
+var REFRACTION = Astronomy.Refraction.Normal;
+
+// Name -> index into CONSTELLATION_NAMES/CONSTELLATION_COORDS, avoids indexOf per lookup
+var CONSTELLATION_INDEX = {};
+CONSTELLATION_NAMES.forEach(function(name, index) {
+  CONSTELLATION_INDEX[name] = index;
+});
+
+// Fixed RA/Dec as equatorial unit vectors, so a batch only needs one rotation per constellation
+var CONSTELLATION_UNIT_VECTORS = Constellations.CONSTELLATION_COORDS.map(function(coords) {
+  var ra = coords.ra * Math.PI / 180;
+  var dec = coords.dec * Math.PI / 180;
+  var cosDec = Math.cos(dec);
+  return [cosDec * Math.cos(ra), cosDec * Math.sin(ra), Math.sin(dec)];
+});
+
 function resolveBody(body) {
   if (!body) {
     throw new Error('Body is required');
@@ -19,12 +36,12 @@ function getHorizontal(body, observer, date) {
   var when = date || new Date();
   
   // Check if this is a constellation (index >= 10)
-  var constellationIndex = CONSTELLATION_NAMES.indexOf(body);
+  var constellationIndex = CONSTELLATION_INDEX.hasOwnProperty(body) ? CONSTELLATION_INDEX[body] : -1;
   
   if (constellationIndex !== -1) {
     // Use fixed RA/Dec from constellations.js
     var coords = Constellations.CONSTELLATION_COORDS[constellationIndex];
-    var hor = Astronomy.Horizon(when, observer, coords.ra / 15, coords.dec, Astronomy.Refraction.Normal);
+    var hor = Astronomy.Horizon(when, observer, coords.ra / 15, coords.dec, REFRACTION);
     return {
       azimuth: hor.azimuth,
       altitude: hor.altitude
@@ -32,7 +49,7 @@ function getHorizontal(body, observer, date) {
   } else {
     // Use astronomy engine for planets, moon, sun
     var equ = Astronomy.Equator(resolveBody(body), when, observer, true, true);
-    var hor = Astronomy.Horizon(when, observer, equ.ra, equ.dec, Astronomy.Refraction.Normal);
+    var hor = Astronomy.Horizon(when, observer, equ.ra, equ.dec, REFRACTION);
     return {
       azimuth: hor.azimuth,
       altitude: hor.altitude
@@ -40,6 +57,133 @@ function getHorizontal(body, observer, date) {
   }
 }
 
+/**
+ * Convert an equator-of-date vector to horizontal coordinates with a precomputed rotation
+ * @param {RotationMatrix} rotation - Rotation_EQD_HOR for the batch timestamp
+ * @param {Vector} vector - Equator-of-date vector
+ * @returns {Object} {azimuth, altitude} in degrees
+ */
+function rotateToHorizontal(rotation, vector) {
+  var hor = Astronomy.HorizonFromVector(Astronomy.RotateVector(rotation, vector), REFRACTION);
+  return {
+    azimuth: hor.lon,
+    altitude: hor.lat
+  };
+}
+
+/**
+ * One AstroTime for several calls at the same instant; it caches nutation and
+ * sidereal time, so passing it on skips recomputing them
+ * @param {Date|AstroTime} date - The timestamp (defaults to now)
+ * @returns {AstroTime}
+ */
+function makeTime(date) {
+  return Astronomy.MakeTime(date || new Date());
+}
+
+// Local hour angle in degrees [0, 360) from a right ascension in hours
+function hourAngleFrom(lst, ra) {
+  var hourAngle = (lst - ra * 15) % 360;
+  return hourAngle < 0 ? hourAngle + 360 : hourAngle;
+}
+
+/**
+ * Compute horizontal coordinates for many bodies at a single timestamp.
+ * Time conversion, nutation, sidereal time and the observer rotation are computed
+ * once and shared; constellations are handled in one pass over precomputed vectors.
+ * The equatorial position each body needed anyway is returned as an hour angle and
+ * declination, so callers don't have to compute it again.
+ * @param {Array<string>} bodies - Body names (planets, Moon, Sun or constellations)
+ * @param {Observer} observer - The observer location
+ * @param {Date|AstroTime} date - The timestamp (defaults to now)
+ * @returns {Array<Object|null>} {body, azimuth, altitude, hourAngle, declination} per
+ *                               input body, in input order; null for bodies that could
+ *                               not be computed
+ */
+function getHorizontalBatch(bodies, observer, date) {
+  // Nutation and sidereal time are cached on the AstroTime, so every call below reuses them
+  var time = makeTime(date);
+  var rotation = Astronomy.Rotation_EQD_HOR(time, observer);
+  var lst = getLocalSiderealTime(observer, time);
+  var results = new Array(bodies.length);
+  var constellationSlots = [];
+
+  bodies.forEach(function(body, slot) {
+    if (CONSTELLATION_INDEX.hasOwnProperty(body)) {
+      // Deferred to the constellation pass below
+      constellationSlots.push(slot);
+      return;
+    }
+
+    try {
+      var equ = Astronomy.Equator(resolveBody(body), time, observer, true, true);
+      var hor = rotateToHorizontal(rotation, equ.vec);
+      results[slot] = {
+        body: body,
+        azimuth: hor.azimuth,
+        altitude: hor.altitude,
+        hourAngle: hourAngleFrom(lst, equ.ra),
+        declination: equ.dec
+      };
+    } catch (err) {
+      results[slot] = null;
+    }
+  });
+
+  // Constellations: fixed directions, so each is a single rotation of a precomputed vector
+  constellationSlots.forEach(function(slot) {
+    var body = bodies[slot];
+    var index = CONSTELLATION_INDEX[body];
+    var unit = CONSTELLATION_UNIT_VECTORS[index];
+    var coords = Constellations.CONSTELLATION_COORDS[index];
+    var hor = rotateToHorizontal(rotation, new Astronomy.Vector(unit[0], unit[1], unit[2], time));
+    results[slot] = {
+      body: body,
+      azimuth: hor.azimuth,
+      altitude: hor.altitude,
+      hourAngle: hourAngleFrom(lst, coords.ra / 15),
+      declination: coords.dec
+    };
+  });
+
+  return results;
+}
+
+/**
+ * Get the local hour angle and declination of a body, enough for the watch to
+ * propagate its alt/az forward at the sidereal rate
+ * @param {string} body - Body name (planet, Moon, Sun or constellation)
+ * @param {Observer} observer - The observer location
+ * @param {Date} date - The timestamp (defaults to now)
+ * @returns {Object} {hourAngle, declination} in degrees, hourAngle in [0, 360)
+ */
+function getHourAngle(body, observer, date) {
+  var time = Astronomy.MakeTime(date || new Date());
+  var ra;
+  var dec;
+
+  if (CONSTELLATION_INDEX.hasOwnProperty(body)) {
+    var coords = Constellations.CONSTELLATION_COORDS[CONSTELLATION_INDEX[body]];
+    ra = coords.ra / 15;
+    dec = coords.dec;
+  } else {
+    var equ = Astronomy.Equator(resolveBody(body), time, observer, true, true);
+    ra = equ.ra;
+    dec = equ.dec;
+  }
+
+  // Local apparent sidereal time minus right ascension, in degrees
+  var hourAngle = ((Astronomy.SiderealTime(time) + observer.longitude / 15 - ra) * 15) % 360;
+  if (hourAngle < 0) {
+    hourAngle += 360;
+  }
+
+  return {
+    hourAngle: hourAngle,
+    declination: dec
+  };
+}
+
 function getIllumination(body, date) {
   var when = date || new Date();
   return Astronomy.Illumination(resolveBody(body), when);
@@ -55,9 +199,72 @@ function getRiseSet(body, observer, date) {
   };
 }
 
+/**
+ * Local apparent sidereal time in degrees [0, 360), which turns any right
+ * ascension into a local hour angle (hourAngle = LST - RA)
+ */
+function getLocalSiderealTime(observer, date) {
+  var time = makeTime(date);
+  var lst = ((Astronomy.SiderealTime(time) + observer.longitude / 15) * 15) % 360;
+  return lst < 0 ? lst + 360 : lst;
+}
+
+/**
+ * Horizontal position of a fixed J2000 direction (catalog star or deep-sky object)
+ * @param {number} ra - Right ascension in degrees
+ * @param {number} dec - Declination in degrees
+ * @param {Observer} observer - The observer location
+ * @param {Date} date - The timestamp (defaults to now)
+ * @returns {Object} {azimuth, altitude} in degrees
+ */
+function getFixedHorizontal(ra, dec, observer, date) {
+  var hor = Astronomy.Horizon(date || new Date(), observer, ra / 15, dec, REFRACTION);
+  return {
+    azimuth: hor.azimuth,
+    altitude: hor.altitude
+  };
+}
+
+/**
+ * Local hour angle of a fixed J2000 direction, same shape as getHourAngle
+ */
+function getFixedHourAngle(ra, dec, observer, date) {
+  var hourAngle = (getLocalSiderealTime(observer, date) - ra) % 360;
+  if (hourAngle < 0) {
+    hourAngle += 360;
+  }
+  return {
+    hourAngle: hourAngle,
+    declination: dec
+  };
+}
+
+/**
+ * Rise/set times of a fixed J2000 direction. Circumpolar and never-rising
+ * objects come back as nulls.
+ */
+function getFixedRiseSet(ra, dec, observer, date) {
+  var when = date || new Date();
+  // Star1 is a user-defined slot; the distance only matters for parallax
+  Astronomy.DefineStar(Astronomy.Body.Star1, ra / 15, dec, 1000);
+  var rise = Astronomy.SearchRiseSet(Astronomy.Body.Star1, observer, +1, when, 1);
+  var set = Astronomy.SearchRiseSet(Astronomy.Body.Star1, observer, -1, when, 1);
+  return {
+    rise: rise ? rise.date : null,
+    set: set ? set.date : null
+  };
+}
 
 module.exports = {
+  CONSTELLATION_NAMES: CONSTELLATION_NAMES,
+  getFixedHorizontal: getFixedHorizontal,
+  getFixedHourAngle: getFixedHourAngle,
+  getFixedRiseSet: getFixedRiseSet,
   getHorizontal: getHorizontal,
+  getHorizontalBatch: getHorizontalBatch,
+  getHourAngle: getHourAngle,
   getIllumination: getIllumination,
-  getRiseSet: getRiseSet
-};
\ No newline at end of file
+  getLocalSiderealTime: getLocalSiderealTime,
+  getRiseSet: getRiseSet,
+  makeTime: makeTime
+};
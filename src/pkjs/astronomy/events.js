@@ -9,8 +9,9 @@
 var Astronomy = require('astronomy-engine');
 var logger = require('../logger');
 
-// Cache for events with timestamp and observer info
-// Cache key format: "lat_lon_date" where lat/lon rounded to 2 decimal places, date to day
+// Per-source cache for events with timestamp and observer info
+// Cache key format: "source_lat_lon_date" where lat/lon rounded to 2 decimal places, date to day.
+// Location-independent sources (seasons, transits, eclipses, apsides) use "source_date".
 var eventsCache = {};
 var CACHE_DURATION_MS = 30 * 60 * 1000; // 30 minutes
 var LOCATION_THRESHOLD_DEGREES = 0.01; // ~1km threshold for significant movement
@@ -40,6 +41,11 @@ function getMoonPhase(date) {
   return Math.floor(((angle + 22.5) % 360) / 45); // 0-7
 }
 
+// Exact phase angle in degrees, 0=new, 90=first quarter, 180=full
+function getMoonPhaseAngle(date) {
+  return Astronomy.MoonPhase(date || new Date());
+}
+
 function getMoonPhaseName(date) {
   var phaseIndex = getMoonPhase(date);
   return phaseNames[phaseIndex];
@@ -463,9 +469,9 @@ function getSolarNoonMidnightSequence(observer, date) {
 }
 
 /**
- * Check if cached events are still valid (within time limit and observer hasn't moved significantly)
+ * Check if a cached event source is still valid (within time limit and observer hasn't moved significantly)
  * @param {Object} cacheEntry - The cached entry with timestamp and observer
- * @param {Observer} observer - Current observer location
+ * @param {Observer|null} observer - Current observer location, or null for location-independent sources
  * @returns {boolean} True if cache is valid
  */
 function isCacheValid(cacheEntry, observer) {
@@ -477,6 +483,10 @@ function isCacheValid(cacheEntry, observer) {
     return false;
   }
 
+  if (!observer || !cacheEntry.observer) {
+    return true;
+  }
+
   // Check if observer has moved significantly
   var latDiff = Math.abs(cacheEntry.observer.latitude - observer.latitude);
   var lonDiff = Math.abs(cacheEntry.observer.longitude - observer.longitude);
@@ -485,36 +495,152 @@ function isCacheValid(cacheEntry, observer) {
 }
 
 /**
- * Generate cache key based on observer location, date, and settings
- * @param {Observer} observer - Observer location
+ * Generate cache key for a single event source based only on its own inputs
+ * @param {string} source - Event source name (e.g. 'riseSet:Moon', 'twilight:civil', 'eclipse')
+ * @param {Observer|null} observer - Observer location, or null for location-independent sources
  * @param {Date} date - Reference date
- * @param {Object} settings - Clay settings object
  * @returns {string} Cache key
  */
-function generateCacheKey(observer, date, settings) {
+function generateCacheKey(source, observer, date) {
+  var dateStr = date.toISOString().split('T')[0]; // YYYY-MM-DD format
+  if (!observer) {
+    return source + '_' + dateStr;
+  }
+
   var lat = Math.round(observer.latitude * 100) / 100; // Round to 2 decimal places
   var lon = Math.round(observer.longitude * 100) / 100; // Round to 2 decimal places
-  var dateStr = date.toISOString().split('T')[0]; // YYYY-MM-DD format
+  return source + '_' + lat + '_' + lon + '_' + dateStr;
+}
 
-  // Create a hash of the settings to include in cache key
-  var settingsHash = '';
-  if (settings) {
-    var keys = Object.keys(settings).sort();
-    settingsHash = keys.map(function(key) {
-      var value = settings[key];
-      if (Array.isArray(value)) {
-        return value.join(',');
-      }
-      return String(value);
-    }).join('|');
+/**
+ * Drop expired entries so the cache doesn't grow across days.
+ */
+function pruneCache() {
+  var now = new Date().getTime();
+  Object.keys(eventsCache).forEach(function(key) {
+    if (now - eventsCache[key].timestamp > CACHE_DURATION_MS) {
+      delete eventsCache[key];
+    }
+  });
+}
+
+/**
+ * Return the cached event list for a source, computing and caching it on a miss.
+ * Each source is cached independently, so toggling one setting only costs the
+ * newly enabled sources.
+ * @param {string} source - Event source name
+ * @param {Observer|null} observer - Observer location, or null for location-independent sources
+ * @param {Date} date - Reference date
+ * @param {Function} compute - Returns an array of events for this source
+ * @returns {Array} Events for this source (shared with the cache; do not mutate)
+ */
+function getCachedSource(source, observer, date, compute) {
+  var cacheKey = generateCacheKey(source, observer, date);
+  var entry = eventsCache[cacheKey];
+  if (entry && isCacheValid(entry, observer)) {
+    return entry.events;
+  }
+
+  var events;
+  try {
+    events = compute();
+  } catch (e) {
+    // Don't cache failures so the next request retries
+    logger.log('Error getting ' + source + ' events:', e.message);
+    return [];
   }
 
-  return lat + '_' + lon + '_' + dateStr + '_' + settingsHash;
+  pruneCache();
+  eventsCache[cacheKey] = {
+    timestamp: new Date().getTime(),
+    observer: observer ? {
+      latitude: observer.latitude,
+      longitude: observer.longitude
+    } : null,
+    events: events
+  };
+
+  return events;
+}
+
+function computeRiseSetEvents(body, observer, referenceDate) {
+  var events = [];
+  var riseSet = getRiseSetSequence(body, observer, referenceDate);
+  riseSet.rise.forEach(function(riseTime, index) {
+    if (riseTime) {
+      var event = {
+        type: 'rise',
+        body: body,
+        time: riseTime
+      };
+      if (body === 'Moon' && riseSet.moonPhases && riseSet.moonPhases[index]) {
+        event.moonPhase = riseSet.moonPhases[index];
+      }
+      events.push(event);
+    }
+  });
+  riseSet.set.forEach(function(setTime) {
+    if (setTime) {
+      events.push({
+        type: 'set',
+        body: body,
+        time: setTime
+      });
+    }
+  });
+  return events;
+}
+
+function computeTwilightEvents(twilightType, observer, referenceDate) {
+  var events = [];
+  var twilight = getTwilightSequence('Sun', observer, referenceDate, twilightType);
+  twilight.dawn.forEach(function(dawnTime) {
+    if (dawnTime) {
+      events.push({
+        type: 'dawn',
+        subtype: twilightType,
+        time: dawnTime
+      });
+    }
+  });
+  twilight.dusk.forEach(function(duskTime) {
+    if (duskTime) {
+      events.push({
+        type: 'dusk',
+        subtype: twilightType,
+        time: duskTime
+      });
+    }
+  });
+  return events;
+}
+
+function computeSolarNoonMidnightEvents(observer, referenceDate) {
+  var events = [];
+  var solarNoonMidnight = getSolarNoonMidnightSequence(observer, referenceDate);
+  solarNoonMidnight.noon.forEach(function(noonTime) {
+    if (noonTime) {
+      events.push({
+        type: 'noon',
+        time: noonTime
+      });
+    }
+  });
+  solarNoonMidnight.midnight.forEach(function(midnightTime) {
+    if (midnightTime) {
+      events.push({
+        type: 'midnight',
+        time: midnightTime
+      });
+    }
+  });
+  return events;
 }
 
 /**
  * Get all available astronomical events for the given observer and date.
- * Results are cached for 30 minutes if the observer hasn't moved significantly.
+ * Each event source is cached for 30 minutes by its own inputs, so only
+ * sources that are enabled and not already cached are computed.
  * @param {Observer} observer - The observer location
  * @param {Date} date - The reference date (defaults to today)
  * @param {Object} settings - Clay settings object controlling which events to include
@@ -522,7 +648,6 @@ function generateCacheKey(observer, date, settings) {
  */
 function getAllEvents(observer, date, settings) {
   var referenceDate = date || new Date();
-  var cacheKey = generateCacheKey(observer, referenceDate, settings);
 
   // Parse settings (default to enabled if not provided)
   var cfg = settings || {};
@@ -539,12 +664,7 @@ function getAllEvents(observer, date, settings) {
   var moonApogeePerigee = cfg.CFG_MOON_APOGEE_PERIGEE !== false;
   var planetEvents = cfg.CFG_PLANET_EVENTS || [false, false, false, false, false, false, false, false];
 
-  // Check cache first
-  if (eventsCache[cacheKey] && isCacheValid(eventsCache[cacheKey], observer)) {
-    return eventsCache[cacheKey].events;
-  }
-
-  // Calculate all events
+  // Assembled per call from cached sources; sources themselves are never mutated
   var events = {
     riseSetEvents: [],
     twilightEvents: [],
@@ -571,178 +691,61 @@ function getAllEvents(observer, date, settings) {
 
   // Get rise/set events for all bodies
   bodies.forEach(function(body) {
-    try {
-      var riseSet = getRiseSetSequence(body, observer, referenceDate);
-      riseSet.rise.forEach(function(riseTime, index) {
-        if (riseTime) {
-          var event = {
-            type: 'rise',
-            body: body,
-            time: riseTime
-          };
-          if (body === 'Moon' && riseSet.moonPhases && riseSet.moonPhases[index]) {
-            event.moonPhase = riseSet.moonPhases[index];
-          }
-          events.riseSetEvents.push(event);
-        }
-      });
-      riseSet.set.forEach(function(setTime) {
-        if (setTime) {
-          events.riseSetEvents.push({
-            type: 'set',
-            body: body,
-            time: setTime
-          });
-        }
-      });
-    } catch (e) {
-      // Skip bodies that might not be visible or calculable
-      logger.log('Error getting rise/set for ' + body + ':', e.message);
-    }
+    events.riseSetEvents = events.riseSetEvents.concat(
+      getCachedSource('riseSet:' + body, observer, referenceDate, function() {
+        return computeRiseSetEvents(body, observer, referenceDate);
+      }));
   });
 
   // Get twilight events for Sun
-  try {
-    if (sunCivilTwilight) {
-      var civilTwilight = getTwilightSequence('Sun', observer, referenceDate, 'civil');
-      civilTwilight.dawn.forEach(function(dawnTime) {
-        if (dawnTime) {
-          events.twilightEvents.push({
-            type: 'dawn',
-            subtype: 'civil',
-            time: dawnTime
-          });
-        }
-      });
-      civilTwilight.dusk.forEach(function(duskTime) {
-        if (duskTime) {
-          events.twilightEvents.push({
-            type: 'dusk',
-            subtype: 'civil',
-            time: duskTime
-          });
-        }
-      });
-    }
-
-    if (sunNauticalTwilight) {
-      var nauticalTwilight = getTwilightSequence('Sun', observer, referenceDate, 'nautical');
-      nauticalTwilight.dawn.forEach(function(dawnTime) {
-        if (dawnTime) {
-          events.twilightEvents.push({
-            type: 'dawn',
-            subtype: 'nautical',
-            time: dawnTime
-          });
-        }
-      });
-      nauticalTwilight.dusk.forEach(function(duskTime) {
-        if (duskTime) {
-          events.twilightEvents.push({
-            type: 'dusk',
-            subtype: 'nautical',
-            time: duskTime
-          });
-        }
-      });
-    }
-
-    if (sunAstronomicalTwilight) {
-      var astronomicalTwilight = getTwilightSequence('Sun', observer, referenceDate, 'astronomical');
-      astronomicalTwilight.dawn.forEach(function(dawnTime) {
-        if (dawnTime) {
-          events.twilightEvents.push({
-            type: 'dawn',
-            subtype: 'astronomical',
-            time: dawnTime
-          });
-        }
-      });
-      astronomicalTwilight.dusk.forEach(function(duskTime) {
-        if (duskTime) {
-          events.twilightEvents.push({
-            type: 'dusk',
-            subtype: 'astronomical',
-            time: duskTime
-          });
-        }
-      });
-    }
-  } catch (e) {
-    logger.log('Error getting twilight events:', e.message);
-  }
+  var twilightTypes = [];
+  if (sunCivilTwilight) twilightTypes.push('civil');
+  if (sunNauticalTwilight) twilightTypes.push('nautical');
+  if (sunAstronomicalTwilight) twilightTypes.push('astronomical');
+  twilightTypes.forEach(function(twilightType) {
+    events.twilightEvents = events.twilightEvents.concat(
+      getCachedSource('twilight:' + twilightType, observer, referenceDate, function() {
+        return computeTwilightEvents(twilightType, observer, referenceDate);
+      }));
+  });
 
   // Get solar noon/midnight events
   if (sunSolarNoonMidnight) {
-    try {
-      var solarNoonMidnight = getSolarNoonMidnightSequence(observer, referenceDate);
-      solarNoonMidnight.noon.forEach(function(noonTime) {
-        if (noonTime) {
-          events.solarNoonMidnightEvents.push({
-            type: 'noon',
-            time: noonTime
-          });
-        }
-      });
-      solarNoonMidnight.midnight.forEach(function(midnightTime) {
-        if (midnightTime) {
-          events.solarNoonMidnightEvents.push({
-            type: 'midnight',
-            time: midnightTime
-          });
-        }
-      });
-    } catch (e) {
-      logger.log('Error getting solar noon/midnight events:', e.message);
-    }
+    events.solarNoonMidnightEvents = getCachedSource('noonMidnight', observer, referenceDate, function() {
+      return computeSolarNoonMidnightEvents(observer, referenceDate);
+    }).slice();
   }
 
-  // Get seasonal events (equinoxes/solstices)
+  // Get seasonal events (equinoxes/solstices); not location dependent
   if (sunSolstices || sunEquinoxes) {
-    try {
+    events.seasonalEvents = getCachedSource('seasons', null, referenceDate, function() {
       var seasonalEvent = getNextSeasonalEvent(referenceDate);
-      if (seasonalEvent) {
-        events.seasonalEvents.push(seasonalEvent);
-      }
-    } catch (e) {
-      logger.log('Error getting seasonal events:', e.message);
-    }
+      return seasonalEvent ? [seasonalEvent] : [];
+    }).slice();
   }
 
-  // Get transit events
+  // Get transit events; not location dependent
   if (sunSolarTransits) {
-    try {
+    events.transitEvents = getCachedSource('transit', null, referenceDate, function() {
       var transitEvent = getNextTransit(referenceDate);
-      if (transitEvent && transitEvent.start) {
-        events.transitEvents.push(transitEvent);
-      }
-    } catch (e) {
-      logger.log('Error getting transit events:', e.message);
-    }
+      return (transitEvent && transitEvent.start) ? [transitEvent] : [];
+    }).slice();
   }
 
-  // Get eclipse events
+  // Get eclipse events; global search, not location dependent
   if (sunEclipses) {
-    try {
+    events.eclipseEvents = getCachedSource('eclipse', null, referenceDate, function() {
       var eclipseEvent = getNextEclipse(referenceDate);
-      if (eclipseEvent && eclipseEvent.peak) {
-        events.eclipseEvents.push(eclipseEvent);
-      }
-    } catch (e) {
-      logger.log('Error getting eclipse events:', e.message);
-    }
+      return (eclipseEvent && eclipseEvent.peak) ? [eclipseEvent] : [];
+    }).slice();
   }
 
-  // Get lunar apsis events
+  // Get lunar apsis events; not location dependent
   if (moonApogeePerigee) {
-    try {
+    events.lunarApsisEvents = getCachedSource('apsis', null, referenceDate, function() {
       var apsisEvent = getNextLunarApsis(referenceDate);
-      if (apsisEvent && apsisEvent.time) {
-        events.lunarApsisEvents.push(apsisEvent);
-      }
-    } catch (e) {
-      logger.log('Error getting lunar apsis events:', e.message);
-    }
+      return (apsisEvent && apsisEvent.time) ? [apsisEvent] : [];
+    }).slice();
   }
 
   // Sort events by time within each category
@@ -754,16 +757,6 @@ function getAllEvents(observer, date, settings) {
     });
   });
 
-  // Cache the results
-  eventsCache[cacheKey] = {
-    timestamp: new Date().getTime(),
-    observer: {
-      latitude: observer.latitude,
-      longitude: observer.longitude
-    },
-    events: events
-  };
-
   return events;
 }
 
@@ -776,6 +769,7 @@ module.exports = {
   getNextEclipse,
   getNextLunarApsis,
   getMoonPhase,
+  getMoonPhaseAngle,
   getMoonPhaseName,
   getAllEvents
 };
@@ -1,12 +1,16 @@
-var Astronomy = require('astronomy-engine');
+var Startup = require('../startup');
 var logger = require('../logger');
 
+// Only needed once a location fix arrives, so keep it off the startup path
+var Astronomy = Startup.lazy('astronomy-engine', function() { return require('astronomy-engine'); });
+
 var DEFAULT_ALTITUDE_METERS = 0;
 
 function coordsToObserver(position) {
   var coords = position.coords || {};
   var altitude = typeof coords.altitude === 'number' ? coords.altitude : DEFAULT_ALTITUDE_METERS;
-  return new Astronomy.Observer(coords.latitude, coords.longitude, altitude);
+  var Observer = Astronomy().Observer;
+  return new Observer(coords.latitude, coords.longitude, altitude);
 }
 
 function requestLocation() {
@@ -121,6 +121,19 @@ module.exports = [
       }
     ]
   },
+  {"type":"heading", "defaultValue": "Locator"},
+  {
+    "type": "section",
+    "items": [
+      {
+        "type": "toggle",
+        "messageKey": "CFG_BACKGROUND_COMPASS",
+        "label": "Keep Compass Calibrated",
+        "defaultValue": false,
+        "description": "Runs a background worker that briefly wakes the compass every few minutes, so the locator opens with a calibrated heading. Compass watches only; uses a little extra battery."
+      }
+    ]
+  },
   {
     "type": "section",
     "items": [
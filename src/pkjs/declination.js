@@ -2,39 +2,110 @@ var Keys = require('message_keys');
 var geomagnetism = require('geomagnetism');
 var logger = require('./logger');
 
-function getMagneticDeclination(observer, date) {
+// Declination barely changes over a month or a few km, so both the WMM model
+// and its results are cached rather than rebuilt per request.
+var LOCATION_QUANTUM_DEGREES = 0.1; // ~10km
+var modelCache = { epoch: null, model: null };
+var resultCache = {};
+
+// Set once the declination has been delivered to the watch this session
+var sessionPushed = false;
+var sessionPushPending = false;
+
+/**
+ * Month-granularity epoch used to key the model cache
+ * @param {Date} when - Reference date
+ * @returns {number} Months since year 0
+ */
+function getEpoch(when) {
+  return when.getUTCFullYear() * 12 + when.getUTCMonth();
+}
+
+/**
+ * Get the geomagnetic model for the given date, building it only when the epoch changes
+ * @param {Date} when - Reference date
+ * @returns {Object} geomagnetism model
+ */
+function getModel(when) {
+  var epoch = getEpoch(when);
+  if (modelCache.epoch !== epoch || !modelCache.model) {
+    modelCache.model = geomagnetism.model(when);
+    modelCache.epoch = epoch;
+    resultCache = {}; // Results from a previous epoch are no longer valid
+    logger.log('Built geomagnetic model for epoch ' + epoch);
+  }
+  return modelCache.model;
+}
+
+function quantize(value) {
+  return Math.round(value / LOCATION_QUANTUM_DEGREES) * LOCATION_QUANTUM_DEGREES;
+}
+
+/**
+ * Get the geomagnetic field direction at the observer
+ * @param {Observer} observer - The observer location
+ * @param {Date} date - Reference date (defaults to now)
+ * @returns {Object|null} {decl, incl} in degrees, or null if it cannot be computed
+ */
+function getMagneticField(observer, date) {
   if (!observer || !observer.latitude || !observer.longitude) {
-    logger.log('Cannot calculate magnetic declination: invalid observer');
+    logger.log('Cannot calculate magnetic field: invalid observer');
     return null;
   }
 
   try {
-    // Create geomagnetism model for the given date (or current date if none provided)
+    // Use the model for the given date (or current date if none provided)
     var when = date || new Date();
-    var model = geomagnetism.model(when);
+    var model = getModel(when);
+
+    // Quantize so nearby fixes share one cached result
+    var lat = quantize(observer.latitude);
+    var lon = quantize(observer.longitude);
+    var heightKm = (observer.height !== undefined && observer.height !== null) ?
+      Math.round(observer.height / 100) / 10 : null;
+
+    var cacheKey = lat.toFixed(1) + '_' + lon.toFixed(1) + '_' + heightKm;
+    if (resultCache.hasOwnProperty(cacheKey)) {
+      return resultCache[cacheKey];
+    }
 
     // Get magnetic declination at the observer's location
     // Note: geomagnetism expects [lat, lon] array, and optionally altitude in km
-    var location = [observer.latitude, observer.longitude];
+    var location = [lat, lon];
 
-    // If observer has height, convert from meters to kilometers for geomagnetism
-    if (observer.height !== undefined && observer.height !== null) {
-      location.push(observer.height / 1000);
+    // If observer has height, pass it in kilometers for geomagnetism
+    if (heightKm !== null) {
+      location.push(heightKm);
     }
 
     var magneticInfo = model.point(location);
+    var field = { decl: magneticInfo.decl, incl: magneticInfo.incl };
+    resultCache[cacheKey] = field;
 
-    logger.log('Magnetic declination at (' + observer.latitude + ', ' + observer.longitude +
-      '): ' + magneticInfo.decl + ' degrees');
+    logger.log('Magnetic field at (' + lat + ', ' + lon +
+      '): declination ' + field.decl + ', inclination ' + field.incl + ' degrees');
 
-    return magneticInfo.decl;
+    return field;
   } catch (err) {
-    logger.log('Error calculating magnetic declination: ' + err.message);
+    logger.log('Error calculating magnetic field: ' + err.message);
     return null;
   }
 }
 
-function sendMagneticDeclination(declination) {
+function getMagneticDeclination(observer, date) {
+  var field = getMagneticField(observer, date);
+  return field ? field.decl : null;
+}
+
+/**
+ * Send the declination to the watch, stamped with the location and date it was computed for
+ * @param {number} declination - Declination in degrees
+ * @param {Observer} observer - Observer the declination was computed for
+ * @param {Date} date - Date the declination was computed for
+ * @param {Function} onSuccess - Optional callback when the watch acknowledges
+ * @param {Function} onFailure - Optional callback when delivery fails
+ */
+function sendMagneticDeclination(declination, observer, date, onSuccess, onFailure) {
   if (declination === null) {
     logger.log('Not sending magnetic declination: value is null');
     return;
@@ -42,23 +113,64 @@ function sendMagneticDeclination(declination) {
 
   // Round declination to nearest integer degree
   var declinationRounded = Math.round(declination);
+  var when = date || new Date();
 
   Pebble.sendAppMessage(
     (function() {
       var dict = {};
       dict[Keys.DECLINATION] = declinationRounded;
+      if (observer) {
+        dict[Keys.DECLINATION_LAT] = Math.round(observer.latitude * 10);
+        dict[Keys.DECLINATION_LON] = Math.round(observer.longitude * 10);
+
+        // Dip angle lets the watch tilt-compensate its heading; served from the cache
+        var field = getMagneticField(observer, when);
+        if (field && typeof field.incl === 'number') {
+          dict[Keys.INCLINATION] = Math.round(field.incl);
+        }
+      }
+      dict[Keys.DECLINATION_TIME] = Math.floor(when.getTime() / 1000);
       return dict;
     })(),
     function() {
       logger.log('Sent magnetic declination: ' + declinationRounded + ' degrees');
+      if (onSuccess) onSuccess();
     },
     function(err) {
       logger.log('Failed to send magnetic declination: ' + JSON.stringify(err));
+      if (onFailure) onFailure(err);
     }
   );
 }
 
+/**
+ * Push the declination to the watch once per session so the locator never has to ask for it
+ * @param {Observer} observer - The observer location
+ */
+function pushDeclinationOnce(observer) {
+  if (sessionPushed || sessionPushPending) {
+    return;
+  }
+
+  var when = new Date();
+  var declination = getMagneticDeclination(observer, when);
+  if (declination === null) {
+    return;
+  }
+
+  sessionPushPending = true;
+  sendMagneticDeclination(declination, observer, when, function() {
+    sessionPushPending = false;
+    sessionPushed = true;
+  }, function() {
+    // Leave unset so a later REQUEST_DECLINATION still gets answered
+    sessionPushPending = false;
+  });
+}
+
 module.exports = {
+  getMagneticField: getMagneticField,
   getMagneticDeclination: getMagneticDeclination,
-  sendMagneticDeclination: sendMagneticDeclination
+  sendMagneticDeclination: sendMagneticDeclination,
+  pushDeclinationOnce: pushDeclinationOnce
 };
@@ -0,0 +1,193 @@
+/**
+ * Streams the upcoming event table to the watch (see src/c/utils/events_store.c),
+ * so the events window can list it offline.
+ *
+ * EventsChunk layout (little-endian), sent one chunk at a time, each after the
+ * previous one was acknowledged:
+ * chunk index (8 bit uint), chunk count (8 bit uint),
+ * base time (32 bit uint) minutes since the Unix epoch
+ * then 4 bytes per event, in time order:
+ * type (8 bit uint), body id (8 bit uint),
+ * minutes after the previous event, or after the base time for the first (16 bit uint)
+ * EVENTS_REFRESHED follows with the number of events sent, or -1 on failure.
+ */
+var Keys = require('message_keys');
+var Events = require('./astronomy/events');
+var MsgProc = require('./msgproc');
+var logger = require('./logger');
+
+// Order matches the EventType enum in events_store.h
+var TYPES = {
+  rise: 0,
+  set: 1,
+  civilDawn: 2,
+  civilDusk: 3,
+  nauticalDawn: 4,
+  nauticalDusk: 5,
+  astronomicalDawn: 6,
+  astronomicalDusk: 7,
+  noon: 8,
+  midnight: 9,
+  marchEquinox: 10,
+  juneSolstice: 11,
+  septemberEquinox: 12,
+  decemberSolstice: 13,
+  transit: 14,
+  lunarEclipse: 15,
+  solarEclipse: 16,
+  perigee: 17,
+  apogee: 18
+};
+
+var MOON_ID = 0;
+var SUN_ID = 9;
+
+// Fits the watch's 256-byte inbox with room for the dictionary
+var RECORDS_PER_CHUNK = 40;
+var MAX_DELTA_MINUTES = 0xffff;
+// The watch keeps 160; past events age out of its ring first
+var MAX_EVENTS = 120;
+
+function toMinutes(date) {
+  return Math.floor(date.getTime() / 60000);
+}
+
+function bodyId(name) {
+  return MsgProc.BODY_NAMES.indexOf(name);
+}
+
+/**
+ * Flatten getAllEvents() into { type, body, minutes } records in time order
+ * @param {Object} allEvents - Result of Events.getAllEvents
+ * @param {Date} from - Events before this are left out
+ * @returns {Array<Object>}
+ */
+function flatten(allEvents, from) {
+  var records = [];
+  function add(type, body, date) {
+    if (type !== undefined && date && body >= 0 && date >= from) {
+      records.push({ type: type, body: body, minutes: toMinutes(date) });
+    }
+  }
+
+  allEvents.riseSetEvents.forEach(function(event) {
+    add(event.type === 'rise' ? TYPES.rise : TYPES.set, bodyId(event.body), event.time);
+  });
+  allEvents.twilightEvents.forEach(function(event) {
+    add(TYPES[event.subtype + (event.type === 'dawn' ? 'Dawn' : 'Dusk')], SUN_ID, event.time);
+  });
+  allEvents.solarNoonMidnightEvents.forEach(function(event) {
+    add(event.type === 'noon' ? TYPES.noon : TYPES.midnight, SUN_ID, event.time);
+  });
+  allEvents.seasonalEvents.forEach(function(event) {
+    add(TYPES[event.type], SUN_ID, event.date);
+  });
+  allEvents.transitEvents.forEach(function(event) {
+    add(TYPES.transit, bodyId(event.body), event.start);
+  });
+  allEvents.eclipseEvents.forEach(function(event) {
+    add(event.type === 'lunar' ? TYPES.lunarEclipse : TYPES.solarEclipse,
+      event.type === 'lunar' ? MOON_ID : SUN_ID, event.peak);
+  });
+  allEvents.lunarApsisEvents.forEach(function(event) {
+    add(event.kind === 'perigee' ? TYPES.perigee : TYPES.apogee, MOON_ID, event.time);
+  });
+
+  records.sort(function(a, b) {
+    return a.minutes - b.minutes;
+  });
+  return records.slice(0, MAX_EVENTS);
+}
+
+/**
+ * Delta-encode records into EventsChunk byte arrays. A gap too long for 16 bits
+ * (seasons and eclipses can be months out) starts a new chunk with its own base.
+ * @param {Array<Object>} records - Output of flatten
+ * @returns {Array<Array<number>>}
+ */
+function pack(records) {
+  var groups = [];
+  var group = null;
+  var previous = 0;
+  records.forEach(function(record) {
+    if (!group || group.records.length === RECORDS_PER_CHUNK ||
+        record.minutes - previous > MAX_DELTA_MINUTES) {
+      group = { base: record.minutes, records: [] };
+      groups.push(group);
+      previous = record.minutes;
+    }
+    group.records.push({ type: record.type, body: record.body, delta: record.minutes - previous });
+    previous = record.minutes;
+  });
+
+  return groups.map(function(group, index) {
+    var bytes = [
+      index, groups.length,
+      group.base & 0xff, (group.base >>> 8) & 0xff, (group.base >>> 16) & 0xff, (group.base >>> 24) & 0xff
+    ];
+    group.records.forEach(function(record) {
+      bytes.push(record.type, record.body, record.delta & 0xff, (record.delta >> 8) & 0xff);
+    });
+    return bytes;
+  });
+}
+
+function sendRefreshed(count) {
+  var dict = {};
+  dict[Keys.EVENTS_REFRESHED] = count;
+  Pebble.sendAppMessage(dict,
+    function() {
+      logger.log('Sent events refresh response: ' + count);
+    },
+    function(err) {
+      logger.log('Failed to send events refresh response: ' + JSON.stringify(err));
+    }
+  );
+}
+
+/**
+ * Compute the event table and stream it to the watch, then send EVENTS_REFRESHED
+ * @param {Observer} observer - The observer location
+ * @param {Date} date - Reference date; events from its start onward are sent
+ * @param {Object} settings - Clay settings object controlling which events to include
+ */
+function sync(observer, date, settings) {
+  var records;
+  try {
+    records = flatten(Events.getAllEvents(observer, date, settings), date);
+  } catch (err) {
+    logger.log('Error computing events for the watch: ' + err.message);
+    sendRefreshed(-1);
+    return;
+  }
+
+  var chunks = pack(records);
+  logger.log('Streaming ' + records.length + ' events in ' + chunks.length + ' chunks');
+
+  function sendChunk(index) {
+    if (index >= chunks.length) {
+      sendRefreshed(records.length);
+      return;
+    }
+    var dict = {};
+    dict[Keys.EVENTS_CHUNK] = chunks[index];
+    Pebble.sendAppMessage(dict,
+      function() {
+        sendChunk(index + 1);
+      },
+      function(err) {
+        // The watch keeps its last complete table
+        logger.log('Failed to send events chunk ' + index + ': ' + JSON.stringify(err));
+      }
+    );
+  }
+  sendChunk(0);
+}
+
+module.exports = {
+  TYPES: TYPES,
+  flatten: flatten,
+  pack: pack,
+  sync: sync,
+  sendRefreshed: sendRefreshed
+};
@@ -0,0 +1,90 @@
+/**
+ * Decodes HEAP_STATS reports from the watch (see src/c/utils/heap_stats.c).
+ * The latest report is kept in localStorage so it can be inspected after the fact.
+ */
+var logger = require('./logger');
+
+var FORMAT_VERSION = 1;
+var SITE_BYTES = 12;
+var STORAGE_KEY = 'heap-stats';
+
+// Order matches the HeapSite enum
+var SITE_NAMES = ['Home', 'Favorites', 'Events', 'Catalog', 'Details', 'Locator', 'Image', 'Message', 'Sky Map'];
+
+function readU16(bytes, offset) {
+  return bytes[offset] | (bytes[offset + 1] << 8);
+}
+
+function readU32(bytes, offset) {
+  return readU16(bytes, offset) + readU16(bytes, offset + 2) * 65536;
+}
+
+/**
+ * Unpack a HEAP_STATS byte array
+ * @param {Array<number>} bytes - Payload from the watch
+ * @returns {Object|null} { used, free, sites: [{ name, peakUsed, minFree, peakStack, samples }] }
+ */
+function decode(bytes) {
+  if (!bytes || bytes.length < 10 || bytes[0] !== FORMAT_VERSION) {
+    return null;
+  }
+  var siteCount = bytes[1];
+  if (bytes.length < 10 + siteCount * SITE_BYTES) {
+    return null;
+  }
+
+  var report = { used: readU32(bytes, 2), free: readU32(bytes, 6), sites: [] };
+  for (var i = 0; i < siteCount; i++) {
+    var offset = 10 + i * SITE_BYTES;
+    report.sites.push({
+      name: SITE_NAMES[i] || ('site' + i),
+      peakUsed: readU32(bytes, offset),
+      minFree: readU32(bytes, offset + 4),
+      peakStack: readU16(bytes, offset + 8),
+      samples: readU16(bytes, offset + 10)
+    });
+  }
+  return report;
+}
+
+/**
+ * Decode, log and store a report
+ * @param {Array<number>} bytes - Payload from the watch
+ * @returns {boolean} True if the payload was a valid report
+ */
+function handleReport(bytes) {
+  var report = decode(bytes);
+  if (!report) {
+    logger.log('Ignoring malformed heap stats');
+    return false;
+  }
+
+  report.received = Date.now();
+  localStorage.setItem(STORAGE_KEY, JSON.stringify(report));
+
+  logger.log('Heap now: ' + report.used + ' used, ' + report.free + ' free');
+  report.sites.forEach(function(site) {
+    if (site.samples > 0) {
+      logger.log('  ' + site.name + ': peak ' + site.peakUsed + ', min free ' + site.minFree +
+        ', stack ' + site.peakStack + ' (' + site.samples + ' samples)');
+    }
+  });
+  return true;
+}
+
+/**
+ * Ask the watch for its current heap high-water marks
+ */
+function request() {
+  Pebble.sendAppMessage({ 'REQUEST_HEAP_STATS': 1 }, function() {
+    logger.log('Requested heap stats');
+  }, function(err) {
+    logger.log('Failed to request heap stats: ' + JSON.stringify(err));
+  });
+}
+
+module.exports = {
+  decode: decode,
+  handleReport: handleReport,
+  request: request
+};
@@ -1,16 +1,72 @@
+var Startup = require('./startup');
 var Observer = require('./astronomy/observer');
-var Bodies = require('./astronomy/bodies');
-var Events = require('./astronomy/events');
-var MsgProc = require('./msgproc');
-var Declination = require('./declination');
-var PinPusher = require('./pinpusher');
-var Clay = require('@rebble/clay');
-var clayConfig = require('./config');
 var Keys = require('message_keys');
 var logger = require('./logger');
-var clay = new Clay(clayConfig);
+
+// Heavy modules (astronomy-engine, WMM coefficients, Clay, pinpusher) are only
+// evaluated on first use so they don't delay the 'ready' event
+var MsgProc = Startup.lazy('msgproc', function() { return require('./msgproc'); });
+var Declination = Startup.lazy('declination', function() { return require('./declination'); });
+var PinPusher = Startup.lazy('pinpusher', function() { return require('./pinpusher'); });
+var HeapStats = Startup.lazy('heapstats', function() { return require('./heapstats'); });
+var EventSync = Startup.lazy('eventsync', function() { return require('./eventsync'); });
+var getClay = Startup.lazy('clay', function() {
+  var Clay = require('@rebble/clay');
+  var clayConfig = require('./config');
+  return new Clay(clayConfig, null, { autoHandleEvents: false });
+});
+
+// Platforms with a magnetometer; others never use the declination
+var COMPASS_PLATFORMS = ['basalt', 'chalk', 'emery'];
 
 var activeObserver = null;
+var firstBodyAnswered = false;
+
+Startup.mark('modules');
+
+function hasCompass() {
+  var info = Pebble.getActiveWatchInfo ? Pebble.getActiveWatchInfo() : null;
+  // Assume a compass when the platform is unknown so declination still works
+  return !info || COMPASS_PLATFORMS.indexOf(info.platform) !== -1;
+}
+
+function isBodyRequest(payload) {
+  return payload.hasOwnProperty("REQUEST_BODY") || payload.hasOwnProperty(Keys.REQUEST_BODY);
+}
+
+function getFixedRequest(payload) {
+  if (payload.hasOwnProperty("REQUEST_FIXED")) {
+    return payload.REQUEST_FIXED;
+  }
+  return payload.hasOwnProperty(Keys.REQUEST_FIXED) ? payload[Keys.REQUEST_FIXED] : null;
+}
+
+function isSkyRequest(payload) {
+  return payload.hasOwnProperty("REQUEST_SKY") || payload.hasOwnProperty(Keys.REQUEST_SKY);
+}
+
+function getHeapStats(payload) {
+  if (payload.hasOwnProperty("HEAP_STATS")) {
+    return payload.HEAP_STATS;
+  }
+  return payload.hasOwnProperty(Keys.HEAP_STATS) ? payload[Keys.HEAP_STATS] : null;
+}
+
+// Clay is created lazily, so its events are handled here instead of by Clay itself
+Pebble.addEventListener('showConfiguration', function() {
+  Pebble.openURL(getClay().generateUrl());
+});
+
+Pebble.addEventListener('webviewclosed', function(e) {
+  if (!e || !e.response) {
+    return;
+  }
+  Pebble.sendAppMessage(getClay().getSettings(e.response), function() {
+    logger.log('Sent config data to Pebble');
+  }, function(err) {
+    logger.log('Failed to send config data: ' + JSON.stringify(err));
+  });
+});
 
 // Handle messages from the watch - single listener for all message types
 Pebble.addEventListener('appmessage', function(e) {
@@ -18,13 +74,54 @@ Pebble.addEventListener('appmessage', function(e) {
   logger.log('Received payload: ' + JSON.stringify(payload));
 
   // Try body request handler first (if observer is available)
-  if (activeObserver) {
-    var handled = MsgProc.registerBodyRequestHandler(function() { return activeObserver; })(payload);
+  if (activeObserver && isBodyRequest(payload)) {
+    var handled = MsgProc().registerBodyRequestHandler(function() { return activeObserver; })(payload);
     if (handled) {
+      if (!firstBodyAnswered) {
+        firstBodyAnswered = true;
+        Startup.mark('first body');
+        Startup.report('first body');
+      }
       return; // Body request was handled
     }
   }
 
+  // Catalog stars and deep-sky objects arrive as coordinates rather than a body id
+  var fixedRequest = getFixedRequest(payload);
+  if (fixedRequest) {
+    if (!activeObserver) {
+      logger.log('No active observer, cannot answer fixed request');
+      return;
+    }
+    try {
+      MsgProc().sendFixedPackage(fixedRequest, activeObserver, new Date());
+    } catch (error) {
+      logger.log('Error handling fixed request: ' + error.message);
+    }
+    return;
+  }
+
+  // Locator overlay asks for every body above the horizon in one message
+  if (isSkyRequest(payload)) {
+    if (!activeObserver) {
+      logger.log('No active observer, cannot send sky snapshot');
+      return;
+    }
+    try {
+      MsgProc().sendSkySnapshot(activeObserver, new Date());
+    } catch (error) {
+      logger.log('Error handling sky request: ' + error.message);
+    }
+    return;
+  }
+
+  // Memory report, sent from the watch's debug screen or in answer to REQUEST_HEAP_STATS
+  var heapStats = getHeapStats(payload);
+  if (heapStats) {
+    HeapStats().handleReport(heapStats);
+    return;
+  }
+
   // Handle declination request
   if (payload.hasOwnProperty("REQUEST_DECLINATION")) {
     logger.log('Received REQUEST_DECLINATION');
@@ -35,9 +132,10 @@ Pebble.addEventListener('appmessage', function(e) {
     }
     
     try {
-      var declination = Declination.getMagneticDeclination(activeObserver);
+      var now = new Date();
+      var declination = Declination().getMagneticDeclination(activeObserver, now);
       if (declination !== null) {
-        Declination.sendMagneticDeclination(declination);
+        Declination().sendMagneticDeclination(declination, activeObserver, now);
       } else {
         logger.log('Failed to calculate magnetic declination');
       }
@@ -86,40 +184,33 @@ Pebble.addEventListener('appmessage', function(e) {
       }
     }
 
+    // Use midnight of current day as reference to capture all of today's events
+    var today = new Date();
+    today.setHours(0, 0, 0, 0);
+
+    // Timeline pins are a side channel; the watch's own list doesn't depend on them
     try {
-      // Push astronomy events and get count
-      // Use midnight of current day as reference to capture all of today's events
-      var today = new Date();
-      today.setHours(0, 0, 0, 0);
-      var eventCount = PinPusher.pushAstronomyEvents(activeObserver, today, claySettings);
-      logger.log('Pushed ' + eventCount + ' events to timeline');
-      Pebble.sendAppMessage(
-        { 'EVENTS_REFRESHED': eventCount },
-        function() {
-          logger.log('Sent events refresh success response with count: ' + eventCount);
-        },
-        function(err) {
-          logger.log('Failed to send events refresh success: ' + JSON.stringify(err));
-        }
-      );
+      var pinCount = PinPusher().pushAstronomyEvents(activeObserver, today, claySettings);
+      logger.log('Pushed ' + pinCount + ' events to timeline');
     } catch (error) {
       logger.log('Error pushing events:', error);
-      Pebble.sendAppMessage(
-        { 'EVENTS_REFRESHED': -1 },
-        function() {
-          logger.log('Sent events refresh error response');
-        },
-        function(err) {
-          logger.log('Failed to send events refresh error: ' + JSON.stringify(err));
-        }
-      );
     }
+
+    // Streams the table to the watch and answers with EVENTS_REFRESHED
+    EventSync().sync(activeObserver, today, claySettings);
   }
 });
 
 Pebble.addEventListener('ready', function() {
+  Startup.mark('ready');
+  Startup.report('ready');
   logger.log('PebbleKit JS ready!');
 
+  // With debug logging on, pull the watch's heap high-water marks into the log
+  if (logger.ENABLED) {
+    HeapStats().request();
+  }
+
   // Get current clay settings
   var claySettingsString = localStorage.getItem('clay-settings');
   var claySettings = {};
@@ -132,15 +223,19 @@ Pebble.addEventListener('ready', function() {
   }
   logger.log('Current clay settings:', JSON.stringify(claySettings));
 
-  // PinPusher.pushTestPin();
-  // PinPusher.deleteTestPin();
+  // PinPusher().pushTestPin();
+  // PinPusher().deleteTestPin();
 
   Observer.initObserver().then(function(observer) {
     activeObserver = observer;
+    Startup.mark('observer');
     logger.log('Observer ready (lat=' + observer.latitude +
       ', lon=' + observer.longitude + ', h=' + observer.height + ')');
 
-     
+    // Push declination once per session so the locator never waits on the phone
+    if (hasCompass()) {
+      Declination().pushDeclinationOnce(observer);
+    }
     }).catch(function(err) {
       logger.log('Proceeding without observer: ' + err.message);
 
@@ -9,6 +9,29 @@
  * set hour (5 bit uint) 0-23
  * set minute (6 bit uint) 0-59
  * luminance * 10 (9 bit signed) -256 to 255
+ *
+ * BodyEquatorial layout (6 bytes, little-endian), sent alongside so the watch
+ * can keep the target current at the sidereal rate:
+ * hour angle (16 bit uint) hundredths of a degree, 0-35999
+ * declination (16 bit signed) hundredths of a degree
+ * observer latitude (16 bit signed) hundredths of a degree
+ *
+ * MoonPhase (integer) is sent with the Moon's BodyPackage: phase angle in
+ * hundredths of a degree, 0-35999, 0 new and 18000 full. The watch renders the
+ * disc from it; the 3-bit phase in the package only names the phase.
+ *
+ * FixedRequest layout (5 bytes, little-endian), sent by the watch for catalog
+ * stars and deep-sky objects, which have no id the phone knows:
+ * right ascension (16 bit uint) hundredths of a degree, 0-35999
+ * declination (16 bit signed) hundredths of a degree
+ * magnitude * 10 (8 bit signed)
+ * The answer is a BodyPackage with body id 31 plus a BodyEquatorial.
+ *
+ * SkySnapshot layout (little-endian): observer latitude (16 bit signed,
+ * hundredths of a degree), local sidereal time (16 bit uint, hundredths of
+ * a degree) and observer longitude (16 bit signed, hundredths of a degree),
+ * then 5 bytes per body above the horizon:
+ * body id (8 bit uint), hour angle (16 bit uint), declination (16 bit signed)
  */
 
 var Keys = require('message_keys');
@@ -51,6 +74,9 @@ var BODY_NAMES = [
   "Lyra"
 ];
 
+var FIXED_BODY_ID = 31;   // BodyPackage id for catalog objects
+var FIXED_REQUEST_LENGTH = 5;
+
 var SENTINEL_HOUR = 31;   // fits in 5 bits
 var SENTINEL_MIN = 63;    // fits in 6 bits
 
@@ -128,19 +154,22 @@ function packBodyPackage(bodyId, observer, date) {
   var az = horizontal ? encodeUnsigned(horizontal.azimuth || 0, 9, 0, 360) : 0;
   var alt = horizontal ? encodeSigned(horizontal.altitude || 0, 8, -90, 90) : 0;
 
-  var riseHour = riseSet.rise ? riseSet.rise.getHours() : SENTINEL_HOUR;
-  var riseMin = riseSet.rise ? riseSet.rise.getMinutes() : SENTINEL_MIN;
-  var setHour = riseSet.set ? riseSet.set.getHours() : SENTINEL_HOUR;
-  var setMin = riseSet.set ? riseSet.set.getMinutes() : SENTINEL_MIN;
-
-
-  logger.log('Rise/set: ' + riseHour + ':' + riseMin + ' - ' + setHour + ':' + setMin);
   logger.log('Illum: ' + illum.mag);
   logger.log('Phase: ' + phase);
   
   var lumTimes10 = encodeSigned((illum && illum.mag != null) ? illum.mag * 10 : 0, 9, -256, 255);
   var phaseIndex = encodeUnsigned(phase, 3, 0, 7);
 
+  return writeBodyPackage(bodyId, phaseIndex, az, alt, riseSet, lumTimes10);
+}
+
+// Bit-pack the fields in BodyPackage order; az/alt/lum are already encoded
+function writeBodyPackage(bodyId, phaseIndex, az, alt, riseSet, lumTimes10) {
+  var riseHour = riseSet.rise ? riseSet.rise.getHours() : SENTINEL_HOUR;
+  var riseMin = riseSet.rise ? riseSet.rise.getMinutes() : SENTINEL_MIN;
+  var setHour = riseSet.set ? riseSet.set.getHours() : SENTINEL_HOUR;
+  var setMin = riseSet.set ? riseSet.set.getMinutes() : SENTINEL_MIN;
+
   var buffer = new Uint8Array(7);
   var bitPos = 0;
   function write(value, width) {
@@ -168,12 +197,145 @@ function packBodyPackage(bodyId, observer, date) {
   return buffer;
 }
 
+function decodeFixedRequest(bytes) {
+  if (!bytes || bytes.length !== FIXED_REQUEST_LENGTH) {
+    throw new Error('Invalid fixed request');
+  }
+  var ra = bytes[0] | (bytes[1] << 8);
+  var dec = bytes[2] | (bytes[3] << 8);
+  if (dec & 0x8000) {
+    dec -= 0x10000;
+  }
+  var mag = bytes[4] & 0x80 ? bytes[4] - 0x100 : bytes[4];
+  return { ra: ra / 100, dec: dec / 100, magTimes10: mag };
+}
+
+function packFixedPackage(fixed, observer, date) {
+  var when = date || new Date();
+
+  var horizontal = Bodies.getFixedHorizontal(fixed.ra, fixed.dec, observer, when);
+
+  var riseSet;
+  try {
+    riseSet = Bodies.getFixedRiseSet(fixed.ra, fixed.dec, observer, when);
+  } catch (err) {
+    logger.log('Warning: Could not calculate rise/set for fixed object: ' + err.message);
+    riseSet = { rise: null, set: null };
+  }
+
+  return writeBodyPackage(FIXED_BODY_ID, 0,
+    encodeUnsigned(horizontal.azimuth, 9, 0, 360),
+    encodeSigned(horizontal.altitude, 8, -90, 90),
+    riseSet,
+    encodeSigned(fixed.magTimes10, 9, -256, 255));
+}
+
+function packFixedEquatorial(fixed, observer, date) {
+  var equatorial = Bodies.getFixedHourAngle(fixed.ra, fixed.dec, observer, date || new Date());
+
+  var hourAngle = Math.round(equatorial.hourAngle * 100) % 36000;
+  var declination = encodeSigned(equatorial.declination * 100, 16, -9000, 9000);
+  var latitude = encodeSigned(observer.latitude * 100, 16, -9000, 9000);
+
+  return [
+    hourAngle & 0xff, (hourAngle >> 8) & 0xff,
+    declination & 0xff, (declination >> 8) & 0xff,
+    latitude & 0xff, (latitude >> 8) & 0xff
+  ];
+}
+
+function packBodyEquatorial(bodyId, observer, date) {
+  var bodyName = BODY_NAMES[bodyId];
+  var equatorial = Bodies.getHourAngle(bodyName, observer, date || new Date());
+
+  var hourAngle = Math.round(equatorial.hourAngle * 100) % 36000;
+  var declination = encodeSigned(equatorial.declination * 100, 16, -9000, 9000);
+  var latitude = encodeSigned(observer.latitude * 100, 16, -9000, 9000);
+
+  return [
+    hourAngle & 0xff, (hourAngle >> 8) & 0xff,
+    declination & 0xff, (declination >> 8) & 0xff,
+    latitude & 0xff, (latitude >> 8) & 0xff
+  ];
+}
+
+function packSkySnapshot(observer, date) {
+  // One AstroTime, so sidereal time and nutation are computed once for the snapshot
+  var time = Bodies.makeTime(date);
+  var horizontal = Bodies.getHorizontalBatch(BODY_NAMES, observer, time);
+  var latitude = encodeSigned(observer.latitude * 100, 16, -9000, 9000);
+  var sidereal = Math.round(Bodies.getLocalSiderealTime(observer, time) * 100) % 36000;
+  var longitude = encodeSigned(observer.longitude * 100, 16, -18000, 18000);
+  var bytes = [
+    latitude & 0xff, (latitude >> 8) & 0xff,
+    sidereal & 0xff, (sidereal >> 8) & 0xff,
+    longitude & 0xff, (longitude >> 8) & 0xff
+  ];
+
+  horizontal.forEach(function(position, bodyId) {
+    if (!position || position.altitude < 0) {
+      return;
+    }
+    // The batch already has each body's equatorial position
+    var hourAngle = Math.round(position.hourAngle * 100) % 36000;
+    var declination = encodeSigned(position.declination * 100, 16, -9000, 9000);
+    bytes.push(bodyId,
+      hourAngle & 0xff, (hourAngle >> 8) & 0xff,
+      declination & 0xff, (declination >> 8) & 0xff);
+  });
+
+  return bytes;
+}
+
+function sendSkySnapshot(observer, date) {
+  var bytes = packSkySnapshot(observer, date);
+  Pebble.sendAppMessage(
+    (function() {
+      var dict = {};
+      dict[Keys.SKY_SNAPSHOT] = bytes;
+      return dict;
+    })(),
+    function() {
+      logger.log('Sent sky snapshot with ' + ((bytes.length - 6) / 5) + ' bodies');
+    },
+    function(err) {
+      logger.log('Failed to send sky snapshot: ' + JSON.stringify(err));
+    }
+  );
+}
+
 function sendBodyPackage(bodyId, observer, date) {
-  var payload = packBodyPackage(bodyId, observer, date);
+  var when = date || new Date();
+  var payload = packBodyPackage(bodyId, observer, when);
+
+  var equatorial = null;
+  try {
+    equatorial = packBodyEquatorial(bodyId, observer, when);
+  } catch (err) {
+    // The watch falls back to the frozen alt/az in the body package
+    logger.log('Warning: Could not calculate hour angle for body ' + bodyId + ': ' + err.message);
+  }
+
+  var moonPhase = null;
+  if (bodyId === 0) {
+    try {
+      moonPhase = Math.round(Events.getMoonPhaseAngle(when) * 100) % 36000;
+    } catch (err) {
+      // The watch falls back to the phase bin in the body package
+      logger.log('Warning: Could not calculate moon phase angle: ' + err.message);
+    }
+  }
+
   Pebble.sendAppMessage(
     (function() {
       var dict = {};
       dict[Keys.BODY_PACKAGE] = Array.from(payload);
+      if (equatorial) {
+        dict[Keys.BODY_EQUATORIAL] = equatorial;
+      }
+      if (moonPhase !== null) {
+        dict[Keys.MOON_PHASE] = moonPhase;
+      }
       return dict;
     })(),
     function() {
@@ -185,6 +347,28 @@ function sendBodyPackage(bodyId, observer, date) {
   );
 }
 
+function sendFixedPackage(bytes, observer, date) {
+  var when = date || new Date();
+  var fixed = decodeFixedRequest(bytes);
+  var payload = packFixedPackage(fixed, observer, when);
+  var equatorial = packFixedEquatorial(fixed, observer, when);
+
+  Pebble.sendAppMessage(
+    (function() {
+      var dict = {};
+      dict[Keys.BODY_PACKAGE] = Array.from(payload);
+      dict[Keys.BODY_EQUATORIAL] = equatorial;
+      return dict;
+    })(),
+    function() {
+      logger.log('Sent body package for fixed object at ' + fixed.ra + ', ' + fixed.dec);
+    },
+    function(err) {
+      logger.log('Failed to send fixed body package: ' + JSON.stringify(err));
+    }
+  );
+}
+
 function createBodyRequestHandler(observerProvider) {
   return function(payload) {
     logger.log('Processing body request from payload: ' + JSON.stringify(payload));
@@ -231,7 +415,12 @@ function registerBodyRequestHandler(observerProvider) {
 }
 
 module.exports = {
+  BODY_NAMES: BODY_NAMES,
   packBodyPackage: packBodyPackage,
+  packBodyEquatorial: packBodyEquatorial,
+  packSkySnapshot: packSkySnapshot,
+  sendSkySnapshot: sendSkySnapshot,
   sendBodyPackage: sendBodyPackage,
+  sendFixedPackage: sendFixedPackage,
   registerBodyRequestHandler: registerBodyRequestHandler
 };
\ No newline at end of file
@@ -0,0 +1,60 @@
+/**
+ * Startup profiling and lazy module loading for pkjs.
+ * Marks are measured from when this module is first evaluated, so it must be
+ * the first require in index.js. Output goes through logger.
+ */
+var logger = require('./logger');
+
+var startTime = Date.now();
+var marks = [];
+var reported = {};
+
+/**
+ * Record a named point in time relative to script start
+ * @param {string} name - Mark name
+ * @returns {number} Milliseconds since script start
+ */
+function mark(name) {
+  var elapsed = Date.now() - startTime;
+  marks.push({ name: name, ms: elapsed });
+  return elapsed;
+}
+
+/**
+ * Log the marks recorded so far, once per label
+ * @param {string} label - Milestone being reported (e.g. 'ready', 'first body')
+ */
+function report(label) {
+  if (reported[label]) {
+    return;
+  }
+  reported[label] = true;
+  logger.log('Startup breakdown at ' + label + ': ' + marks.map(function(m) {
+    return m.name + '=' + m.ms + 'ms';
+  }).join(', '));
+}
+
+/**
+ * Wrap a module loader so the module is only evaluated on first use.
+ * The loader must call require() with a literal path so the bundler still sees it.
+ * @param {string} name - Module name used for timing marks
+ * @param {Function} loader - Returns the required module
+ * @returns {Function} Getter returning the loaded module
+ */
+function lazy(name, loader) {
+  var loaded = null;
+  return function() {
+    if (!loaded) {
+      var before = Date.now();
+      loaded = loader();
+      mark('load ' + name + ' (' + (Date.now() - before) + 'ms)');
+    }
+    return loaded;
+  };
+}
+
+module.exports = {
+  mark: mark,
+  report: report,
+  lazy: lazy
+};
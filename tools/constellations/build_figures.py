@@ -0,0 +1,160 @@
+#!/usr/bin/env python3
+"""Pack the constellation artwork into the CONSTELLATION_FIGURES raw resource read by
+src/c/utils/constellation_figure.c.
+
+Source: resources/constellations/svg/*_80px.svg, one per constellation. Each has a
+single stroked <path> for the figure lines (M, L, H, V and Z commands) and a 4x4
+<rect> per star. Path vertices within SNAP of a star centre are joined to that star;
+any other vertex becomes a point with no star marker.
+
+Layout (little-endian):
+  header, 8 bytes:
+    magic "HCFG", version (u8), figure count (u8), body id of the first figure (u8),
+    grid size (u8): coordinates run 0..grid across the square figure box
+  directory, 5 bytes per figure in body id order:
+    figure offset (u16), point count (u8), star count (u8), segment count (u8)
+  figures:
+    points, 2 bytes each, stars first: x (u8), y (u8)
+    segments, 2 bytes each: point index (u8), point index (u8)
+"""
+import os
+import re
+import struct
+import sys
+
+HERE = os.path.dirname(os.path.abspath(__file__))
+SOURCE_DIR = os.path.join(HERE, '..', '..', 'resources', 'constellations', 'svg')
+OUTPUT = os.path.join(HERE, '..', '..', 'resources', 'data', 'constellation_figures.bin')
+
+MAGIC = b'HCFG'
+VERSION = 1
+HEADER_FORMAT = '<4sBBBB'
+DIRECTORY_FORMAT = '<HBBB'
+FIRST_BODY_ID = 10  # CONSTELLATION_BODY_ID_START
+SOURCE_SIZE = 80
+GRID = 160  # Half-pixel steps of the 80px artwork
+STAR_SIZE = 4
+SNAP = 3
+# Sizes of the fixed arrays in ConstellationFigure (constellation_figure.h)
+MAX_POINTS = 32
+MAX_SEGMENTS = 40
+
+# Body id order, matching BODY_NAMES in body_info.c
+FIGURES = [
+    'Aries', 'Taurus', 'Gemini', 'Cancer', 'Leo', 'Virgo', 'Libra', 'Scorpius', 'Sagittarius',
+    'Capricorn', 'Aquarius', 'Pisces', 'Orion', 'Ursa Major', 'Ursa Minor', 'Cassiopeia',
+    'Cygnus', 'Crux', 'Lyra',
+]
+
+
+def parse_path(d):
+    """Line segments as ((x, y), (x, y)) pairs in SVG units."""
+    segments = []
+    tokens = re.findall(r'[MLHVZ]|-?\d+(?:\.\d+)?', d)
+    i = 0
+    command = None
+    current = start = None
+    while i < len(tokens):
+        if tokens[i].isalpha():
+            command = tokens[i]
+            i += 1
+            if command == 'Z':
+                if current != start:
+                    segments.append((current, start))
+                current = start
+                continue
+        if command == 'M':
+            current = start = (float(tokens[i]), float(tokens[i + 1]))
+            i += 2
+            command = 'L'  # Further pairs after M are implicit line-tos
+        elif command == 'L':
+            point = (float(tokens[i]), float(tokens[i + 1]))
+            segments.append((current, point))
+            current = point
+            i += 2
+        elif command in 'HV':
+            value = float(tokens[i])
+            point = (value, current[1]) if command == 'H' else (current[0], value)
+            segments.append((current, point))
+            current = point
+            i += 1
+        else:
+            sys.exit('Unsupported path data: %r' % d)
+    return segments
+
+
+def load_figure(name):
+    path = os.path.join(SOURCE_DIR, '%s_%dpx.svg' % (name, SOURCE_SIZE))
+    with open(path) as f:
+        svg = f.read()
+
+    stars = []
+    for attrs in re.findall(r'<rect ([^>]*)>', svg):
+        size = re.search(r'width="([\d.]+)"', attrs)
+        if not size or float(size.group(1)) != STAR_SIZE:
+            continue  # Background and clip rectangles
+        x = float(re.search(r'\bx="(-?[\d.]+)"', attrs).group(1))
+        y = float(re.search(r'\by="(-?[\d.]+)"', attrs).group(1))
+        stars.append((x + STAR_SIZE / 2, y + STAR_SIZE / 2))
+
+    points = list(stars)
+
+    def point_index(vertex):
+        best = min(range(len(stars)), key=lambda k: (stars[k][0] - vertex[0]) ** 2 +
+                   (stars[k][1] - vertex[1]) ** 2) if stars else None
+        if best is not None and ((stars[best][0] - vertex[0]) ** 2 +
+                                 (stars[best][1] - vertex[1]) ** 2) <= SNAP ** 2:
+            return best
+        if vertex not in points:
+            points.append(vertex)
+        return points.index(vertex)
+
+    segments = set()
+    for d in re.findall(r' d="([^"]*)"', svg):
+        for a, b in parse_path(d):
+            ia, ib = point_index(a), point_index(b)
+            if ia != ib:
+                segments.add((min(ia, ib), max(ia, ib)))
+
+    if len(points) > MAX_POINTS or len(segments) > MAX_SEGMENTS:
+        sys.exit('%s has %d points and %d segments; raise the limits in both places' %
+                 (name, len(points), len(segments)))
+
+    scale = GRID / SOURCE_SIZE
+    grid_points = [(max(0, min(GRID, round(x * scale))), max(0, min(GRID, round(y * scale))))
+                   for x, y in points]
+    return grid_points, len(stars), sorted(segments)
+
+
+def pack(figures):
+    header_size = struct.calcsize(HEADER_FORMAT)
+    directory_size = struct.calcsize(DIRECTORY_FORMAT) * len(figures)
+
+    directory = b''
+    body = b''
+    for points, star_count, segments in figures:
+        offset = header_size + directory_size + len(body)
+        directory += struct.pack(DIRECTORY_FORMAT, offset, len(points), star_count, len(segments))
+        body += b''.join(struct.pack('<BB', x, y) for x, y in points)
+        body += b''.join(struct.pack('<BB', a, b) for a, b in segments)
+
+    if header_size + directory_size + len(body) > 0xFFFF:
+        sys.exit('Figures too large for 16-bit offsets')
+    header = struct.pack(HEADER_FORMAT, MAGIC, VERSION, len(figures), FIRST_BODY_ID, GRID)
+    return header + directory + body
+
+
+def main():
+    figures = [load_figure(name) for name in FIGURES]
+    data = pack(figures)
+    os.makedirs(os.path.dirname(OUTPUT), exist_ok=True)
+    with open(OUTPUT, 'wb') as f:
+        f.write(data)
+    stars = sum(star_count for _, star_count, _ in figures)
+    segments = sum(len(s) for _, _, s in figures)
+    print('Wrote %d figures (%d stars, %d segments), %d bytes' %
+          (len(figures), stars, segments, len(data)))
+
+
+if __name__ == '__main__':
+    main()
@@ -0,0 +1,135 @@
+#!/usr/bin/env python3
+"""Pack catalog.csv into the STAR_CATALOG raw resource read by src/c/utils/star_catalog.c.
+
+Layout (little-endian):
+  header, 18 bytes:
+    magic "HSTC", version (u8), record size (u8), count (u16), star count (u16),
+    name index count (u16), name index offset (u16), names offset (u16), names size (u16)
+  records, 8 bytes each, stars first:
+    RA (u16, hundredths of a degree), Dec (s16, hundredths of a degree),
+    magnitude * 10 (s8), type (u8), name offset into the names block (u16)
+  name index, 4 bytes per entry, sorted case-insensitively by name:
+    body id (u16), name offset into the names block (u16)
+    It covers the built-in bodies from BODY_NAMES in body_info.c as well as the
+    records, so the watch can prefix-search every name with a binary search.
+  names: NUL-terminated ASCII
+"""
+import csv
+import os
+import re
+import struct
+import sys
+
+HERE = os.path.dirname(os.path.abspath(__file__))
+SOURCE = os.path.join(HERE, 'catalog.csv')
+BODY_INFO = os.path.join(HERE, '..', '..', 'src', 'c', 'utils', 'body_info.c')
+OUTPUT = os.path.join(HERE, '..', '..', 'resources', 'data', 'star_catalog.bin')
+
+MAGIC = b'HSTC'
+VERSION = 2
+HEADER_FORMAT = '<4sBBHHHHHH'
+RECORD_FORMAT = '<HhbBH'
+INDEX_FORMAT = '<HH'
+FIRST_BODY_ID = 29  # STAR_CATALOG_FIRST_BODY_ID in star_catalog.h
+MAX_NAME = 15  # DetailsContent.title_text is 16 bytes
+
+# Order matches StarCatalogType in star_catalog.h
+TYPES = ['star', 'double', 'open', 'globular', 'nebula', 'planetary', 'galaxy', 'remnant', 'other']
+
+
+def parse_ra(text):
+    hours, minutes = text.split()
+    return (int(hours) + float(minutes) / 60) * 15
+
+
+def parse_dec(text):
+    degrees, minutes = text.split()
+    sign = -1 if degrees.startswith('-') else 1
+    return sign * (abs(int(degrees)) + float(minutes) / 60)
+
+
+def load_builtin_names(path):
+    """BODY_NAMES from body_info.c; body id is the array position."""
+    with open(path) as f:
+        source = f.read()
+    match = re.search(r'BODY_NAMES\[\]\s*=\s*\{(.*?)\};', source, re.S)
+    if not match:
+        sys.exit('BODY_NAMES not found in %s' % path)
+    return re.findall(r'"([^"]*)"', match.group(1))
+
+
+def load(path):
+    with open(path, newline='') as f:
+        rows = [line for line in f if line.strip() and not line.startswith('#')]
+    entries = []
+    for row in csv.DictReader(rows):
+        name = row['name'].strip()
+        if len(name) > MAX_NAME or not name.isascii():
+            sys.exit('Name must be ASCII and at most %d characters: %r' % (MAX_NAME, name))
+        kind = row['type'].strip()
+        if kind not in TYPES:
+            sys.exit('Unknown type %r for %s' % (kind, name))
+        entries.append({
+            'name': name,
+            'type': TYPES.index(kind),
+            'ra': round(parse_ra(row['ra']) * 100) % 36000,
+            'dec': round(parse_dec(row['dec']) * 100),
+            'mag': max(-128, min(127, round(float(row['mag']) * 10))),
+        })
+
+    stars = [e for e in entries if e['type'] == 0]
+    if entries[:len(stars)] != stars:
+        sys.exit('Stars must come before deep-sky objects')
+    names = [e['name'].lower() for e in entries]
+    if len(set(names)) != len(names):
+        sys.exit('Duplicate names in catalog')
+    return entries, len(stars)
+
+
+def pack(entries, star_count, builtin_names):
+    header_size = struct.calcsize(HEADER_FORMAT)
+    record_size = struct.calcsize(RECORD_FORMAT)
+
+    names = b''
+    records = b''
+    searchable = []  # (name, body id, name offset)
+    for i, entry in enumerate(entries):
+        records += struct.pack(RECORD_FORMAT, entry['ra'], entry['dec'], entry['mag'],
+                               entry['type'], len(names))
+        searchable.append((entry['name'], FIRST_BODY_ID + i, len(names)))
+        names += entry['name'].encode('ascii') + b'\0'
+    for body_id, name in enumerate(builtin_names):
+        searchable.append((name, body_id, len(names)))
+        names += name.encode('ascii') + b'\0'
+
+    keys = [name.lower() for name, _, _ in searchable]
+    if len(set(keys)) != len(keys):
+        sys.exit('Catalog names clash with built-in body names')
+    searchable.sort(key=lambda item: item[0].lower())
+    index = b''.join(struct.pack(INDEX_FORMAT, body_id, offset)
+                     for _, body_id, offset in searchable)
+
+    index_offset = header_size + len(records)
+    names_offset = index_offset + len(index)
+    if names_offset + len(names) > 0xFFFF:
+        sys.exit('Catalog too large for 16-bit offsets')
+
+    header = struct.pack(HEADER_FORMAT, MAGIC, VERSION, record_size, len(entries), star_count,
+                         len(searchable), index_offset, names_offset, len(names))
+    return header + records + index + names
+
+
+def main():
+    entries, star_count = load(SOURCE)
+    builtin_names = load_builtin_names(BODY_INFO)
+    if len(builtin_names) != FIRST_BODY_ID:
+        sys.exit('Expected %d built-in bodies, found %d' % (FIRST_BODY_ID, len(builtin_names)))
+    data = pack(entries, star_count, builtin_names)
+    os.makedirs(os.path.dirname(OUTPUT), exist_ok=True)
+    with open(OUTPUT, 'wb') as f:
+        f.write(data)
+    print('Wrote %d objects (%d stars), %d bytes' % (len(entries), star_count, len(data)))
+
+
+if __name__ == '__main__':
+    main()
@@ -0,0 +1,89 @@
+#pragma once
+
+// Just enough of the Pebble SDK to build the sensor providers on a host.
+// Service functions are implemented by replay.c, which feeds them trace records.
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <string.h>
+#include <time.h>
+#include <math.h>
+
+#ifndef M_PI
+#define M_PI 3.14159265358979323846
+#endif
+
+#define TRIG_MAX_ANGLE 0x10000
+#define TRIG_MAX_RATIO 0xffff
+#define TRIGANGLE_TO_DEG(trig_angle) (((trig_angle) * 360) / TRIG_MAX_ANGLE)
+#define DEG_TO_TRIGANGLE(angle) (((angle) * TRIG_MAX_ANGLE) / 360)
+
+// The watch uses lookup tables; rounding the exact values is close enough for replay
+static inline int32_t sin_lookup(int32_t angle) {
+  return (int32_t)lround(sin(angle * 2 * M_PI / TRIG_MAX_ANGLE) * TRIG_MAX_RATIO);
+}
+
+static inline int32_t cos_lookup(int32_t angle) {
+  return (int32_t)lround(cos(angle * 2 * M_PI / TRIG_MAX_ANGLE) * TRIG_MAX_RATIO);
+}
+
+static inline int32_t atan2_lookup(int16_t y, int16_t x) {
+  double angle = atan2(y, x);
+  if (angle < 0) {
+    angle += 2 * M_PI;
+  }
+  return (int32_t)lround(angle / (2 * M_PI) * TRIG_MAX_ANGLE) & (TRIG_MAX_ANGLE - 1);
+}
+
+typedef enum {
+  APP_LOG_LEVEL_ERROR = 1,
+  APP_LOG_LEVEL_WARNING = 50,
+  APP_LOG_LEVEL_INFO = 100,
+  APP_LOG_LEVEL_DEBUG = 200,
+} AppLogLevel;
+
+#define APP_LOG(level, fmt, args...) fprintf(stderr, fmt "\n", ##args)
+
+typedef struct {
+  int16_t x;
+  int16_t y;
+  int16_t z;
+} AccelRawData;
+
+typedef enum {
+  ACCEL_SAMPLING_10HZ = 10,
+  ACCEL_SAMPLING_25HZ = 25,
+  ACCEL_SAMPLING_50HZ = 50,
+  ACCEL_SAMPLING_100HZ = 100,
+} AccelSamplingRate;
+
+typedef void (*AccelRawDataHandler)(AccelRawData *data, uint32_t num_samples, uint64_t timestamp);
+
+void accel_raw_data_service_subscribe(uint32_t samples_per_update, AccelRawDataHandler handler);
+void accel_data_service_unsubscribe(void);
+int accel_service_set_sampling_rate(AccelSamplingRate rate);
+int accel_service_set_samples_per_update(uint32_t num_samples);
+
+typedef int32_t CompassHeading;
+
+typedef enum {
+  CompassStatusUnavailable = -1,
+  CompassStatusDataInvalid = 0,
+  CompassStatusCalibrating,
+  CompassStatusCalibrated,
+} CompassStatus;
+
+typedef struct {
+  CompassHeading magnetic_heading;
+  CompassHeading true_heading;
+  CompassStatus compass_status;
+  bool is_declination_valid;
+} CompassHeadingData;
+
+typedef void (*CompassHeadingHandler)(CompassHeadingData heading);
+
+void compass_service_subscribe(CompassHeadingHandler handler);
+void compass_service_unsubscribe(void);
+int compass_service_set_heading_filter(CompassHeading filter);
@@ -0,0 +1,360 @@
+// Replays a DataLogging sensor trace (src/c/providers/sensor_trace.h) through the
+// watch's altitude and azimuth providers built for the host.
+//
+//   replay [-i INCLINATION_DEG] TRACE [REFERENCE]
+//
+// Without REFERENCE it prints one "time_ms altitude_deg heading_deg" line per provider
+// update. run.sh takes that series from an unfiltered build and passes it back as
+// REFERENCE to each filter variant. The variant then reports its smoothing error,
+// latency and CPU cost per sample.
+
+#define _POSIX_C_SOURCE 199309L
+
+#include <pebble.h>
+#include <stdlib.h>
+#include <time.h>
+
+#include "../../src/c/providers/altitude_provider.h"
+#include "../../src/c/providers/azimuth_provider.h"
+#include "../../src/c/providers/sensor_trace.h"
+#include "../../src/c/utils/settings.h"
+
+// The reference is made zero-phase by averaging the unfiltered series over +/- this window
+#define REFERENCE_HALF_WINDOW_MS 250
+// Latency is the time shift that best aligns a variant with the reference
+#define LAG_MAX_MS 2000
+#define LAG_STEP_MS 20
+
+#define MAX_BATCH 64
+
+typedef struct {
+  double time_ms;
+  double altitude_deg;
+  double heading_deg;  // NAN until the compass has a heading
+} Sample;
+
+typedef struct {
+  Sample *samples;
+  size_t count;
+  size_t capacity;
+} Series;
+
+static AccelRawDataHandler s_accel_handler;
+static CompassHeadingHandler s_compass_handler;
+static LocalSettings s_settings = { .magnetic_inclination = 255 };
+
+static double s_accel_ns;
+static uint32_t s_accel_samples;
+static double s_compass_ns;
+static uint32_t s_compass_samples;
+
+// SDK services the providers call
+
+void accel_raw_data_service_subscribe(uint32_t samples_per_update, AccelRawDataHandler handler) {
+  (void)samples_per_update;
+  s_accel_handler = handler;
+}
+
+void accel_data_service_unsubscribe(void) {
+  s_accel_handler = NULL;
+}
+
+int accel_service_set_sampling_rate(AccelSamplingRate rate) {
+  (void)rate;
+  return 0;
+}
+
+int accel_service_set_samples_per_update(uint32_t num_samples) {
+  // The trace keeps the batch sizes the watch actually delivered
+  (void)num_samples;
+  return 0;
+}
+
+void compass_service_subscribe(CompassHeadingHandler handler) {
+  s_compass_handler = handler;
+}
+
+void compass_service_unsubscribe(void) {
+  s_compass_handler = NULL;
+}
+
+int compass_service_set_heading_filter(CompassHeading filter) {
+  (void)filter;
+  return 0;
+}
+
+LocalSettings *settings_get(void) {
+  return &s_settings;
+}
+
+static double prv_now_ns(void) {
+  struct timespec now;
+  clock_gettime(CLOCK_MONOTONIC, &now);
+  return now.tv_sec * 1e9 + now.tv_nsec;
+}
+
+static void prv_series_add(Series *series, Sample sample) {
+  if (series->count == series->capacity) {
+    series->capacity = series->capacity ? series->capacity * 2 : 1024;
+    series->samples = realloc(series->samples, series->capacity * sizeof(Sample));
+    if (!series->samples) {
+      fprintf(stderr, "Out of memory\n");
+      exit(1);
+    }
+  }
+  series->samples[series->count++] = sample;
+}
+
+static double prv_wrap_deg(double delta) {
+  while (delta > 180) {
+    delta -= 360;
+  }
+  while (delta < -180) {
+    delta += 360;
+  }
+  return delta;
+}
+
+// What the providers currently report, at sub-degree precision where available
+static Sample prv_current_sample(uint32_t time_ms) {
+  Sample sample = { .time_ms = time_ms, .altitude_deg = NAN, .heading_deg = NAN };
+
+  int32_t x, y, z;
+  if (altitude_provider_get_gravity(&x, &y, &z)) {
+    // Same convention as prv_calc_altitude_deg: forward (-y) is 0°, up (+z) is 90°
+    double altitude = atan2(z, -y) * 180 / M_PI;
+    sample.altitude_deg = altitude > 90 ? 90 : (altitude < -90 ? -90 : altitude);
+  }
+  if (azimuth_provider_is_calibrated()) {
+    sample.heading_deg = azimuth_provider_get_azimuth_deg();
+  }
+  return sample;
+}
+
+static SensorTraceRecord *prv_load_trace(const char *path, size_t *count) {
+  FILE *file = fopen(path, "rb");
+  if (!file) {
+    perror(path);
+    exit(1);
+  }
+  fseek(file, 0, SEEK_END);
+  const long size = ftell(file);
+  fseek(file, 0, SEEK_SET);
+
+  *count = (size_t)size / sizeof(SensorTraceRecord);
+  SensorTraceRecord *records = malloc(*count * sizeof(SensorTraceRecord) + 1);
+  if (!records || fread(records, sizeof(SensorTraceRecord), *count, file) != *count) {
+    fprintf(stderr, "Could not read %s\n", path);
+    exit(1);
+  }
+  fclose(file);
+  return records;
+}
+
+static Series prv_replay(const SensorTraceRecord *records, size_t count) {
+  Series series = { 0 };
+  altitude_provider_init();
+  azimuth_provider_init();
+
+  size_t i = 0;
+  while (i < count) {
+    const SensorTraceRecord *record = &records[i];
+
+    if (record->type == SensorTraceRecordAccel) {
+      // Re-deliver the batch exactly as the accel service did on the watch
+      AccelRawData batch[MAX_BATCH];
+      uint32_t batch_count = 0;
+      const uint64_t timestamp = record->time_ms;
+      do {
+        batch[batch_count++] = (AccelRawData){
+          .x = records[i].values[0], .y = records[i].values[1], .z = records[i].values[2],
+        };
+        i++;
+      } while (i < count && batch_count < MAX_BATCH && records[i].type == SensorTraceRecordAccel &&
+               !(records[i].flags & SENSOR_TRACE_FLAG_BATCH_START));
+
+      const double start_ns = prv_now_ns();
+      if (s_accel_handler) {
+        s_accel_handler(batch, batch_count, timestamp);
+      }
+      s_accel_ns += prv_now_ns() - start_ns;
+      s_accel_samples += batch_count;
+
+      prv_series_add(&series, prv_current_sample(records[i - 1].time_ms));
+    } else if (record->type == SensorTraceRecordCompass) {
+      const CompassHeadingData heading = {
+        .magnetic_heading = (uint16_t)record->values[0],
+        .true_heading = (uint16_t)record->values[1],
+        .compass_status = (CompassStatus)(int8_t)record->flags,
+        .is_declination_valid = record->values[2] != 0,
+      };
+
+      const double start_ns = prv_now_ns();
+      if (s_compass_handler) {
+        s_compass_handler(heading);
+      }
+      s_compass_ns += prv_now_ns() - start_ns;
+      s_compass_samples++;
+
+      prv_series_add(&series, prv_current_sample(record->time_ms));
+      i++;
+    } else {
+      i++;
+    }
+  }
+
+  azimuth_provider_deinit();
+  altitude_provider_deinit();
+  return series;
+}
+
+static Series prv_load_reference(const char *path) {
+  FILE *file = fopen(path, "r");
+  if (!file) {
+    perror(path);
+    exit(1);
+  }
+
+  Series raw = { 0 };
+  Sample sample;
+  while (fscanf(file, "%lf %lf %lf", &sample.time_ms, &sample.altitude_deg, &sample.heading_deg) == 3) {
+    prv_series_add(&raw, sample);
+  }
+  fclose(file);
+
+  // Centered moving average: smooth without adding delay
+  Series reference = { 0 };
+  size_t first = 0;
+  for (size_t i = 0; i < raw.count; i++) {
+    while (raw.samples[first].time_ms < raw.samples[i].time_ms - REFERENCE_HALF_WINDOW_MS) {
+      first++;
+    }
+    double altitude_sum = 0, cos_sum = 0, sin_sum = 0;
+    uint32_t altitude_count = 0, heading_count = 0;
+    for (size_t j = first; j < raw.count && raw.samples[j].time_ms <= raw.samples[i].time_ms + REFERENCE_HALF_WINDOW_MS; j++) {
+      if (!isnan(raw.samples[j].altitude_deg)) {
+        altitude_sum += raw.samples[j].altitude_deg;
+        altitude_count++;
+      }
+      if (!isnan(raw.samples[j].heading_deg)) {
+        cos_sum += cos(raw.samples[j].heading_deg * M_PI / 180);
+        sin_sum += sin(raw.samples[j].heading_deg * M_PI / 180);
+        heading_count++;
+      }
+    }
+    prv_series_add(&reference, (Sample){
+      .time_ms = raw.samples[i].time_ms,
+      .altitude_deg = altitude_count ? altitude_sum / altitude_count : NAN,
+      .heading_deg = heading_count ? atan2(sin_sum, cos_sum) * 180 / M_PI : NAN,
+    });
+  }
+
+  free(raw.samples);
+  return reference;
+}
+
+// Reference value at time_ms, linearly interpolated (headings the short way round)
+static bool prv_reference_at(const Series *reference, double time_ms, bool heading, double *value) {
+  size_t low = 0, high = reference->count;
+  while (low < high) {
+    const size_t mid = (low + high) / 2;
+    if (reference->samples[mid].time_ms < time_ms) {
+      low = mid + 1;
+    } else {
+      high = mid;
+    }
+  }
+  if (low == 0 || low >= reference->count) {
+    return false;
+  }
+
+  const Sample *before = &reference->samples[low - 1];
+  const Sample *after = &reference->samples[low];
+  const double a = heading ? before->heading_deg : before->altitude_deg;
+  const double b = heading ? after->heading_deg : after->altitude_deg;
+  if (isnan(a) || isnan(b)) {
+    return false;
+  }
+  const double span = after->time_ms - before->time_ms;
+  const double t = span > 0 ? (time_ms - before->time_ms) / span : 0;
+  *value = heading ? a + prv_wrap_deg(b - a) * t : a + (b - a) * t;
+  return true;
+}
+
+static double prv_rms_error(const Series *series, const Series *reference, bool heading, int lag_ms) {
+  double sum = 0;
+  uint32_t count = 0;
+  for (size_t i = 0; i < series->count; i++) {
+    const Sample *sample = &series->samples[i];
+    const double value = heading ? sample->heading_deg : sample->altitude_deg;
+    double expected;
+    if (isnan(value) || !prv_reference_at(reference, sample->time_ms - lag_ms, heading, &expected)) {
+      continue;
+    }
+    const double error = heading ? prv_wrap_deg(value - expected) : value - expected;
+    sum += error * error;
+    count++;
+  }
+  return count ? sqrt(sum / count) : NAN;
+}
+
+static void prv_report_stream(const char *name, const Series *series, const Series *reference, bool heading) {
+  const double rms = prv_rms_error(series, reference, heading, 0);
+  int best_lag_ms = 0;
+  double best_rms = rms;
+  for (int lag_ms = LAG_STEP_MS; lag_ms <= LAG_MAX_MS; lag_ms += LAG_STEP_MS) {
+    const double lagged_rms = prv_rms_error(series, reference, heading, lag_ms);
+    if (lagged_rms < best_rms) {
+      best_rms = lagged_rms;
+      best_lag_ms = lag_ms;
+    }
+  }
+
+  if (isnan(rms)) {
+    printf("  %-8s no data\n", name);
+  } else {
+    printf("  %-8s rms error %6.2f deg, latency %4d ms (%.2f deg once aligned)\n",
+           name, rms, best_lag_ms, best_rms);
+  }
+}
+
+int main(int argc, char **argv) {
+  int arg = 1;
+  if (arg + 1 < argc && strcmp(argv[arg], "-i") == 0) {
+    s_settings.magnetic_inclination = (int16_t)atoi(argv[arg + 1]);
+    arg += 2;
+  }
+  if (arg >= argc) {
+    fprintf(stderr, "usage: %s [-i INCLINATION_DEG] TRACE [REFERENCE]\n", argv[0]);
+    return 2;
+  }
+
+  size_t record_count;
+  SensorTraceRecord *records = prv_load_trace(argv[arg], &record_count);
+  Series series = prv_replay(records, record_count);
+
+  if (arg + 1 >= argc) {
+    for (size_t i = 0; i < series.count; i++) {
+      printf("%.0f %.3f %.3f\n", series.samples[i].time_ms, series.samples[i].altitude_deg,
+             series.samples[i].heading_deg);
+    }
+    return 0;
+  }
+
+  Series reference = prv_load_reference(argv[arg + 1]);
+#if defined(ALTITUDE_FILTER_SHIFT) && defined(ORIENTATION_SMOOTH_SHIFT)
+  printf("altitude shift %d, heading shift %d\n", ALTITUDE_FILTER_SHIFT, ORIENTATION_SMOOTH_SHIFT);
+#else
+  printf("default filters\n");
+#endif
+  prv_report_stream("altitude", &series, &reference, false);
+  prv_report_stream("heading", &series, &reference, true);
+  printf("  cpu      %.0f ns per accel sample, %.0f ns per compass sample (host)\n",
+         s_accel_samples ? s_accel_ns / s_accel_samples : 0,
+         s_compass_samples ? s_compass_ns / s_compass_samples : 0);
+
+  free(reference.samples);
+  free(series.samples);
+  free(records);
+  return 0;
+}
@@ -0,0 +1,42 @@
+#!/bin/sh
+# Compare sensor filter variants on a recorded trace.
+#
+#   tools/trace_replay/run.sh TRACE [INCLINATION_DEG]
+#
+# Builds the replay harness once per variant, "ALTITUDE_FILTER_SHIFT:ORIENTATION_SMOOTH_SHIFT",
+# and scores each against an unfiltered (0:0) replay of the same trace. Override the list
+# with VARIANTS="1:1 2:2 ..."; 2:2 is what the watch ships with.
+set -e
+
+if [ $# -lt 1 ]; then
+  echo "usage: $0 TRACE [INCLINATION_DEG]" >&2
+  exit 2
+fi
+
+here=$(cd "$(dirname "$0")" && pwd)
+providers="$here/../../src/c/providers"
+out="${TMPDIR:-/tmp}/hubble_trace_replay"
+trace="$1"
+inclination=""
+if [ -n "$2" ]; then
+  inclination="-i $2"
+fi
+mkdir -p "$out"
+
+build() {
+  ${CC:-cc} -std=c11 -O2 -Wall -Wno-unused-variable -I"$here" \
+    -DALTITUDE_FILTER_SHIFT="$1" -DORIENTATION_SMOOTH_SHIFT="$2" \
+    -o "$out/replay_$1_$2" "$here/replay.c" \
+    "$providers/altitude_provider.c" "$providers/azimuth_provider.c" "$providers/orientation.c" -lm
+}
+
+build 0 0
+"$out/replay_0_0" $inclination "$trace" > "$out/reference.txt"
+
+variants=${VARIANTS:-"1:1 2:2 3:2 2:3 3:3"}
+for variant in $variants; do
+  altitude_shift=${variant%:*}
+  heading_shift=${variant#*:}
+  build "$altitude_shift" "$heading_shift"
+  "$out/replay_${altitude_shift}_${heading_shift}" $inclination "$trace" "$out/reference.txt"
+done
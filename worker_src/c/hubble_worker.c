@@ -0,0 +1,139 @@
+#include <pebble_worker.h>
+#include "../../src/c/utils/worker_protocol.h"
+
+// Wake the compass briefly every few minutes so its calibration doesn't lapse
+#define WORKER_SAMPLE_PERIOD_MS (5 * 60 * 1000)
+// Longest a single wake-up keeps the compass on if it never reports calibrated
+#define WORKER_SAMPLE_WINDOW_MS (15 * 1000)
+// Skip wake-ups at or below this charge unless charging
+#define WORKER_MIN_BATTERY_PERCENT 20
+
+#if defined(PBL_COMPASS)
+static AppTimer *s_timer = NULL;
+static bool s_sampling = false;
+static bool s_paused = false;
+
+static CompassStatus s_status = CompassStatusDataInvalid;
+static CompassHeading s_heading = 0;
+static time_t s_heading_time = 0;
+static bool s_has_heading = false;
+
+static void prv_schedule(uint32_t delay_ms);
+
+static void prv_send_heading(void) {
+  const time_t age_s = s_has_heading ? time(NULL) - s_heading_time : 0;
+  AppWorkerMessage message = {
+    .data0 = s_has_heading ? (uint16_t)(s_status + 1) : 0,
+    .data1 = (uint16_t)s_heading,
+    .data2 = age_s > UINT16_MAX ? UINT16_MAX : (uint16_t)age_s,
+  };
+  // Only delivered while the app is in the foreground; otherwise dropped
+  app_worker_send_message(WORKER_MSG_HEADING, &message);
+}
+
+static void prv_stop_sampling(void) {
+  if (!s_sampling) {
+    return;
+  }
+  compass_service_unsubscribe();
+  s_sampling = false;
+}
+
+static void prv_heading_handler(CompassHeadingData data) {
+  if (data.compass_status == CompassStatusDataInvalid ||
+      data.compass_status == CompassStatusUnavailable) {
+    // Keep sampling until the window ends; moving the wrist may finish calibration
+    s_status = data.compass_status;
+    return;
+  }
+
+  s_status = data.compass_status;
+  s_heading = data.magnetic_heading;
+  s_heading_time = time(NULL);
+  s_has_heading = true;
+  prv_send_heading();
+
+  if (data.compass_status == CompassStatusCalibrated) {
+    prv_stop_sampling();
+    prv_schedule(WORKER_SAMPLE_PERIOD_MS);
+  }
+}
+
+static bool prv_battery_allows_sampling(void) {
+  const BatteryChargeState battery = battery_state_service_peek();
+  return battery.is_charging || battery.charge_percent > WORKER_MIN_BATTERY_PERCENT;
+}
+
+static void prv_timer_callback(void *context) {
+  (void)context;
+  s_timer = NULL;
+
+  if (s_sampling) {
+    // Window over without a calibrated reading
+    prv_stop_sampling();
+  } else if (!s_paused && prv_battery_allows_sampling()) {
+    compass_service_subscribe(prv_heading_handler);
+    s_sampling = true;
+    prv_schedule(WORKER_SAMPLE_WINDOW_MS);
+    return;
+  }
+
+  prv_schedule(WORKER_SAMPLE_PERIOD_MS);
+}
+
+static void prv_schedule(uint32_t delay_ms) {
+  if (s_timer) {
+    app_timer_cancel(s_timer);
+  }
+  s_timer = app_timer_register(delay_ms, prv_timer_callback, NULL);
+}
+
+static void prv_set_paused(bool paused) {
+  s_paused = paused;
+  if (paused) {
+    // The app owns the compass now
+    prv_stop_sampling();
+    if (s_timer) {
+      app_timer_cancel(s_timer);
+      s_timer = NULL;
+    }
+  } else {
+    // The app just used the compass, so calibration is fresh
+    prv_schedule(WORKER_SAMPLE_PERIOD_MS);
+  }
+}
+
+static void prv_message_handler(uint16_t type, AppWorkerMessage *data) {
+  switch (type) {
+    case WORKER_MSG_REQUEST_HEADING:
+      prv_send_heading();
+      break;
+    case WORKER_MSG_SET_PAUSED:
+      prv_set_paused(data->data0 != 0);
+      break;
+    default:
+      break;
+  }
+}
+#endif
+
+static void prv_init(void) {
+#if defined(PBL_COMPASS)
+  app_worker_message_subscribe(prv_message_handler);
+  // First sample right away so the app has a heading soon after enabling the worker
+  prv_schedule(0);
+#endif
+}
+
+static void prv_deinit(void) {
+#if defined(PBL_COMPASS)
+  prv_stop_sampling();
+  app_worker_message_unsubscribe();
+#endif
+}
+
+int main(void) {
+  prv_init();
+  worker_event_loop();
+  prv_deinit();
+}